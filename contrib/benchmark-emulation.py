@@ -0,0 +1,233 @@
+#!/usr/bin/python3
+#
+# Copyright 2024 Richard Hughes <richard@hughsie.com>
+#
+# SPDX-License-Identifier: LGPL-2.1-or-later
+#
+# pylint: disable=invalid-name,missing-docstring
+
+from typing import Any, Dict, List, Optional
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import urllib.request
+
+# docks, hubs and simple devices that all have recorded emulation data
+DEFAULT_DEVICE_TESTS: List[str] = [
+    "hp-dock-g5.json",
+    "wistron-dock-40b7.json",
+    "caldigit-ts4.json",
+    "lenovo-GX90T33021-vli.json",
+    "realtek-rts5855.json",
+    "algoltek-ag9421.json",
+    "hughski-colorhug2.json",
+]
+
+
+class DaemonStats:
+    def __init__(self, pid: int) -> None:
+        self.pid = pid
+        self.cpu_ms: float = 0
+        self.rss_kb: int = 0
+        self.hwm_kb: int = 0
+        self.refresh()
+
+    def refresh(self) -> None:
+        with open(f"/proc/{self.pid}/stat", "r", encoding="utf-8") as f:
+            # the process name can contain spaces, so split after the last bracket
+            fields = f.read().rsplit(")", 1)[1].split()
+        ticks = int(fields[11]) + int(fields[12])
+        self.cpu_ms = ticks * 1000 / os.sysconf("SC_CLK_TCK")
+        with open(f"/proc/{self.pid}/status", "r", encoding="utf-8") as f:
+            for line in f.read().split("\n"):
+                if line.startswith("VmRSS:"):
+                    self.rss_kb = int(line.split()[1])
+                elif line.startswith("VmHWM:"):
+                    self.hwm_kb = int(line.split()[1])
+
+
+def _get_daemon_pid() -> Optional[int]:
+    try:
+        p = subprocess.run(
+            ["systemctl", "show", "--property=MainPID", "--value", "fwupd"],
+            check=True,
+            capture_output=True,
+        )
+        pid = int(p.stdout.decode().strip())
+        if pid > 0:
+            return pid
+    except (subprocess.CalledProcessError, FileNotFoundError, ValueError):
+        pass
+    try:
+        p = subprocess.run(["pidof", "fwupd"], check=True, capture_output=True)
+        return int(p.stdout.decode().split()[0])
+    except (subprocess.CalledProcessError, FileNotFoundError, ValueError, IndexError):
+        return None
+
+
+def _get_local_filename(args: argparse.Namespace, url: str) -> str:
+    """download the URL into the cache directory once, so that later runs are offline"""
+    fn_local = os.path.join(args.cache_dir, os.path.basename(url))
+    if os.path.exists(fn_local):
+        return fn_local
+    if args.offline:
+        raise FileNotFoundError(f"{fn_local} not found and --offline specified")
+    print(f"Downloading {url}…", file=sys.stderr)
+    os.makedirs(args.cache_dir, exist_ok=True)
+    with urllib.request.urlopen(url) as response:
+        with open(fn_local + ".tmp", "wb") as f:
+            shutil.copyfileobj(response, f)
+    os.rename(fn_local + ".tmp", fn_local)
+    return fn_local
+
+
+def _localize_device_test(args: argparse.Namespace, fn: str, tmpdir: str) -> str:
+    """rewrite the device test so that every URL points into the cache directory"""
+    with open(fn, "r", encoding="utf-8") as f:
+        test = json.load(f)
+    for step in test.get("steps", []):
+        for key in ["url", "emulation-url"]:
+            if key in step:
+                step[key] = _get_local_filename(args, step[key])
+    fn_local = os.path.join(tmpdir, os.path.basename(fn))
+    with open(fn_local, "w", encoding="utf-8") as f:
+        json.dump(test, f)
+    return fn_local
+
+
+def _write_directory_remote(args: argparse.Namespace) -> None:
+    """expose the cache directory as a local directory remote for the get-updates phase"""
+    fn = os.path.join(args.remotes_dir, "benchmark.conf")
+    with open(fn, "w", encoding="utf-8") as f:
+        f.write("[fwupd Remote]\n")
+        f.write("Enabled=true\n")
+        f.write("Title=Benchmark\n")
+        f.write("Keyring=none\n")
+        f.write(f"MetadataURI=file://{os.path.abspath(args.cache_dir)}\n")
+        f.write("ApprovalRequired=false\n")
+    print(f"Wrote {fn}, restart the daemon to use it", file=sys.stderr)
+
+
+def _run_device_test(args: argparse.Namespace, fn: str) -> Dict[str, Any]:
+    result: Dict[str, Any] = {"filename": os.path.basename(fn)}
+
+    # the daemon has to be running so we can compare before and after
+    subprocess.run(
+        [args.fwupdmgr, "get-devices", "--json"], check=False, capture_output=True
+    )
+    pid = _get_daemon_pid()
+    stats: Optional[DaemonStats] = DaemonStats(pid) if pid else None
+
+    argv = [
+        args.fwupdmgr,
+        "device-emulate",
+        "--json",
+        "--timing",
+        "--no-unreported-check",
+        "--no-remote-check",
+        "--no-metadata-check",
+        fn,
+    ]
+    p = subprocess.run(argv, check=False, capture_output=True)
+    try:
+        nodes = json.loads(p.stdout.decode())
+    except json.decoder.JSONDecodeError:
+        result["error"] = p.stderr.decode().strip()
+        return result
+
+    # add up the per-phase timings from all the steps
+    phases: Dict[str, float] = {}
+    for test in nodes.get("results", []):
+        for step in test.get("steps", []):
+            for key, value in step.items():
+                if key.endswith("-ms") or key.endswith("-dbus-messages"):
+                    phases[key] = phases.get(key, 0) + value
+            if "error" in step:
+                result["error"] = step["error"]
+    result["phases"] = phases
+
+    # the daemon may have been restarted by the test
+    if stats and _get_daemon_pid() == stats.pid:
+        cpu_ms = stats.cpu_ms
+        stats.refresh()
+        result["daemon-cpu-ms"] = stats.cpu_ms - cpu_ms
+        result["daemon-rss-kb"] = stats.rss_kb
+        result["daemon-peak-rss-kb"] = stats.hwm_kb
+    return result
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(
+        description="Benchmark the daemon by replaying emulated device tests"
+    )
+    parser.add_argument("filenames", nargs="*", help="device test JSON files")
+    parser.add_argument(
+        "--device-tests",
+        default=os.path.join(os.path.dirname(__file__), "..", "data", "device-tests"),
+        help="directory of device test JSON files",
+    )
+    parser.add_argument("--fwupdmgr", default="fwupdmgr", help="fwupdmgr binary")
+    parser.add_argument("--output", help="save the results as JSON")
+    parser.add_argument(
+        "--cache-dir",
+        default=os.path.join(
+            os.environ.get("XDG_CACHE_HOME", os.path.expanduser("~/.cache")),
+            "fwupd-benchmark",
+        ),
+        help="local directory of firmware and emulation data",
+    )
+    parser.add_argument(
+        "--offline",
+        action="store_true",
+        help="fail rather than download anything missing from the cache directory",
+    )
+    parser.add_argument(
+        "--remotes-dir",
+        help="write a local directory remote for the cache directory, e.g. /etc/fwupd/remotes.d",
+    )
+    args = parser.parse_args()
+
+    filenames: List[str] = args.filenames
+    if not filenames:
+        filenames = [os.path.join(args.device_tests, fn) for fn in DEFAULT_DEVICE_TESTS]
+
+    # fetch everything up front so the timed runs never touch the network
+    tmpdir = tempfile.mkdtemp(prefix="fwupd-benchmark-")
+    try:
+        filenames = [_localize_device_test(args, fn, tmpdir) for fn in filenames]
+    except (OSError, ValueError) as e:
+        print(f"failed to prepare device tests: {e}", file=sys.stderr)
+        shutil.rmtree(tmpdir)
+        return 1
+    if args.remotes_dir:
+        _write_directory_remote(args)
+
+    results: List[Dict[str, Any]] = []
+    for fn in filenames:
+        print(f"Emulating {fn}…", file=sys.stderr)
+        result = _run_device_test(args, fn)
+        results.append(result)
+        if "error" in result:
+            print(f"  error: {result['error']}", file=sys.stderr)
+        for key, value in result.get("phases", {}).items():
+            print(f"  {key}: {value:.0f}", file=sys.stderr)
+        if "daemon-cpu-ms" in result:
+            print(f"  daemon-cpu-ms: {result['daemon-cpu-ms']:.0f}", file=sys.stderr)
+            print(
+                f"  daemon-peak-rss-kb: {result['daemon-peak-rss-kb']}", file=sys.stderr
+            )
+
+    shutil.rmtree(tmpdir)
+
+    if args.output:
+        with open(args.output, "w", encoding="utf-8") as f:
+            json.dump({"results": results}, f, indent=2)
+    return 1 if any("error" in result for result in results) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
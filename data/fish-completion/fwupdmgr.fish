@@ -31,6 +31,7 @@ complete -c fwupdmgr -l show-all -d 'Show all results'
 complete -c fwupdmgr -l disable-ssl-strict -d 'Ignore SSL strict checks when downloading'
 complete -c fwupdmgr -l p2p -d 'Only use peer-to-peer networking when downloading files'
 complete -c fwupdmgr -l filter -d 'Filter with a set of device flags'
+complete -c fwupdmgr -l timing -d 'Record how long each part of the device tests takes'
 
 # complete subcommands
 complete -c fwupdmgr -n '__fish_use_subcommand' -x -a activate -d 'Activate devices'
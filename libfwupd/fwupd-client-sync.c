@@ -443,6 +443,54 @@ fwupd_client_get_upgrades(FwupdClient *self,
 	return g_steal_pointer(&helper->array);
 }
 
+static void
+fwupd_client_get_all_upgrades_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	FwupdClientHelper *helper = (FwupdClientHelper *)user_data;
+	helper->array =
+	    fwupd_client_get_all_upgrades_finish(FWUPD_CLIENT(source), res, &helper->error);
+	g_main_loop_quit(helper->loop);
+}
+
+/**
+ * fwupd_client_get_all_upgrades:
+ * @self: a #FwupdClient
+ * @cancellable: (nullable): optional #GCancellable
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets all the upgrades for all the devices in one call.
+ *
+ * Returns: (element-type FwupdDevice) (transfer container): devices, each with releases
+ *
+ * Since: 2.0.0
+ **/
+GPtrArray *
+fwupd_client_get_all_upgrades(FwupdClient *self, GCancellable *cancellable, GError **error)
+{
+	g_autoptr(FwupdClientHelper) helper = NULL;
+
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), NULL);
+	g_return_val_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	/* connect */
+	if (!fwupd_client_connect(self, cancellable, error))
+		return NULL;
+
+	/* call async version and run loop until complete */
+	helper = fwupd_client_helper_new(self);
+	fwupd_client_get_all_upgrades_async(self,
+					    cancellable,
+					    fwupd_client_get_all_upgrades_cb,
+					    helper);
+	g_main_loop_run(helper->loop);
+	if (helper->array == NULL) {
+		g_propagate_error(error, g_steal_pointer(&helper->error));
+		return NULL;
+	}
+	return g_steal_pointer(&helper->array);
+}
+
 static void
 fwupd_client_get_details_bytes_cb(GObject *source, GAsyncResult *res, gpointer user_data)
 {
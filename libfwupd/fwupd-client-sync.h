@@ -46,6 +46,10 @@ fwupd_client_get_upgrades(FwupdClient *self,
 			  GCancellable *cancellable,
 			  GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1, 2);
 GPtrArray *
+fwupd_client_get_all_upgrades(FwupdClient *self,
+			      GCancellable *cancellable,
+			      GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1);
+GPtrArray *
 fwupd_client_get_details(FwupdClient *self,
 			 const gchar *filename,
 			 GCancellable *cancellable,
@@ -149,6 +149,15 @@ fwupd_client_get_upgrades_finish(FwupdClient *self,
 				 GAsyncResult *res,
 				 GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1, 2);
 void
+fwupd_client_get_all_upgrades_async(FwupdClient *self,
+				    GCancellable *cancellable,
+				    GAsyncReadyCallback callback,
+				    gpointer callback_data) G_GNUC_NON_NULL(1);
+GPtrArray *
+fwupd_client_get_all_upgrades_finish(FwupdClient *self,
+				     GAsyncResult *res,
+				     GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1, 2);
+void
 fwupd_client_get_details_bytes_async(FwupdClient *self,
 				     GBytes *bytes,
 				     GCancellable *cancellable,
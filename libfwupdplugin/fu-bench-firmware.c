@@ -0,0 +1,400 @@
+/*
+ * Copyright 2024 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "config.h"
+
+#include <fwupdplugin.h>
+
+#include <locale.h>
+#include <string.h>
+
+#include "fu-coswid-firmware.h"
+
+#define FU_BENCH_FIRMWARE_SCALE_MAX 4096
+
+typedef struct {
+	guint iterations;
+	gsize size_target;
+	JsonBuilder *builder;
+} FuBenchFirmwareHelper;
+
+static void
+fu_bench_firmware_ensure_gtypes(void)
+{
+	g_type_ensure(FU_TYPE_ARCHIVE_FIRMWARE);
+	g_type_ensure(FU_TYPE_CAB_FIRMWARE);
+	g_type_ensure(FU_TYPE_CAB_IMAGE);
+	g_type_ensure(FU_TYPE_CFU_OFFER);
+	g_type_ensure(FU_TYPE_CFU_PAYLOAD);
+	g_type_ensure(FU_TYPE_COSWID_FIRMWARE);
+	g_type_ensure(FU_TYPE_CSV_ENTRY);
+	g_type_ensure(FU_TYPE_CSV_FIRMWARE);
+	g_type_ensure(FU_TYPE_DFU_FIRMWARE);
+	g_type_ensure(FU_TYPE_DFUSE_FIRMWARE);
+	g_type_ensure(FU_TYPE_EDID);
+	g_type_ensure(FU_TYPE_EFI_DEVICE_PATH_LIST);
+	g_type_ensure(FU_TYPE_EFI_FILE);
+	g_type_ensure(FU_TYPE_EFI_FILE_PATH_DEVICE_PATH);
+	g_type_ensure(FU_TYPE_EFI_FILESYSTEM);
+	g_type_ensure(FU_TYPE_EFI_HARD_DRIVE_DEVICE_PATH);
+	g_type_ensure(FU_TYPE_EFI_LOAD_OPTION);
+	g_type_ensure(FU_TYPE_EFI_SECTION);
+	g_type_ensure(FU_TYPE_EFI_SIGNATURE);
+	g_type_ensure(FU_TYPE_EFI_SIGNATURE_LIST);
+	g_type_ensure(FU_TYPE_EFI_VOLUME);
+	g_type_ensure(FU_TYPE_FDT_FIRMWARE);
+	g_type_ensure(FU_TYPE_FDT_IMAGE);
+	g_type_ensure(FU_TYPE_FIT_FIRMWARE);
+	g_type_ensure(FU_TYPE_FMAP_FIRMWARE);
+	g_type_ensure(FU_TYPE_HID_DESCRIPTOR);
+	g_type_ensure(FU_TYPE_HID_REPORT);
+	g_type_ensure(FU_TYPE_HID_REPORT_ITEM);
+	g_type_ensure(FU_TYPE_IFD_BIOS);
+	g_type_ensure(FU_TYPE_IFD_FIRMWARE);
+	g_type_ensure(FU_TYPE_IFD_IMAGE);
+	g_type_ensure(FU_TYPE_IFWI_CPD_FIRMWARE);
+	g_type_ensure(FU_TYPE_IFWI_FPT_FIRMWARE);
+	g_type_ensure(FU_TYPE_IHEX_FIRMWARE);
+	g_type_ensure(FU_TYPE_INTEL_THUNDERBOLT_NVM);
+	g_type_ensure(FU_TYPE_LINEAR_FIRMWARE);
+	g_type_ensure(FU_TYPE_OPROM_FIRMWARE);
+	g_type_ensure(FU_TYPE_PEFILE_FIRMWARE);
+	g_type_ensure(FU_TYPE_SBATLEVEL_SECTION);
+	g_type_ensure(FU_TYPE_SREC_FIRMWARE);
+	g_type_ensure(FU_TYPE_USWID_FIRMWARE);
+}
+
+/* the peak RSS is the closest thing we have to a per-parser allocation count */
+static void
+fu_bench_firmware_reset_peak_rss(void)
+{
+#ifdef __linux__
+	g_autoptr(GError) error_local = NULL;
+	if (!g_file_set_contents_full("/proc/self/clear_refs",
+				      "5",
+				      1,
+				      G_FILE_SET_CONTENTS_NONE,
+				      0644,
+				      &error_local))
+		g_debug("failed to reset peak RSS: %s", error_local->message);
+#endif
+}
+
+static guint64
+fu_bench_firmware_get_peak_rss(void)
+{
+	guint64 value = 0;
+#ifdef __linux__
+	g_autofree gchar *buf = NULL;
+	g_auto(GStrv) lines = NULL;
+
+	if (!g_file_get_contents("/proc/self/status", &buf, NULL, NULL))
+		return 0;
+	lines = g_strsplit(buf, "\n", -1);
+	for (guint i = 0; lines[i] != NULL; i++) {
+		g_autofree gchar *tmp = NULL;
+		if (!g_str_has_prefix(lines[i], "VmHWM:"))
+			continue;
+		tmp = g_strdup(lines[i] + strlen("VmHWM:"));
+		g_strstrip(tmp);
+		if (g_str_has_suffix(tmp, " kB"))
+			tmp[strlen(tmp) - 3] = '\0';
+		if (!fu_strtoull(tmp, &value, 0, G_MAXUINT64, NULL))
+			return 0;
+		break;
+	}
+#endif
+	return value;
+}
+
+static GType
+fu_bench_firmware_get_gtype(const gchar *xml, GError **error)
+{
+	const gchar *gtypestr;
+	GType gtype;
+	g_autoptr(XbBuilder) builder = xb_builder_new();
+	g_autoptr(XbBuilderSource) source = xb_builder_source_new();
+	g_autoptr(XbNode) n = NULL;
+	g_autoptr(XbSilo) silo = NULL;
+
+	if (!xb_builder_source_load_xml(source, xml, XB_BUILDER_SOURCE_FLAG_NONE, error))
+		return G_TYPE_INVALID;
+	xb_builder_import_source(builder, source);
+	silo = xb_builder_compile(builder, XB_BUILDER_COMPILE_FLAG_NONE, NULL, error);
+	if (silo == NULL)
+		return G_TYPE_INVALID;
+	n = xb_silo_query_first(silo, "firmware", error);
+	if (n == NULL)
+		return G_TYPE_INVALID;
+	gtypestr = xb_node_get_attr(n, "gtype");
+	if (gtypestr == NULL)
+		return FU_TYPE_FIRMWARE;
+	gtype = g_type_from_name(gtypestr);
+	if (gtype == G_TYPE_INVALID || !g_type_is_a(gtype, FU_TYPE_FIRMWARE)) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "GType %s is not a known FuFirmware",
+			    gtypestr);
+		return G_TYPE_INVALID;
+	}
+	return gtype;
+}
+
+/* repeat the payload of each leaf image to make the firmware more realistically sized */
+static void
+fu_bench_firmware_scale(FuFirmware *firmware, guint scale)
+{
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GBytes) blob_scaled = NULL;
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GPtrArray) imgs = fu_firmware_get_images(firmware);
+
+	if (imgs->len > 0) {
+		for (guint i = 0; i < imgs->len; i++) {
+			FuFirmware *img = g_ptr_array_index(imgs, i);
+			fu_bench_firmware_scale(img, scale);
+		}
+		return;
+	}
+	blob = fu_firmware_get_bytes(firmware, NULL);
+	if (blob == NULL || g_bytes_get_size(blob) == 0)
+		return;
+	for (guint i = 0; i < scale; i++)
+		fu_byte_array_append_bytes(buf, blob);
+	blob_scaled = g_byte_array_free_to_bytes(g_steal_pointer(&buf)); /* nocheck */
+	fu_firmware_set_bytes(firmware, blob_scaled);
+}
+
+static GBytes *
+fu_bench_firmware_build(GType gtype, const gchar *xml, guint scale, GError **error)
+{
+	g_autoptr(FuFirmware) firmware = g_object_new(gtype, NULL);
+	g_autoptr(FuFirmware) firmware_tmp = g_object_new(gtype, NULL);
+	g_autoptr(GBytes) blob = NULL;
+
+	if (!fu_firmware_build_from_xml(firmware, xml, error))
+		return NULL;
+	if (scale > 1)
+		fu_bench_firmware_scale(firmware, scale);
+	blob = fu_firmware_write(firmware, error);
+	if (blob == NULL)
+		return NULL;
+
+	/* the scaled firmware has to be valid for the benchmark to mean anything */
+	if (!fu_firmware_parse(firmware_tmp, blob, FWUPD_INSTALL_FLAG_NO_SEARCH, error))
+		return NULL;
+	return g_steal_pointer(&blob);
+}
+
+static gboolean
+fu_bench_firmware_run(FuBenchFirmwareHelper *helper, const gchar *filename, GError **error)
+{
+	GType gtype;
+	gint64 usec_export = 0;
+	gint64 usec_parse = 0;
+	gint64 usec_write = 0;
+	gsize size;
+	guint scale = 1;
+	g_autofree gchar *id = g_path_get_basename(filename);
+	g_autofree gchar *xml = NULL;
+	g_autoptr(GBytes) blob = NULL;
+
+	/* build the fixture at the native size */
+	if (!g_file_get_contents(filename, &xml, NULL, error))
+		return FALSE;
+	gtype = fu_bench_firmware_get_gtype(xml, error);
+	if (gtype == G_TYPE_INVALID)
+		return FALSE;
+	blob = fu_bench_firmware_build(gtype, xml, 1, error);
+	if (blob == NULL)
+		return FALSE;
+
+	/* try to scale up, but not all formats allow arbitrary payload sizes */
+	size = g_bytes_get_size(blob);
+	if (size > 0 && size * 2 <= helper->size_target) {
+		g_autoptr(GBytes) blob_scaled = NULL;
+		g_autoptr(GError) error_local = NULL;
+		scale = MIN(helper->size_target / size, FU_BENCH_FIRMWARE_SCALE_MAX);
+		blob_scaled = fu_bench_firmware_build(gtype, xml, scale, &error_local);
+		if (blob_scaled == NULL) {
+			g_debug("cannot scale %s x%u, using native size: %s",
+				id,
+				scale,
+				error_local->message);
+			scale = 1;
+		} else {
+			g_bytes_unref(blob);
+			blob = g_steal_pointer(&blob_scaled);
+			size = g_bytes_get_size(blob);
+		}
+	}
+
+	/* parse, write and export */
+	fu_bench_firmware_reset_peak_rss();
+	for (guint i = 0; i < helper->iterations; i++) {
+		gint64 usec_tmp;
+		g_autofree gchar *xml_tmp = NULL;
+		g_autoptr(FuFirmware) firmware = g_object_new(gtype, NULL);
+		g_autoptr(GBytes) blob_tmp = NULL;
+
+		usec_tmp = g_get_monotonic_time();
+		if (!fu_firmware_parse(firmware, blob, FWUPD_INSTALL_FLAG_NO_SEARCH, error))
+			return FALSE;
+		usec_parse += g_get_monotonic_time() - usec_tmp;
+
+		usec_tmp = g_get_monotonic_time();
+		blob_tmp = fu_firmware_write(firmware, error);
+		if (blob_tmp == NULL)
+			return FALSE;
+		usec_write += g_get_monotonic_time() - usec_tmp;
+
+		usec_tmp = g_get_monotonic_time();
+		xml_tmp = fu_firmware_export_to_xml(firmware, FU_FIRMWARE_EXPORT_FLAG_NONE, error);
+		if (xml_tmp == NULL)
+			return FALSE;
+		usec_export += g_get_monotonic_time() - usec_tmp;
+	}
+
+	/* bytes per microsecond is the same as MB/s */
+	json_builder_begin_object(helper->builder);
+	fwupd_codec_json_append(helper->builder, "Id", id);
+	fwupd_codec_json_append(helper->builder, "GType", g_type_name(gtype));
+	fwupd_codec_json_append_int(helper->builder, "Size", size);
+	fwupd_codec_json_append_int(helper->builder, "Scale", scale);
+	fwupd_codec_json_append_int(helper->builder, "Iterations", helper->iterations);
+	fwupd_codec_json_append_int(helper->builder, "ParseUsec", usec_parse / helper->iterations);
+	fwupd_codec_json_append_int(helper->builder, "WriteUsec", usec_write / helper->iterations);
+	fwupd_codec_json_append_int(helper->builder,
+				    "ExportUsec",
+				    usec_export / helper->iterations);
+	json_builder_set_member_name(helper->builder, "ParseMBps");
+	json_builder_add_double_value(helper->builder,
+				      (gdouble)size * helper->iterations / MAX(usec_parse, 1));
+	json_builder_set_member_name(helper->builder, "WriteMBps");
+	json_builder_add_double_value(helper->builder,
+				      (gdouble)size * helper->iterations / MAX(usec_write, 1));
+	fwupd_codec_json_append_int(helper->builder, "PeakRssKb", fu_bench_firmware_get_peak_rss());
+	json_builder_end_object(helper->builder);
+
+	/* success */
+	g_printerr("%-32s %-28s %8" G_GSIZE_FORMAT "B x%-4u parse:%8.2fMB/s write:%8.2fMB/s\n",
+		   id,
+		   g_type_name(gtype),
+		   size,
+		   scale,
+		   (gdouble)size * helper->iterations / MAX(usec_parse, 1),
+		   (gdouble)size * helper->iterations / MAX(usec_write, 1));
+	return TRUE;
+}
+
+static GPtrArray *
+fu_bench_firmware_get_default_filenames(GError **error)
+{
+	const gchar *fn;
+	g_autofree gchar *path = g_build_filename(SRCDIR, "tests", NULL);
+	g_autoptr(GDir) dir = NULL;
+	g_autoptr(GPtrArray) filenames = g_ptr_array_new_with_free_func(g_free);
+
+	dir = g_dir_open(path, 0, error);
+	if (dir == NULL)
+		return NULL;
+	while ((fn = g_dir_read_name(dir)) != NULL) {
+		if (!g_str_has_suffix(fn, ".builder.xml"))
+			continue;
+		g_ptr_array_add(filenames, g_build_filename(path, fn, NULL));
+	}
+	g_ptr_array_sort(filenames, (GCompareFunc)g_strcmp0);
+	return g_steal_pointer(&filenames);
+}
+
+int
+main(int argc, char **argv)
+{
+	gboolean verbose = FALSE;
+	gint iterations = 10;
+	gint64 size_target = 0x100000;
+	g_autofree gchar *output = NULL;
+	g_autofree gchar *str = NULL;
+	g_autoptr(GOptionContext) context = g_option_context_new("[FILE.builder.xml…]");
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) filenames = NULL;
+	g_autoptr(JsonBuilder) builder = json_builder_new();
+	g_autoptr(JsonGenerator) json_generator = json_generator_new();
+	g_autoptr(JsonNode) json_root = NULL;
+	FuBenchFirmwareHelper helper = {.builder = builder};
+
+	const GOptionEntry options[] = {
+	    {"verbose", 'v', 0, G_OPTION_ARG_NONE, &verbose, "Be verbose", NULL},
+	    {"iterations", 'i', 0, G_OPTION_ARG_INT, &iterations, "Iterations per file", NULL},
+	    {"size", 's', 0, G_OPTION_ARG_INT64, &size_target, "Scale firmware to size", NULL},
+	    {"output", 'o', 0, G_OPTION_ARG_FILENAME, &output, "Write JSON results", NULL},
+	    {NULL}};
+
+	setlocale(LC_ALL, "");
+
+#ifndef SUPPORTED_BUILD
+	/* make critical warnings fatal */
+	(void)g_setenv("G_DEBUG", "fatal-criticals", FALSE);
+#endif
+
+	g_option_context_add_main_entries(context, options, NULL);
+	if (!g_option_context_parse(context, &argc, &argv, &error)) {
+		g_printerr("Failed to parse arguments: %s\n", error->message);
+		return EXIT_FAILURE;
+	}
+	if (verbose)
+		(void)g_setenv("G_MESSAGES_DEBUG", "all", TRUE);
+	if (iterations <= 0 || size_target < 0) {
+		g_printerr("Invalid iterations or size\n");
+		return EXIT_FAILURE;
+	}
+	helper.iterations = iterations;
+	helper.size_target = size_target;
+
+	/* use the test fixtures by default */
+	if (argc > 1) {
+		filenames = g_ptr_array_new_with_free_func(g_free);
+		for (gint i = 1; i < argc; i++)
+			g_ptr_array_add(filenames, g_strdup(argv[i]));
+	} else {
+		filenames = fu_bench_firmware_get_default_filenames(&error);
+		if (filenames == NULL) {
+			g_printerr("Failed to find fixtures: %s\n", error->message);
+			return EXIT_FAILURE;
+		}
+	}
+
+	/* run each fixture, skipping any that cannot be built */
+	fu_bench_firmware_ensure_gtypes();
+	json_builder_begin_object(builder);
+	fwupd_codec_json_append(builder, "FwupdVersion", PACKAGE_VERSION);
+	json_builder_set_member_name(builder, "Results");
+	json_builder_begin_array(builder);
+	for (guint i = 0; i < filenames->len; i++) {
+		const gchar *filename = g_ptr_array_index(filenames, i);
+		g_autoptr(GError) error_local = NULL;
+		if (!fu_bench_firmware_run(&helper, filename, &error_local))
+			g_printerr("Skipping %s: %s\n", filename, error_local->message);
+	}
+	json_builder_end_array(builder);
+	json_builder_end_object(builder);
+
+	/* export as a string so it can be compared between releases */
+	json_root = json_builder_get_root(builder);
+	json_generator_set_pretty(json_generator, TRUE);
+	json_generator_set_root(json_generator, json_root);
+	str = json_generator_to_data(json_generator, NULL);
+	if (output != NULL) {
+		if (!g_file_set_contents(output, str, -1, &error)) {
+			g_printerr("Failed to write %s: %s\n", output, error->message);
+			return EXIT_FAILURE;
+		}
+		return EXIT_SUCCESS;
+	}
+	g_print("%s\n", str);
+	return EXIT_SUCCESS;
+}
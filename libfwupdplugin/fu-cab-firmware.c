@@ -18,6 +18,7 @@
 #include "fu-chunk-array.h"
 #include "fu-composite-input-stream.h"
 #include "fu-input-stream.h"
+#include "fu-lazy-input-stream.h"
 #include "fu-mem-private.h"
 #include "fu-partial-input-stream.h"
 #include "fu-string.h"
@@ -25,6 +26,7 @@
 typedef struct {
 	gboolean compressed;
 	gboolean only_basename;
+	gboolean lazy_decompress;
 } FuCabFirmwarePrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(FuCabFirmware, fu_cab_firmware, FU_TYPE_FIRMWARE)
@@ -103,12 +105,52 @@ fu_cab_firmware_set_only_basename(FuCabFirmware *self, gboolean only_basename)
 	priv->only_basename = only_basename;
 }
 
+/**
+ * fu_cab_firmware_get_lazy_decompress:
+ * @self: a #FuCabFirmware
+ *
+ * Gets if the cabinet archive folders should only be decompressed when a file is first read.
+ *
+ * Returns: boolean
+ *
+ * Since: 2.0.0
+ **/
+gboolean
+fu_cab_firmware_get_lazy_decompress(FuCabFirmware *self)
+{
+	FuCabFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_CAB_FIRMWARE(self), FALSE);
+	return priv->lazy_decompress;
+}
+
+/**
+ * fu_cab_firmware_set_lazy_decompress:
+ * @self: a #FuCabFirmware
+ * @lazy_decompress: boolean
+ *
+ * Sets if the cabinet archive folders should only be decompressed when a file is first read.
+ *
+ * When set, only the CFDATA headers are parsed when loading the archive, and the checksum and
+ * inflate errors are returned when reading from the image stream rather than when parsing.
+ * This only saves work when some of the files are never read, e.g. when just listing them.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_cab_firmware_set_lazy_decompress(FuCabFirmware *self, gboolean lazy_decompress)
+{
+	FuCabFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FU_IS_CAB_FIRMWARE(self));
+	priv->lazy_decompress = lazy_decompress;
+}
+
 typedef struct {
 	GInputStream *stream;
 	FwupdInstallFlags install_flags;
 	gsize rsvd_folder;
 	gsize rsvd_block;
 	gsize size_total;
+	gsize size_max;
 	FuCabCompression compression;
 	GPtrArray *folder_data; /* of FuCompositeInputStream */
 	z_stream zstrm;
@@ -180,24 +222,42 @@ zstream_deflater_free(z_stream_deflater *zstrm)
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(z_stream_deflater, zstream_deflater_free)
 
-static gboolean
-fu_cab_firmware_parse_data(FuCabFirmware *self,
-			   FuCabFirmwareParseHelper *helper,
-			   gsize *offset,
-			   GInputStream *folder_data,
-			   GError **error)
+static FuCabFirmwareParseHelper *
+fu_cab_firmware_parse_helper_new(GInputStream *stream, FwupdInstallFlags flags, GError **error)
+{
+	int zret;
+	g_autoptr(FuCabFirmwareParseHelper) helper = g_new0(FuCabFirmwareParseHelper, 1);
+
+	/* zlib */
+	helper->zstrm.zalloc = zalloc;
+	helper->zstrm.zfree = zfree;
+	zret = inflateInit2(&helper->zstrm, -MAX_WBITS);
+	if (zret != Z_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "failed to initialize inflate: %s",
+			    zError(zret));
+		return NULL;
+	}
+
+	helper->stream = g_object_ref(stream);
+	helper->install_flags = flags;
+	helper->folder_data = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	return g_steal_pointer(&helper);
+}
+
+static FuStructCabData *
+fu_cab_firmware_parse_data_header(FuCabFirmwareParseHelper *helper, gsize offset, GError **error)
 {
 	gsize blob_comp;
 	gsize blob_uncomp;
-	gsize hdr_sz;
-	gsize size_max = fu_firmware_get_size_max(FU_FIRMWARE(self));
 	g_autoptr(FuStructCabData) st = NULL;
-	g_autoptr(GInputStream) partial_stream = NULL;
 
 	/* parse header */
-	st = fu_struct_cab_data_parse_stream(helper->stream, *offset, error);
+	st = fu_struct_cab_data_parse_stream(helper->stream, offset, error);
 	if (st == NULL)
-		return FALSE;
+		return NULL;
 
 	/* sanity check */
 	blob_comp = fu_struct_cab_data_get_comp(st);
@@ -207,21 +267,43 @@ fu_cab_firmware_parse_data(FuCabFirmware *self,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_NOT_SUPPORTED,
 				    "mismatched compressed data");
-		return FALSE;
+		return NULL;
 	}
 	helper->size_total += blob_uncomp;
-	if (size_max > 0 && helper->size_total > size_max) {
+	if (helper->size_max > 0 && helper->size_total > helper->size_max) {
 		g_autofree gchar *sz_val = g_format_size(helper->size_total);
-		g_autofree gchar *sz_max = g_format_size(size_max);
+		g_autofree gchar *sz_max = g_format_size(helper->size_max);
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INVALID_DATA,
 			    "uncompressed data too large (%s, limit %s)",
 			    sz_val,
 			    sz_max);
-		return FALSE;
+		return NULL;
 	}
 
+	/* success */
+	return g_steal_pointer(&st);
+}
+
+static gboolean
+fu_cab_firmware_parse_data(FuCabFirmwareParseHelper *helper,
+			   gsize *offset,
+			   GInputStream *folder_data,
+			   GError **error)
+{
+	gsize blob_comp;
+	gsize blob_uncomp;
+	gsize hdr_sz;
+	g_autoptr(FuStructCabData) st = NULL;
+	g_autoptr(GInputStream) partial_stream = NULL;
+
+	/* parse header */
+	st = fu_cab_firmware_parse_data_header(helper, *offset, error);
+	if (st == NULL)
+		return FALSE;
+	blob_comp = fu_struct_cab_data_get_comp(st);
+	blob_uncomp = fu_struct_cab_data_get_uncomp(st);
 	hdr_sz = st->len + helper->rsvd_block;
 
 	/* verify checksum */
@@ -340,22 +422,106 @@ fu_cab_firmware_parse_data(FuCabFirmware *self,
 	return TRUE;
 }
 
-static gboolean
+typedef struct {
+	GInputStream *stream;
+	FwupdInstallFlags install_flags;
+	gsize rsvd_block;
+	FuCabCompression compression;
+	gsize offset;
+	guint ndatab;
+} FuCabFirmwareFolderHelper;
+
+static void
+fu_cab_firmware_folder_helper_free(FuCabFirmwareFolderHelper *folder_helper)
+{
+	g_object_unref(folder_helper->stream);
+	g_free(folder_helper);
+}
+
+/* only called when a file in the folder is first read */
+static GInputStream *
+fu_cab_firmware_folder_load_cb(gpointer user_data, GError **error)
+{
+	FuCabFirmwareFolderHelper *folder_helper = (FuCabFirmwareFolderHelper *)user_data;
+	gsize offset = folder_helper->offset;
+	g_autoptr(FuCabFirmwareParseHelper) helper = NULL;
+	g_autoptr(GInputStream) folder_data = fu_composite_input_stream_new();
+
+	helper = fu_cab_firmware_parse_helper_new(folder_helper->stream,
+						  folder_helper->install_flags,
+						  error);
+	if (helper == NULL)
+		return NULL;
+	helper->rsvd_block = folder_helper->rsvd_block;
+	helper->compression = folder_helper->compression;
+	for (guint i = 0; i < folder_helper->ndatab; i++) {
+		if (!fu_cab_firmware_parse_data(helper, &offset, folder_data, error))
+			return NULL;
+	}
+	return g_steal_pointer(&folder_data);
+}
+
+/* only the CFDATA headers are parsed, the checksums are verified when decompressing */
+static GInputStream *
+fu_cab_firmware_parse_folder_lazy(FuCabFirmwareParseHelper *helper,
+				  gsize offset,
+				  guint ndatab,
+				  GError **error)
+{
+	gsize folder_sz = 0;
+	gsize offset_data = offset;
+	gsize streamsz = 0;
+	FuCabFirmwareFolderHelper *folder_helper;
+
+	for (guint i = 0; i < ndatab; i++) {
+		g_autoptr(FuStructCabData) st = NULL;
+		st = fu_cab_firmware_parse_data_header(helper, offset_data, error);
+		if (st == NULL)
+			return NULL;
+		folder_sz += fu_struct_cab_data_get_uncomp(st);
+		offset_data += st->len + helper->rsvd_block + fu_struct_cab_data_get_comp(st);
+	}
+	if (!fu_input_stream_size(helper->stream, &streamsz, error))
+		return NULL;
+	if (offset_data > streamsz) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "CFDATA ends @0x%x and stream was 0x%x bytes in size",
+			    (guint)offset_data,
+			    (guint)streamsz);
+		return NULL;
+	}
+
+	/* success */
+	folder_helper = g_new0(FuCabFirmwareFolderHelper, 1);
+	folder_helper->stream = g_object_ref(helper->stream);
+	folder_helper->install_flags = helper->install_flags;
+	folder_helper->rsvd_block = helper->rsvd_block;
+	folder_helper->compression = helper->compression;
+	folder_helper->offset = offset;
+	folder_helper->ndatab = ndatab;
+	return fu_lazy_input_stream_new(folder_sz,
+					fu_cab_firmware_folder_load_cb,
+					folder_helper,
+					(GDestroyNotify)fu_cab_firmware_folder_helper_free);
+}
+
+static GInputStream *
 fu_cab_firmware_parse_folder(FuCabFirmware *self,
 			     FuCabFirmwareParseHelper *helper,
-			     guint idx,
 			     gsize offset,
-			     GInputStream *folder_data,
 			     GError **error)
 {
 	FuCabFirmwarePrivate *priv = GET_PRIVATE(self);
 	gsize offset_folder;
 	g_autoptr(GByteArray) st = NULL;
+	g_autoptr(GInputStream) folder_data = NULL;
 
 	/* parse header */
 	st = fu_struct_cab_folder_parse_stream(helper->stream, offset, error);
 	if (st == NULL)
-		return FALSE;
+		return NULL;
 
 	/* sanity check */
 	if (fu_struct_cab_folder_get_ndatab(st) == 0) {
@@ -363,7 +529,7 @@ fu_cab_firmware_parse_folder(FuCabFirmware *self,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_NOT_SUPPORTED,
 				    "no CFDATA blocks");
-		return FALSE;
+		return NULL;
 	}
 	helper->compression = fu_struct_cab_folder_get_compression(st);
 	if (helper->compression != FU_CAB_COMPRESSION_NONE)
@@ -375,18 +541,25 @@ fu_cab_firmware_parse_folder(FuCabFirmware *self,
 			    FWUPD_ERROR_NOT_SUPPORTED,
 			    "compression %s not supported",
 			    fu_cab_compression_to_string(helper->compression));
-		return FALSE;
+		return NULL;
 	}
 
 	/* parse CDATA */
 	offset_folder = fu_struct_cab_folder_get_offset(st);
+	if (priv->lazy_decompress) {
+		return fu_cab_firmware_parse_folder_lazy(helper,
+							 offset_folder,
+							 fu_struct_cab_folder_get_ndatab(st),
+							 error);
+	}
+	folder_data = fu_composite_input_stream_new();
 	for (guint i = 0; i < fu_struct_cab_folder_get_ndatab(st); i++) {
-		if (!fu_cab_firmware_parse_data(self, helper, &offset_folder, folder_data, error))
-			return FALSE;
+		if (!fu_cab_firmware_parse_data(helper, &offset_folder, folder_data, error))
+			return NULL;
 	}
 
 	/* success */
-	return TRUE;
+	return g_steal_pointer(&folder_data);
 }
 
 static gboolean
@@ -481,31 +654,6 @@ fu_cab_firmware_validate(FuFirmware *firmware, GInputStream *stream, gsize offse
 	return fu_struct_cab_header_validate_stream(stream, offset, error);
 }
 
-static FuCabFirmwareParseHelper *
-fu_cab_firmware_parse_helper_new(GInputStream *stream, FwupdInstallFlags flags, GError **error)
-{
-	int zret;
-	g_autoptr(FuCabFirmwareParseHelper) helper = g_new0(FuCabFirmwareParseHelper, 1);
-
-	/* zlib */
-	helper->zstrm.zalloc = zalloc;
-	helper->zstrm.zfree = zfree;
-	zret = inflateInit2(&helper->zstrm, -MAX_WBITS);
-	if (zret != Z_OK) {
-		g_set_error(error,
-			    FWUPD_ERROR,
-			    FWUPD_ERROR_NOT_SUPPORTED,
-			    "failed to initialize inflate: %s",
-			    zError(zret));
-		return NULL;
-	}
-
-	helper->stream = g_object_ref(stream);
-	helper->install_flags = flags;
-	helper->folder_data = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
-	return g_steal_pointer(&helper);
-}
-
 static gboolean
 fu_cab_firmware_parse(FuFirmware *firmware,
 		      GInputStream *stream,
@@ -584,6 +732,7 @@ fu_cab_firmware_parse(FuFirmware *firmware,
 	helper = fu_cab_firmware_parse_helper_new(stream, flags, error);
 	if (helper == NULL)
 		return FALSE;
+	helper->size_max = fu_firmware_get_size_max(firmware);
 
 	/* reserved sizes */
 	offset += st->len;
@@ -600,8 +749,9 @@ fu_cab_firmware_parse(FuFirmware *firmware,
 
 	/* parse CFFOLDER */
 	for (guint i = 0; i < fu_struct_cab_header_get_nr_folders(st); i++) {
-		g_autoptr(GInputStream) folder_data = fu_composite_input_stream_new();
-		if (!fu_cab_firmware_parse_folder(self, helper, i, offset, folder_data, error))
+		g_autoptr(GInputStream) folder_data = NULL;
+		folder_data = fu_cab_firmware_parse_folder(self, helper, offset, error);
+		if (folder_data == NULL)
 			return FALSE;
 		if (!fu_input_stream_size(folder_data, &streamsz, error))
 			return FALSE;
@@ -30,6 +30,10 @@
  * * `SectorSize`: 0x1000
  * * `BlockSize`: 0x10000
  *
+ * If the sector erase command is defined and the firmware is a multiple of the sector size then
+ * the existing contents are read first, and only the sectors that have changed are erased,
+ * written and verified. Otherwise the whole chip is erased before writing.
+ *
  * See also: [class@FuDevice]
  */
 
@@ -51,6 +55,12 @@ enum { PROP_0, PROP_FLASH_ID, PROP_LAST };
 #define FU_CFI_DEVICE_SECTOR_SIZE_DEFAULT 0x1000
 #define FU_CFI_DEVICE_BLOCK_SIZE_DEFAULT  0x10000
 
+typedef enum {
+	FU_CFI_DEVICE_SECTOR_STATE_UNCHANGED,
+	FU_CFI_DEVICE_SECTOR_STATE_PROGRAM, /* only clearing bits, so no erase required */
+	FU_CFI_DEVICE_SECTOR_STATE_ERASE,
+} FuCfiDeviceSectorState;
+
 static const gchar *
 fu_cfi_device_cmd_to_string(FuCfiDeviceCmd cmd)
 {
@@ -747,6 +757,35 @@ fu_cfi_device_chip_erase(FuCfiDevice *self, GError **error)
 	return fu_cfi_device_wait_for_status(self, 0b1, 0b0, 100, 500, error);
 }
 
+static gboolean
+fu_cfi_device_erase_address(FuCfiDevice *self, FuCfiDeviceCmd cmd, guint32 addr, GError **error)
+{
+	guint8 buf[4] = {0x0}; /* cmd, then 24 bit starting address */
+	g_autoptr(FuDeviceLocker) cslocker = NULL;
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+
+	if (!fu_cfi_device_get_cmd(self, cmd, &buf[0], error))
+		return FALSE;
+	if (!fu_cfi_device_write_enable(self, error))
+		return FALSE;
+
+	/* enable chip */
+	cslocker = fu_cfi_device_chip_select_locker_new(self, error);
+	if (cslocker == NULL)
+		return FALSE;
+
+	/* erase */
+	fu_memwrite_uint24(buf + 0x1, addr, G_BIG_ENDIAN);
+	g_debug("erasing %s at 0x%x", fu_cfi_device_cmd_to_string(cmd), addr);
+	if (!fu_cfi_device_send_command(self, buf, sizeof(buf), NULL, 0, progress, error))
+		return FALSE;
+	if (!fu_device_locker_close(cslocker, error))
+		return FALSE;
+
+	/* poll Read Status register BUSY */
+	return fu_cfi_device_wait_for_status(self, 0b1, 0b0, 100, 50, error);
+}
+
 static gboolean
 fu_cfi_device_write_page(FuCfiDevice *self, FuChunk *page, FuProgress *progress, GError **error)
 {
@@ -873,6 +912,291 @@ fu_cfi_device_dump_firmware(FuDevice *device, FuProgress *progress, GError **err
 	return fu_cfi_device_read_firmware(self, bufsz, progress, error);
 }
 
+static gboolean
+fu_cfi_device_buf_is_erased(const guint8 *buf, gsize bufsz)
+{
+	for (gsize i = 0; i < bufsz; i++) {
+		if (buf[i] != 0xFF)
+			return FALSE;
+	}
+	return TRUE;
+}
+
+static FuCfiDeviceSectorState
+fu_cfi_device_get_sector_state(FuChunk *chk_old, FuChunk *chk_new)
+{
+	const guint8 *buf_old = fu_chunk_get_data(chk_old);
+	const guint8 *buf_new = fu_chunk_get_data(chk_new);
+	gboolean changed = FALSE;
+
+	for (gsize i = 0; i < fu_chunk_get_data_sz(chk_new); i++) {
+		if (buf_old[i] == buf_new[i])
+			continue;
+		/* programming can only clear bits */
+		if ((buf_old[i] & buf_new[i]) != buf_new[i])
+			return FU_CFI_DEVICE_SECTOR_STATE_ERASE;
+		changed = TRUE;
+	}
+	return changed ? FU_CFI_DEVICE_SECTOR_STATE_PROGRAM : FU_CFI_DEVICE_SECTOR_STATE_UNCHANGED;
+}
+
+/* we can only use the differential write if we can erase each sector on its own */
+static gboolean
+fu_cfi_device_can_write_differential(FuCfiDevice *self, gsize bufsz)
+{
+	FuCfiDevicePrivate *priv = GET_PRIVATE(self);
+	if (!fu_cfi_device_get_cmd(self, FU_CFI_DEVICE_CMD_SECTOR_ERASE, NULL, NULL))
+		return FALSE;
+	if (priv->sector_size == 0 || priv->page_size == 0)
+		return FALSE;
+	if (priv->sector_size % priv->page_size != 0)
+		return FALSE;
+	return bufsz % priv->sector_size == 0;
+}
+
+static gboolean
+fu_cfi_device_erase_sectors(FuCfiDevice *self,
+			    GPtrArray *sectors,
+			    FuCfiDeviceSectorState *states,
+			    FuProgress *progress,
+			    GError **error)
+{
+	FuCfiDevicePrivate *priv = GET_PRIVATE(self);
+	guint sectors_per_block = 0;
+
+	/* use the larger erase command for whole blocks if possible */
+	if (fu_cfi_device_get_cmd(self, FU_CFI_DEVICE_CMD_BLOCK_ERASE, NULL, NULL) &&
+	    priv->block_size > priv->sector_size && priv->block_size % priv->sector_size == 0)
+		sectors_per_block = priv->block_size / priv->sector_size;
+
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_set_steps(progress, sectors->len);
+	for (guint i = 0; i < sectors->len; i++) {
+		FuChunk *chk = g_ptr_array_index(sectors, i);
+		guint32 addr = fu_chunk_get_address(chk);
+
+		if (states[i] != FU_CFI_DEVICE_SECTOR_STATE_ERASE) {
+			fu_progress_step_done(progress);
+			continue;
+		}
+		if (sectors_per_block > 0 && addr % priv->block_size == 0 &&
+		    i + sectors_per_block <= sectors->len) {
+			gboolean all_erase = TRUE;
+			for (guint j = i; j < i + sectors_per_block; j++) {
+				if (states[j] != FU_CFI_DEVICE_SECTOR_STATE_ERASE) {
+					all_erase = FALSE;
+					break;
+				}
+			}
+			if (all_erase) {
+				if (!fu_cfi_device_erase_address(self,
+								 FU_CFI_DEVICE_CMD_BLOCK_ERASE,
+								 addr,
+								 error))
+					return FALSE;
+				for (guint j = 0; j < sectors_per_block; j++)
+					fu_progress_step_done(progress);
+				i += sectors_per_block - 1;
+				continue;
+			}
+		}
+		if (!fu_cfi_device_erase_address(self, FU_CFI_DEVICE_CMD_SECTOR_ERASE, addr, error))
+			return FALSE;
+		fu_progress_step_done(progress);
+	}
+
+	/* success */
+	return TRUE;
+}
+
+static gboolean
+fu_cfi_device_write_sectors(FuCfiDevice *self,
+			    GPtrArray *sectors_old,
+			    FuChunkArray *sectors,
+			    FuCfiDeviceSectorState *states,
+			    FuProgress *progress,
+			    GError **error)
+{
+	FuCfiDevicePrivate *priv = GET_PRIVATE(self);
+
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_set_steps(progress, fu_chunk_array_length(sectors));
+	for (guint i = 0; i < fu_chunk_array_length(sectors); i++) {
+		FuChunk *chk_old = g_ptr_array_index(sectors_old, i);
+		g_autoptr(FuChunk) chk = NULL;
+		g_autoptr(GPtrArray) pages = NULL;
+
+		if (states[i] == FU_CFI_DEVICE_SECTOR_STATE_UNCHANGED) {
+			fu_progress_step_done(progress);
+			continue;
+		}
+		chk = fu_chunk_array_index(sectors, i, error);
+		if (chk == NULL)
+			return FALSE;
+		pages = fu_chunk_array_new(fu_chunk_get_data(chk),
+					   fu_chunk_get_data_sz(chk),
+					   fu_chunk_get_address(chk),
+					   0x0,
+					   priv->page_size);
+		for (guint j = 0; j < pages->len; j++) {
+			FuChunk *page = g_ptr_array_index(pages, j);
+			const guint8 *buf = fu_chunk_get_data(page);
+			gsize offset = fu_chunk_get_address(page) - fu_chunk_get_address(chk);
+
+			/* already in the right state */
+			if (states[i] == FU_CFI_DEVICE_SECTOR_STATE_ERASE &&
+			    fu_cfi_device_buf_is_erased(buf, fu_chunk_get_data_sz(page)))
+				continue;
+			if (states[i] == FU_CFI_DEVICE_SECTOR_STATE_PROGRAM &&
+			    memcmp(fu_chunk_get_data(chk_old) + offset,
+				   buf,
+				   fu_chunk_get_data_sz(page)) == 0)
+				continue;
+			if (!fu_cfi_device_write_page(self,
+						      page,
+						      fu_progress_get_child(progress),
+						      error))
+				return FALSE;
+		}
+		fu_progress_step_done(progress);
+	}
+
+	/* success */
+	return TRUE;
+}
+
+static gboolean
+fu_cfi_device_verify_sectors(FuCfiDevice *self,
+			     GPtrArray *sectors_old,
+			     FuChunkArray *sectors,
+			     FuCfiDeviceSectorState *states,
+			     FuProgress *progress,
+			     GError **error)
+{
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_set_steps(progress, fu_chunk_array_length(sectors));
+	for (guint i = 0; i < fu_chunk_array_length(sectors); i++) {
+		FuChunk *chk_old = g_ptr_array_index(sectors_old, i);
+		g_autoptr(FuChunk) chk = NULL;
+
+		if (states[i] == FU_CFI_DEVICE_SECTOR_STATE_UNCHANGED) {
+			fu_progress_step_done(progress);
+			continue;
+		}
+
+		/* reuse the buffer of the old contents */
+		chk = fu_chunk_array_index(sectors, i, error);
+		if (chk == NULL)
+			return FALSE;
+		if (!fu_cfi_device_read_block(self, chk_old, fu_progress_get_child(progress), error))
+			return FALSE;
+		if (!fu_memcmp_safe(fu_chunk_get_data(chk_old),
+				    fu_chunk_get_data_sz(chk_old),
+				    0x0,
+				    fu_chunk_get_data(chk),
+				    fu_chunk_get_data_sz(chk),
+				    0x0,
+				    fu_chunk_get_data_sz(chk),
+				    error)) {
+			g_prefix_error(error, "sector @0x%x: ", (guint)fu_chunk_get_address(chk));
+			return FALSE;
+		}
+		fu_progress_step_done(progress);
+	}
+
+	/* success */
+	return TRUE;
+}
+
+static gboolean
+fu_cfi_device_write_firmware_differential(FuCfiDevice *self,
+					  GBytes *fw,
+					  FuProgress *progress,
+					  GError **error)
+{
+	FuCfiDevicePrivate *priv = GET_PRIVATE(self);
+	guint sectors_changed = 0;
+	g_autofree FuCfiDeviceSectorState *states = NULL;
+	g_autoptr(FuChunkArray) sectors = NULL;
+	g_autoptr(GByteArray) buf_old = g_byte_array_new();
+	g_autoptr(GPtrArray) sectors_old = NULL;
+
+	/* progress */
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_READ, 20, NULL);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_ERASE, 10, NULL);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 65, NULL);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_VERIFY, 5, NULL);
+
+	/* read the existing contents a sector at a time */
+	fu_byte_array_set_size(buf_old, g_bytes_get_size(fw), 0x0);
+	sectors_old =
+	    fu_chunk_array_mutable_new(buf_old->data, buf_old->len, 0x0, 0x0, priv->sector_size);
+	sectors = fu_chunk_array_new_from_bytes(fw, 0x0, priv->sector_size);
+	states = g_new0(FuCfiDeviceSectorState, sectors_old->len);
+	fu_progress_set_id(fu_progress_get_child(progress), G_STRLOC);
+	fu_progress_set_steps(fu_progress_get_child(progress), sectors_old->len);
+	for (guint i = 0; i < sectors_old->len; i++) {
+		FuChunk *chk_old = g_ptr_array_index(sectors_old, i);
+		g_autoptr(FuChunk) chk = NULL;
+
+		if (!fu_cfi_device_read_block(self,
+					      chk_old,
+					      fu_progress_get_child(fu_progress_get_child(progress)),
+					      error)) {
+			g_prefix_error(error, "failed to read sector: ");
+			return FALSE;
+		}
+		chk = fu_chunk_array_index(sectors, i, error);
+		if (chk == NULL)
+			return FALSE;
+		states[i] = fu_cfi_device_get_sector_state(chk_old, chk);
+		if (states[i] != FU_CFI_DEVICE_SECTOR_STATE_UNCHANGED)
+			sectors_changed++;
+		fu_progress_step_done(fu_progress_get_child(progress));
+	}
+	g_debug("%u of %u sectors changed", sectors_changed, sectors_old->len);
+	fu_progress_step_done(progress);
+
+	/* only erase what is required */
+	if (!fu_cfi_device_erase_sectors(self,
+					 sectors_old,
+					 states,
+					 fu_progress_get_child(progress),
+					 error)) {
+		g_prefix_error(error, "failed to erase: ");
+		return FALSE;
+	}
+	fu_progress_step_done(progress);
+
+	/* write each changed page */
+	if (!fu_cfi_device_write_sectors(self,
+					 sectors_old,
+					 sectors,
+					 states,
+					 fu_progress_get_child(progress),
+					 error)) {
+		g_prefix_error(error, "failed to write pages: ");
+		return FALSE;
+	}
+	fu_progress_step_done(progress);
+
+	/* verify each changed sector */
+	if (!fu_cfi_device_verify_sectors(self,
+					  sectors_old,
+					  sectors,
+					  states,
+					  fu_progress_get_child(progress),
+					  error)) {
+		g_prefix_error(error, "verify failed: ");
+		return FALSE;
+	}
+	fu_progress_step_done(progress);
+
+	/* success! */
+	return TRUE;
+}
+
 static gboolean
 fu_cfi_device_write_firmware(FuDevice *device,
 			     FuFirmware *firmware,
@@ -891,17 +1215,21 @@ fu_cfi_device_write_firmware(FuDevice *device,
 	if (locker == NULL)
 		return FALSE;
 
+	/* get default image */
+	fw = fu_firmware_get_bytes(firmware, error);
+	if (fw == NULL)
+		return FALSE;
+
+	/* only erase and write the sectors that have changed */
+	if (fu_cfi_device_can_write_differential(self, g_bytes_get_size(fw)))
+		return fu_cfi_device_write_firmware_differential(self, fw, progress, error);
+
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_ERASE, 10, NULL);
 	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 85, NULL);
 	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_VERIFY, 5, NULL);
 
-	/* get default image */
-	fw = fu_firmware_get_bytes(firmware, error);
-	if (fw == NULL)
-		return FALSE;
-
 	/* erase */
 	if (!fu_cfi_device_write_enable(self, error)) {
 		g_prefix_error(error, "failed to enable writes: ");
@@ -31,3 +31,14 @@ enum FuDisplayState {
     Connected,
     Disconnected,
 }
+
+#[derive(ToString)]
+enum FuChecksumKind {
+    Unknown,
+    Crc8,                   // as fu_crc8()
+    Crc16,                  // as fu_crc16()
+    Crc32,                  // as fu_crc32()
+    Sum8,                   // as fu_sum8()
+    Sum16,                  // as fu_sum16()
+    Sum32,                  // as fu_sum32()
+}
@@ -37,6 +37,8 @@ gboolean
 fu_context_load_quirks(FuContext *self, FuQuirksLoadFlags flags, GError **error) G_GNUC_NON_NULL(1);
 GHashTable *
 fu_context_get_runtime_versions(FuContext *self) G_GNUC_NON_NULL(1);
+guint
+fu_context_get_generation(FuContext *self) G_GNUC_NON_NULL(1);
 GHashTable *
 fu_context_get_compile_versions(FuContext *self) G_GNUC_NON_NULL(1);
 void
@@ -65,4 +67,17 @@ fu_context_get_hwids(FuContext *self) G_GNUC_NON_NULL(1);
 FuConfig *
 fu_context_get_config(FuContext *self) G_GNUC_NON_NULL(1);
 void
+fu_context_set_firmware_cache_max_age(FuContext *self, guint max_age) G_GNUC_NON_NULL(1);
+guint
+fu_context_get_firmware_cache_max_age(FuContext *self) G_GNUC_NON_NULL(1);
+FuFirmware *
+fu_context_firmware_cache_lookup(FuContext *self, const gchar *key) G_GNUC_NON_NULL(1, 2);
+void
+fu_context_firmware_cache_add(FuContext *self,
+			      const gchar *key,
+			      GInputStream *stream,
+			      FuFirmware *firmware) G_GNUC_NON_NULL(1, 2, 3, 4);
+void
+fu_context_firmware_cache_clear(FuContext *self) G_GNUC_NON_NULL(1);
+void
 fu_context_set_chassis_kind(FuContext *self, FuSmbiosChassisKind chassis_kind) G_GNUC_NON_NULL(1);
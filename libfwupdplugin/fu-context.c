@@ -46,8 +46,19 @@ typedef struct {
 	FuBiosSettings *host_bios_settings;
 	FuFirmware *fdt; /* optional */
 	gchar *esp_location;
+	GHashTable *firmware_cache; /* utf8:FuContextFirmwareCacheItem */
+	GMutex firmware_cache_mutex;
+	guint firmware_cache_max_age;
+	guint firmware_cache_id;
+	guint generation; /* incremented when host state changes */
 } FuContextPrivate;
 
+typedef struct {
+	GInputStream *stream; /* the key uses the address, so keep it alive */
+	FuFirmware *firmware;
+	gint64 ctime;	      /* monotonic, in us */
+} FuContextFirmwareCacheItem;
+
 enum { SIGNAL_SECURITY_CHANGED, SIGNAL_LAST };
 
 enum {
@@ -67,6 +78,14 @@ G_DEFINE_TYPE_WITH_PRIVATE(FuContext, fu_context, G_TYPE_OBJECT)
 
 #define GET_PRIVATE(o) (fu_context_get_instance_private(o))
 
+static void
+fu_context_firmware_cache_item_free(FuContextFirmwareCacheItem *item)
+{
+	g_object_unref(item->stream);
+	g_object_unref(item->firmware);
+	g_free(item);
+}
+
 static GFile *
 fu_context_get_fdt_file(GError **error)
 {
@@ -505,7 +524,30 @@ fu_context_add_runtime_version(FuContext *self, const gchar *component_id, const
 
 	if (priv->runtime_versions == NULL)
 		return;
+	if (g_strcmp0(g_hash_table_lookup(priv->runtime_versions, component_id), version) == 0)
+		return;
 	g_hash_table_insert(priv->runtime_versions, g_strdup(component_id), g_strdup(version));
+	priv->generation++;
+}
+
+/**
+ * fu_context_get_generation:
+ * @self: a #FuContext
+ *
+ * Gets a counter that is incremented every time host state such as the HWIDs, the context
+ * flags or the runtime versions changes. This can be used to invalidate any results that only
+ * depend on the host.
+ *
+ * Returns: integer
+ *
+ * Since: 2.0.0
+ **/
+guint
+fu_context_get_generation(FuContext *self)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_CONTEXT(self), G_MAXUINT);
+	return priv->generation;
 }
 
 /**
@@ -734,6 +776,172 @@ fu_context_add_firmware_gtype(FuContext *self, const gchar *id, GType gtype)
 	g_hash_table_insert(priv->firmware_gtypes, g_strdup(id), GSIZE_TO_POINTER(gtype));
 }
 
+/* called with the mutex held */
+static void
+fu_context_firmware_cache_prune(FuContext *self)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	GHashTableIter iter;
+	gpointer value;
+	gint64 now = g_get_monotonic_time();
+
+	g_hash_table_iter_init(&iter, priv->firmware_cache);
+	while (g_hash_table_iter_next(&iter, NULL, &value)) {
+		FuContextFirmwareCacheItem *item = (FuContextFirmwareCacheItem *)value;
+		if (now - item->ctime >= (gint64)priv->firmware_cache_max_age * G_USEC_PER_SEC)
+			g_hash_table_iter_remove(&iter);
+	}
+}
+
+static gboolean
+fu_context_firmware_cache_timeout_cb(gpointer user_data)
+{
+	FuContext *self = FU_CONTEXT(user_data);
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&priv->firmware_cache_mutex);
+
+	fu_context_firmware_cache_prune(self);
+	if (g_hash_table_size(priv->firmware_cache) > 0)
+		return G_SOURCE_CONTINUE;
+	priv->firmware_cache_id = 0;
+	return G_SOURCE_REMOVE;
+}
+
+/**
+ * fu_context_set_firmware_cache_max_age:
+ * @self: a #FuContext
+ * @max_age: age in seconds, or 0 to disable
+ *
+ * Sets how long parsed firmware is kept for in the firmware cache.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_context_set_firmware_cache_max_age(FuContext *self, guint max_age)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail(FU_IS_CONTEXT(self));
+
+	locker = g_mutex_locker_new(&priv->firmware_cache_mutex);
+	priv->firmware_cache_max_age = max_age;
+	fu_context_firmware_cache_prune(self);
+}
+
+/**
+ * fu_context_get_firmware_cache_max_age:
+ * @self: a #FuContext
+ *
+ * Gets how long parsed firmware is kept for in the firmware cache.
+ *
+ * Returns: age in seconds, or 0 for disabled
+ *
+ * Since: 2.0.0
+ **/
+guint
+fu_context_get_firmware_cache_max_age(FuContext *self)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_CONTEXT(self), 0);
+	return priv->firmware_cache_max_age;
+}
+
+/**
+ * fu_context_firmware_cache_clear:
+ * @self: a #FuContext
+ *
+ * Removes everything from the firmware cache, typically at the end of a transaction.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_context_firmware_cache_clear(FuContext *self)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail(FU_IS_CONTEXT(self));
+
+	locker = g_mutex_locker_new(&priv->firmware_cache_mutex);
+	g_hash_table_remove_all(priv->firmware_cache);
+}
+
+/**
+ * fu_context_firmware_cache_lookup:
+ * @self: a #FuContext
+ * @key: a string, typically the firmware #GType name and the stream address
+ *
+ * Finds firmware that was previously added using fu_context_firmware_cache_add().
+ *
+ * Returns: (transfer full): a #FuFirmware, or %NULL if not found or expired
+ *
+ * Since: 2.0.0
+ **/
+FuFirmware *
+fu_context_firmware_cache_lookup(FuContext *self, const gchar *key)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	FuContextFirmwareCacheItem *item;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_val_if_fail(FU_IS_CONTEXT(self), NULL);
+	g_return_val_if_fail(key != NULL, NULL);
+
+	locker = g_mutex_locker_new(&priv->firmware_cache_mutex);
+	fu_context_firmware_cache_prune(self);
+	item = g_hash_table_lookup(priv->firmware_cache, key);
+	if (item == NULL)
+		return NULL;
+	return g_object_ref(item->firmware);
+}
+
+/**
+ * fu_context_firmware_cache_add:
+ * @self: a #FuContext
+ * @key: a string, typically the firmware #GType name and the stream address
+ * @stream: the #GInputStream the firmware was parsed from
+ * @firmware: a #FuFirmware
+ *
+ * Adds firmware that has been parsed successfully to the firmware cache so that it can be reused
+ * when the same stream is deployed to another device. A reference to @stream is kept so that the
+ * address cannot be reused while the entry exists. Nothing is added if the cache is disabled.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_context_firmware_cache_add(FuContext *self,
+			      const gchar *key,
+			      GInputStream *stream,
+			      FuFirmware *firmware)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	FuContextFirmwareCacheItem *item;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail(FU_IS_CONTEXT(self));
+	g_return_if_fail(key != NULL);
+	g_return_if_fail(G_IS_INPUT_STREAM(stream));
+	g_return_if_fail(FU_IS_FIRMWARE(firmware));
+
+	locker = g_mutex_locker_new(&priv->firmware_cache_mutex);
+	if (priv->firmware_cache_max_age == 0)
+		return;
+	item = g_new0(FuContextFirmwareCacheItem, 1);
+	item->stream = g_object_ref(stream);
+	item->firmware = g_object_ref(firmware);
+	item->ctime = g_get_monotonic_time();
+	g_hash_table_insert(priv->firmware_cache, g_strdup(key), item);
+
+	/* drop the firmware as soon as it expires */
+	if (priv->firmware_cache_id == 0) {
+		priv->firmware_cache_id =
+		    g_timeout_add_seconds(priv->firmware_cache_max_age,
+					  fu_context_firmware_cache_timeout_cb,
+					  self);
+	}
+}
+
 /**
  * fu_context_get_firmware_gtype_by_id:
  * @self: a #FuContext
@@ -1010,6 +1218,7 @@ fu_context_load_hwinfo(FuContext *self,
 
 	if (!fu_hwids_setup(priv->hwids, &error_hwids))
 		g_warning("Failed to load HWIDs: %s", error_hwids->message);
+	priv->generation++;
 	fu_progress_step_done(progress);
 
 	/* set the hwid flags */
@@ -1296,6 +1505,7 @@ fu_context_add_flag(FuContext *context, FuContextFlags flag)
 	if (priv->flags & flag)
 		return;
 	priv->flags |= flag;
+	priv->generation++;
 	g_object_notify(G_OBJECT(context), "flags");
 }
 
@@ -1316,6 +1526,7 @@ fu_context_remove_flag(FuContext *context, FuContextFlags flag)
 	if ((priv->flags & flag) == 0)
 		return;
 	priv->flags &= ~flag;
+	priv->generation++;
 	g_object_notify(G_OBJECT(context), "flags");
 }
 
@@ -1566,6 +1777,10 @@ fu_context_finalize(GObject *object)
 
 	if (priv->fdt != NULL)
 		g_object_unref(priv->fdt);
+	if (priv->firmware_cache_id != 0)
+		g_source_remove(priv->firmware_cache_id);
+	g_hash_table_unref(priv->firmware_cache);
+	g_mutex_clear(&priv->firmware_cache_mutex);
 	g_free(priv->esp_location);
 	g_hash_table_unref(priv->runtime_versions);
 	g_hash_table_unref(priv->compile_versions);
@@ -1731,6 +1946,12 @@ fu_context_init(FuContext *self)
 	priv->esp_volumes = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
 	priv->runtime_versions = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
 	priv->compile_versions = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	priv->firmware_cache =
+	    g_hash_table_new_full(g_str_hash,
+				  g_str_equal,
+				  g_free,
+				  (GDestroyNotify)fu_context_firmware_cache_item_free);
+	g_mutex_init(&priv->firmware_cache_mutex);
 }
 
 /**
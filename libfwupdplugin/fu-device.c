@@ -8,6 +8,7 @@
 
 #include "config.h"
 
+#include <errno.h>
 #include <gio/gio.h>
 #include <string.h>
 
@@ -16,11 +17,14 @@
 
 #include "fu-bytes.h"
 #include "fu-common.h"
+#include "fu-context-private.h"
+#include "fu-crc.h"
 #include "fu-device-private.h"
 #include "fu-input-stream.h"
 #include "fu-quirks.h"
 #include "fu-security-attr.h"
 #include "fu-string.h"
+#include "fu-sum.h"
 #include "fu-version-common.h"
 
 #define FU_DEVICE_RETRY_OPEN_COUNT 5
@@ -76,6 +80,7 @@ typedef struct {
 	GPtrArray *instance_id_quirks; /* of utf-8 */
 	GPtrArray *retry_recs;	       /* of FuDeviceRetryRecovery */
 	guint retry_delay;
+	guint64 sleep_total; /* ms */
 	FuDeviceInternalFlags internal_flags;
 	guint64 private_flags;
 	GPtrArray *private_flag_items; /* (nullable) */
@@ -91,6 +96,9 @@ typedef struct {
 	FuDeviceRetryFunc recovery_func;
 } FuDeviceRetryRecovery;
 
+/* for FU_DEVICE_RETRY_FLAG_FAST_FIRST */
+#define FU_DEVICE_RETRY_FAST_FIRST_COUNT 3
+
 typedef struct {
 	FwupdDeviceProblem problem;
 	gchar *inhibit_id;
@@ -738,6 +746,30 @@ fu_device_retry_set_delay(FuDevice *self, guint delay)
 	priv->retry_delay = delay;
 }
 
+/* returns %FALSE if the device cannot be recovered, and so no more tries should be made */
+static gboolean
+fu_device_retry_recover(FuDevice *self, GError **error_local, gpointer user_data, GError **error)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+
+	/* find the condition that matches */
+	for (guint j = 0; j < priv->retry_recs->len; j++) {
+		FuDeviceRetryRecovery *rec = g_ptr_array_index(priv->retry_recs, j);
+		if (g_error_matches(*error_local, rec->domain, rec->code)) {
+			if (rec->recovery_func != NULL) {
+				if (!rec->recovery_func(self, user_data, error))
+					return FALSE;
+			} else {
+				g_propagate_prefixed_error(error,
+							   g_steal_pointer(error_local),
+							   "device recovery not possible: ");
+				return FALSE;
+			}
+		}
+	}
+	return TRUE;
+}
+
 /**
  * fu_device_retry_full:
  * @self: a #FuDevice
@@ -807,23 +839,117 @@ fu_device_retry_full(FuDevice *self,
 			g_info("failed on try %u of %u: %s", i + 1, count, error_local->message);
 			continue;
 		}
+		if (!fu_device_retry_recover(self, &error_local, user_data, error))
+			return FALSE;
+	}
 
-		/* find the condition that matches */
-		for (guint j = 0; j < priv->retry_recs->len; j++) {
-			FuDeviceRetryRecovery *rec = g_ptr_array_index(priv->retry_recs, j);
-			if (g_error_matches(error_local, rec->domain, rec->code)) {
-				if (rec->recovery_func != NULL) {
-					if (!rec->recovery_func(self, user_data, error))
-						return FALSE;
-				} else {
-					g_propagate_prefixed_error(
-					    error,
-					    g_steal_pointer(&error_local),
-					    "device recovery not possible: ");
-					return FALSE;
-				}
-			}
+	/* success */
+	return TRUE;
+}
+
+static guint
+fu_device_retry_backoff_get_delay(guint i,
+				  guint delay_min,
+				  guint delay_max,
+				  FuDeviceRetryFlags flags)
+{
+	guint delay = delay_min;
+
+	if (flags & FU_DEVICE_RETRY_FLAG_FAST_FIRST) {
+		if (i >= FU_DEVICE_RETRY_FAST_FIRST_COUNT)
+			delay = delay_max;
+	} else if (flags & FU_DEVICE_RETRY_FLAG_BACKOFF) {
+		guint64 tmp = (guint64)MAX(delay_min, 1) << MIN(i, 32);
+		delay = (guint)MIN(tmp, delay_max);
+	}
+
+	/* so that devices reset at the same time do not all retry in lockstep */
+	if (flags & FU_DEVICE_RETRY_FLAG_JITTER && delay >= 4)
+		delay = delay - (delay / 4) + (guint)g_random_int_range(0, (gint32)(delay / 2) + 1);
+	return delay;
+}
+
+/**
+ * fu_device_retry_backoff:
+ * @self: a #FuDevice
+ * @func: (scope async) (closure user_data): a function to execute
+ * @timeout: the maximum time to keep trying in ms
+ * @delay_min: the initial delay between each try in ms
+ * @delay_max: the maximum delay between each try in ms
+ * @flags: retry flags, e.g. %FU_DEVICE_RETRY_FLAG_BACKOFF
+ * @user_data: (nullable): a helper to pass to @func
+ * @error: (nullable): optional return location for an error
+ *
+ * Calls a specific function until it succeeds or @timeout has elapsed, optionally handling the
+ * error with a reset action.
+ *
+ * This is better than fu_device_retry_full() when waiting for a device that becomes ready after
+ * an unknown amount of time, as the device can be checked frequently at first rather than always
+ * sleeping for the worst-case delay.
+ *
+ * Since: 2.0.0
+ **/
+gboolean
+fu_device_retry_backoff(FuDevice *self,
+			FuDeviceRetryFunc func,
+			guint timeout,
+			guint delay_min,
+			guint delay_max,
+			FuDeviceRetryFlags flags,
+			gpointer user_data,
+			GError **error)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	guint64 delay_total = 0;
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	g_return_val_if_fail(FU_IS_DEVICE(self), FALSE);
+	g_return_val_if_fail(func != NULL, FALSE);
+	g_return_val_if_fail(delay_min <= delay_max, FALSE);
+	g_return_val_if_fail(delay_max < 100000, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	for (guint i = 0;; i++) {
+		guint delay;
+		guint64 elapsed;
+		g_autoptr(GError) error_local = NULL;
+
+		/* run function, if success return success */
+		if (func(self, user_data, &error_local))
+			break;
+
+		/* sanity check */
+		if (error_local == NULL) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "exec failed but no error set!");
+			return FALSE;
+		}
+
+		/* emulated devices do not sleep, so also count the delays */
+		elapsed = MAX((guint64)(g_timer_elapsed(timer, NULL) * 1000), delay_total);
+		if (elapsed >= timeout) {
+			g_propagate_prefixed_error(error,
+						   g_steal_pointer(&error_local),
+						   "failed after %u retries in %ums: ",
+						   i + 1,
+						   (guint)elapsed);
+			return FALSE;
 		}
+
+		/* show recoverable error on the console */
+		if (priv->retry_recs->len == 0) {
+			g_info("failed on try %u: %s", i + 1, error_local->message);
+		} else if (!fu_device_retry_recover(self, &error_local, user_data, error)) {
+			return FALSE;
+		}
+
+		/* do not sleep past the deadline */
+		delay = fu_device_retry_backoff_get_delay(i, delay_min, delay_max, flags);
+		delay = MIN(delay, timeout - elapsed);
+		fu_device_sleep(self, delay);
+		delay_total += delay;
 	}
 
 	/* success */
@@ -887,6 +1013,7 @@ fu_device_sleep(FuDevice *self, guint delay_ms)
 		return;
 	if (delay_ms > 0)
 		g_usleep(delay_ms * 1000);
+	priv->sleep_total += delay_ms;
 }
 
 /**
@@ -915,6 +1042,97 @@ fu_device_sleep_full(FuDevice *self, guint delay_ms, FuProgress *progress)
 		return;
 	if (delay_ms > 0)
 		fu_progress_sleep(progress, delay_ms);
+	priv->sleep_total += delay_ms;
+}
+
+/**
+ * fu_device_wait_readable:
+ * @self: a #FuDevice
+ * @fd: a file descriptor
+ * @timeout: the maximum time to wait in ms
+ * @error: (nullable): optional return location for an error
+ *
+ * Waits for the file descriptor to have data available to read, which should be used rather than
+ * sleeping for the worst-case time the device might take to respond.
+ *
+ * No delay is performed if the device is emulated.
+ *
+ * Returns: %TRUE if @fd is readable, or %FALSE with %FWUPD_ERROR_TIMED_OUT if there is no data
+ *
+ * Since: 2.0.0
+ **/
+gboolean
+fu_device_wait_readable(FuDevice *self, gint fd, guint timeout, GError **error)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	gint rc;
+	GPollFD fds = {
+	    .fd = fd,
+	    .events = G_IO_IN | G_IO_ERR | G_IO_HUP,
+	};
+	g_autoptr(GTimer) timer = NULL;
+
+	g_return_val_if_fail(FU_IS_DEVICE(self), FALSE);
+	g_return_val_if_fail(fd >= 0, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (fu_device_has_flag(self, FWUPD_DEVICE_FLAG_EMULATED))
+		return TRUE;
+	if (priv->proxy != NULL && fu_device_has_flag(priv->proxy, FWUPD_DEVICE_FLAG_EMULATED))
+		return TRUE;
+
+	/* a signal interrupts the wait, so try again for the remaining time */
+	timer = g_timer_new();
+	do {
+		guint elapsed = (guint)(g_timer_elapsed(timer, NULL) * 1000);
+		rc = g_poll(&fds, 1, elapsed < timeout ? (gint)(timeout - elapsed) : 0);
+	} while (rc < 0 && errno == EINTR);
+	priv->sleep_total += (guint64)(g_timer_elapsed(timer, NULL) * 1000);
+	if (rc < 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_READ,
+			    "failed to poll %i: %s",
+			    fd,
+			    g_strerror(errno));
+		return FALSE;
+	}
+	if (rc == 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_TIMED_OUT,
+			    "no data to read after %ums",
+			    timeout);
+		return FALSE;
+	}
+	if ((fds.revents & G_IO_IN) == 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_READ,
+			    "failed to wait for %i: closed or failed",
+			    fd);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/**
+ * fu_device_get_sleep_total:
+ * @self: a #FuDevice
+ *
+ * Gets the total time the device has been delayed using fu_device_sleep(),
+ * fu_device_sleep_full() or fu_device_wait_readable(), which is useful when profiling.
+ *
+ * Returns: time in ms
+ *
+ * Since: 2.0.0
+ **/
+guint64
+fu_device_get_sleep_total(FuDevice *self)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_DEVICE(self), G_MAXUINT64);
+	return priv->sleep_total;
 }
 
 static gboolean
@@ -4136,6 +4354,7 @@ fu_device_to_string_impl(FuDevice *self, guint idt, GString *str)
 	fwupd_codec_string_append(str, idt, "ProxyGuid", priv->proxy_guid);
 	fwupd_codec_string_append_int(str, idt, "RemoveDelay", priv->remove_delay);
 	fwupd_codec_string_append_int(str, idt, "AcquiesceDelay", priv->acquiesce_delay);
+	fwupd_codec_string_append_int(str, idt, "SleepTotal", priv->sleep_total);
 	fwupd_codec_string_append(str, idt, "CustomFlags", priv->custom_flags);
 	if (priv->specialized_gtype != G_TYPE_INVALID)
 		fwupd_codec_string_append(str, idt, "GType", g_type_name(priv->specialized_gtype));
@@ -4443,6 +4662,46 @@ fu_device_write_firmware(FuDevice *self,
 	return TRUE;
 }
 
+/* when the same stream is deployed to many identical devices in one transaction the parsed
+ * firmware is shared, so the payload is only read, checksummed and parsed once -- the stream
+ * address is a cheap key as the cache keeps the stream alive */
+static FuFirmware *
+fu_device_prepare_firmware_gtype(FuDevice *self,
+				 GInputStream *stream,
+				 FwupdInstallFlags flags,
+				 GError **error)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	g_autofree gchar *key = NULL;
+	g_autoptr(FuFirmware) firmware = NULL;
+
+	/* cache disabled */
+	if (priv->ctx == NULL || fu_context_get_firmware_cache_max_age(priv->ctx) == 0) {
+		firmware = g_object_new(priv->firmware_gtype, NULL);
+		if (!fu_firmware_parse_stream(firmware, stream, 0x0, flags, error))
+			return NULL;
+		return g_steal_pointer(&firmware);
+	}
+
+	/* already parsed */
+	key = g_strdup_printf("%s:%p:%" G_GUINT64_FORMAT,
+			      g_type_name(priv->firmware_gtype),
+			      stream,
+			      (guint64)flags);
+	firmware = fu_context_firmware_cache_lookup(priv->ctx, key);
+	if (firmware != NULL) {
+		g_debug("using cached firmware for %s", key);
+		return g_steal_pointer(&firmware);
+	}
+
+	/* parse and save for next time */
+	firmware = g_object_new(priv->firmware_gtype, NULL);
+	if (!fu_firmware_parse_stream(firmware, stream, 0x0, flags, error))
+		return NULL;
+	fu_context_firmware_cache_add(priv->ctx, key, stream, firmware);
+	return g_steal_pointer(&firmware);
+}
+
 /**
  * fu_device_prepare_firmware:
  * @self: a #FuDevice
@@ -4485,8 +4744,8 @@ fu_device_prepare_firmware(FuDevice *self,
 		if (firmware == NULL)
 			return NULL;
 	} else if (priv->firmware_gtype != G_TYPE_INVALID) {
-		firmware = g_object_new(priv->firmware_gtype, NULL);
-		if (!fu_firmware_parse_stream(firmware, stream, 0x0, flags, error))
+		firmware = fu_device_prepare_firmware_gtype(self, stream, flags, error);
+		if (firmware == NULL)
 			return NULL;
 	} else {
 		firmware = fu_firmware_new();
@@ -4611,6 +4870,148 @@ fu_device_dump_firmware(FuDevice *self, FuProgress *progress, GError **error)
 	return device_class->dump_firmware(self, progress, error);
 }
 
+static gboolean
+fu_device_checksum_compute(FuChecksumKind kind,
+			   const guint8 *buf,
+			   gsize bufsz,
+			   guint32 *value,
+			   GError **error)
+{
+	switch (kind) {
+	case FU_CHECKSUM_KIND_CRC8:
+		*value = fu_crc8(buf, bufsz);
+		return TRUE;
+	case FU_CHECKSUM_KIND_CRC16:
+		*value = fu_crc16(buf, bufsz);
+		return TRUE;
+	case FU_CHECKSUM_KIND_CRC32:
+		*value = fu_crc32(buf, bufsz);
+		return TRUE;
+	case FU_CHECKSUM_KIND_SUM8:
+		*value = fu_sum8(buf, bufsz);
+		return TRUE;
+	case FU_CHECKSUM_KIND_SUM16:
+		*value = fu_sum16(buf, bufsz);
+		return TRUE;
+	case FU_CHECKSUM_KIND_SUM32:
+		*value = fu_sum32(buf, bufsz);
+		return TRUE;
+	default:
+		break;
+	}
+	g_set_error(error,
+		    FWUPD_ERROR,
+		    FWUPD_ERROR_NOT_SUPPORTED,
+		    "checksum kind %s not supported",
+		    fu_checksum_kind_to_string(kind));
+	return FALSE;
+}
+
+/**
+ * fu_device_read_checksum:
+ * @self: a #FuDevice
+ * @address: start address
+ * @size: number of bytes
+ * @kind: (out): the #FuChecksumKind used by the device, e.g. %FU_CHECKSUM_KIND_CRC32
+ * @value: (out): the checksum value
+ * @error: (nullable): optional return location for an error
+ *
+ * Asks the device to compute a checksum of a range of the flash by calling a plugin-specific
+ * vfunc. This is typically much quicker than reading the data back over a slow bus.
+ *
+ * Returns: %TRUE on success
+ *
+ * Since: 2.0.0
+ **/
+gboolean
+fu_device_read_checksum(FuDevice *self,
+			gsize address,
+			gsize size,
+			FuChecksumKind *kind,
+			guint32 *value,
+			GError **error)
+{
+	FuDeviceClass *device_class = FU_DEVICE_GET_CLASS(self);
+
+	g_return_val_if_fail(FU_IS_DEVICE(self), FALSE);
+	g_return_val_if_fail(kind != NULL, FALSE);
+	g_return_val_if_fail(value != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* not supported */
+	if (device_class->read_checksum == NULL) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_SUPPORTED,
+				    "reading checksum is not supported by device");
+		return FALSE;
+	}
+
+	/* proxy */
+	*kind = FU_CHECKSUM_KIND_UNKNOWN;
+	if (!device_class->read_checksum(self, address, size, kind, value, error))
+		return FALSE;
+	if (*kind == FU_CHECKSUM_KIND_UNKNOWN) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "checksum kind was not set by device");
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/**
+ * fu_device_verify_checksum:
+ * @self: a #FuDevice
+ * @address: start address
+ * @blob: the expected contents
+ * @error: (nullable): optional return location for an error
+ *
+ * Verifies a range of the flash by asking the device for a checksum and comparing it with the
+ * same checksum computed from @blob.
+ *
+ * If the device does not support reading checksums then %FWUPD_ERROR_NOT_SUPPORTED is returned,
+ * and if the checksum does not match then %FWUPD_ERROR_INVALID_DATA is returned.
+ *
+ * Returns: %TRUE if the checksum matched
+ *
+ * Since: 2.0.0
+ **/
+gboolean
+fu_device_verify_checksum(FuDevice *self, gsize address, GBytes *blob, GError **error)
+{
+	FuChecksumKind kind = FU_CHECKSUM_KIND_UNKNOWN;
+	gsize bufsz = 0;
+	const guint8 *buf;
+	guint32 value = 0;
+	guint32 value_expected = 0;
+
+	g_return_val_if_fail(FU_IS_DEVICE(self), FALSE);
+	g_return_val_if_fail(blob != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	buf = g_bytes_get_data(blob, &bufsz);
+	if (!fu_device_read_checksum(self, address, bufsz, &kind, &value, error))
+		return FALSE;
+	if (!fu_device_checksum_compute(kind, buf, bufsz, &value_expected, error))
+		return FALSE;
+	if (value != value_expected) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "%s checksum invalid at 0x%x, got 0x%08x, expected 0x%08x",
+			    fu_checksum_kind_to_string(kind),
+			    (guint)address,
+			    value,
+			    value_expected);
+		return FALSE;
+	}
+
+	/* success */
+	return TRUE;
+}
+
 /**
  * fu_device_detach:
  * @self: a #FuDevice
@@ -88,6 +88,12 @@ struct _FuDeviceClass {
 	void (*set_progress)(FuDevice *self, FuProgress *progress);
 	void (*invalidate)(FuDevice *self);
 	gchar *(*convert_version)(FuDevice *self, guint64 version_raw);
+	gboolean (*read_checksum)(FuDevice *self,
+				  gsize address,
+				  gsize size,
+				  FuChecksumKind *kind,
+				  guint32 *value,
+				  GError **error) G_GNUC_WARN_UNUSED_RESULT;
 #endif
 };
 
@@ -109,6 +115,24 @@ typedef enum {
 	FU_DEVICE_INSTANCE_FLAG_UNKNOWN = G_MAXUINT64,
 } FuDeviceInstanceFlags;
 
+/**
+ * FuDeviceRetryFlags:
+ * @FU_DEVICE_RETRY_FLAG_NONE:		Use the minimum delay between each try
+ * @FU_DEVICE_RETRY_FLAG_BACKOFF:	Double the delay after each try, up to the maximum
+ * @FU_DEVICE_RETRY_FLAG_FAST_FIRST:	Use the minimum delay for 3 tries, then the maximum
+ * @FU_DEVICE_RETRY_FLAG_JITTER:	Randomize each delay by up to 25%
+ *
+ * The flags to use when retrying with fu_device_retry_backoff().
+ **/
+typedef enum {
+	FU_DEVICE_RETRY_FLAG_NONE = 0,
+	FU_DEVICE_RETRY_FLAG_BACKOFF = 1 << 0,
+	FU_DEVICE_RETRY_FLAG_FAST_FIRST = 1 << 1,
+	FU_DEVICE_RETRY_FLAG_JITTER = 1 << 2,
+	/*< private >*/
+	FU_DEVICE_RETRY_FLAG_UNKNOWN = G_MAXUINT64,
+} FuDeviceRetryFlags;
+
 /**
  * FU_DEVICE_REMOVE_DELAY_RE_ENUMERATE:
  *
@@ -805,6 +829,16 @@ fu_device_dump_firmware(FuDevice *self,
 			FuProgress *progress,
 			GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1, 2);
 gboolean
+fu_device_read_checksum(FuDevice *self,
+			gsize address,
+			gsize size,
+			FuChecksumKind *kind,
+			guint32 *value,
+			GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1, 4, 5);
+gboolean
+fu_device_verify_checksum(FuDevice *self, gsize address, GBytes *blob, GError **error)
+    G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1, 3);
+gboolean
 fu_device_attach(FuDevice *self, GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1);
 gboolean
 fu_device_detach(FuDevice *self, GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1);
@@ -868,11 +902,25 @@ fu_device_retry_full(FuDevice *self,
 		     guint delay,
 		     gpointer user_data,
 		     GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1);
+gboolean
+fu_device_retry_backoff(FuDevice *self,
+			FuDeviceRetryFunc func,
+			guint timeout,
+			guint delay_min,
+			guint delay_max,
+			FuDeviceRetryFlags flags,
+			gpointer user_data,
+			GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1);
 void
 fu_device_sleep(FuDevice *self, guint delay_ms) G_GNUC_NON_NULL(1);
 void
 fu_device_sleep_full(FuDevice *self, guint delay_ms, FuProgress *progress) G_GNUC_NON_NULL(1);
 gboolean
+fu_device_wait_readable(FuDevice *self, gint fd, guint timeout, GError **error)
+    G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1);
+guint64
+fu_device_get_sleep_total(FuDevice *self) G_GNUC_NON_NULL(1);
+gboolean
 fu_device_bind_driver(FuDevice *self, const gchar *subsystem, const gchar *driver, GError **error)
     G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1);
 gboolean
@@ -52,12 +52,14 @@ G_DEFINE_TYPE(FuEfiLz77Decompressor, fu_efi_lz77_decompressor, FU_TYPE_FIRMWARE)
 #endif
 
 typedef struct {
-	GInputStream *stream; /* no-ref */
-	GByteArray *dst;      /* no-ref */
+	const guint8 *src; /* no-ref */
+	gsize src_bufsz;
+	gsize src_offset;
+	GByteArray *dst; /* no-ref */
 
-	guint16 bit_count;
 	guint32 bit_buf;
-	guint32 sub_bit_buf;
+	guint64 bit_res; /* reservoir of the next bits, MSB first */
+	guint8 bit_res_count;
 	guint16 block_size;
 
 	guint16 left[2 * NC - 1];
@@ -84,39 +86,35 @@ fu_efi_lz77_decompressor_read_source_bits(FuEfiLz77DecompressHelper *helper,
 					  guint16 number_of_bits,
 					  GError **error)
 {
-	/* left shift number_of_bits of bits in advance */
-	helper->bit_buf = (guint32)(((guint64)helper->bit_buf) << number_of_bits);
-
-	/* copy data needed in bytes into sub_bit_buf */
-	while (number_of_bits > helper->bit_count) {
-		gssize rc;
-		guint8 sub_bit_buf = 0;
-
-		number_of_bits = (guint16)(number_of_bits - helper->bit_count);
-		helper->bit_buf |= (guint32)(((guint64)helper->sub_bit_buf) << number_of_bits);
-
-		/* get 1 byte into sub_bit_buf */
-		rc = g_input_stream_read(helper->stream,
-					 &sub_bit_buf,
-					 sizeof(sub_bit_buf),
-					 NULL,
-					 error);
-		if (rc < 0)
-			return FALSE;
-		if (rc == 0) {
-			/* no more bits from the source, just pad zero bit */
-			helper->sub_bit_buf = 0;
-		} else {
-			helper->sub_bit_buf = sub_bit_buf;
-		}
-		helper->bit_count = 8;
+	guint64 bits;
+
+	if (number_of_bits == 0)
+		return TRUE;
+	if (number_of_bits > BITBUFSIZ) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "cannot read %u bits",
+			    number_of_bits);
+		return FALSE;
 	}
 
-	/* calculate additional bit count read to update bit_count */
-	helper->bit_count = (guint16)(helper->bit_count - number_of_bits);
+	/* refill the reservoir a byte at a time from memory, padding with zero bits */
+	if (number_of_bits > helper->bit_res_count) {
+		while (helper->bit_res_count <= 64 - 8) {
+			guint8 tmp = 0;
+			if (helper->src_offset < helper->src_bufsz)
+				tmp = helper->src[helper->src_offset++];
+			helper->bit_res |= ((guint64)tmp) << (64 - 8 - helper->bit_res_count);
+			helper->bit_res_count += 8;
+		}
+	}
 
-	/* copy number_of_bits of bits from sub_bit_buf into bit_buf */
-	helper->bit_buf |= helper->sub_bit_buf >> helper->bit_count;
+	/* shift number_of_bits of bits from the reservoir into bit_buf */
+	bits = helper->bit_res >> (64 - number_of_bits);
+	helper->bit_res <<= number_of_bits;
+	helper->bit_res_count -= number_of_bits;
+	helper->bit_buf = (guint32)((((guint64)helper->bit_buf) << number_of_bits) | bits);
 	return TRUE;
 }
 
@@ -552,24 +550,30 @@ fu_efi_lz77_decompressor_internal(FuEfiLz77DecompressHelper *helper,
 			data_offset = dst_offset - tmp - 1;
 
 			/* write bytes_remaining of bytes into dst_buf */
-			bytes_remaining--;
-			while ((gint16)(bytes_remaining) >= 0) {
-				if (dst_offset >= helper->dst->len) {
-					g_set_error_literal(error,
-							    FWUPD_ERROR,
-							    FWUPD_ERROR_INVALID_DATA,
-							    "bad pointer offset");
-					return FALSE;
-				}
-				if (data_offset >= helper->dst->len) {
-					g_set_error_literal(error,
-							    FWUPD_ERROR,
-							    FWUPD_ERROR_INVALID_DATA,
-							    "bad table");
-					return FALSE;
-				}
-				helper->dst->data[dst_offset++] = helper->dst->data[data_offset++];
-				bytes_remaining--;
+			if (bytes_remaining > helper->dst->len - dst_offset) {
+				g_set_error_literal(error,
+						    FWUPD_ERROR,
+						    FWUPD_ERROR_INVALID_DATA,
+						    "bad pointer offset");
+				return FALSE;
+			}
+			if (data_offset >= dst_offset) {
+				g_set_error_literal(error,
+						    FWUPD_ERROR,
+						    FWUPD_ERROR_INVALID_DATA,
+						    "bad table");
+				return FALSE;
+			}
+			if (dst_offset - data_offset >= bytes_remaining) {
+				memcpy(helper->dst->data + dst_offset,
+				       helper->dst->data + data_offset,
+				       bytes_remaining);
+				dst_offset += bytes_remaining;
+			} else {
+				/* overlapping, so repeat the pattern */
+				for (guint16 j = 0; j < bytes_remaining; j++)
+					helper->dst->data[dst_offset++] =
+					    helper->dst->data[data_offset++];
 			}
 		}
 	}
@@ -589,6 +593,7 @@ fu_efi_lz77_decompressor_parse(FuFirmware *firmware,
 	guint32 dst_bufsz;
 	guint32 src_bufsz;
 	g_autoptr(GByteArray) st = NULL;
+	g_autoptr(GBytes) src = NULL;
 	g_autoptr(GError) error_all = NULL;
 	g_autoptr(GByteArray) dst = g_byte_array_new();
 	FuEfiLz77DecompressorVersion decompressor_versions[] = {
@@ -603,7 +608,7 @@ fu_efi_lz77_decompressor_parse(FuFirmware *firmware,
 	if (st == NULL)
 		return FALSE;
 	src_bufsz = fu_struct_efi_lz77_decompressor_header_get_src_size(st);
-	if (streamsz - offset < src_bufsz + st->len) {
+	if ((gsize)src_bufsz > streamsz - offset - st->len) {
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_DATA,
@@ -631,16 +636,24 @@ fu_efi_lz77_decompressor_parse(FuFirmware *firmware,
 	}
 	fu_byte_array_set_size(dst, dst_bufsz, 0x0);
 
+	/* decoding reads the source a few bits at a time, so do this from memory */
+	if (src_bufsz > 0) {
+		src = fu_input_stream_read_bytes(stream, offset + st->len, src_bufsz, error);
+		if (src == NULL)
+			return FALSE;
+	} else {
+		src = g_bytes_new(NULL, 0);
+	}
+
 	/* try both position */
 	for (guint i = 0; i < G_N_ELEMENTS(decompressor_versions); i++) {
 		FuEfiLz77DecompressHelper helper = {
 		    .dst = dst,
-		    .stream = stream,
+		    .src = g_bytes_get_data(src, NULL),
+		    .src_bufsz = g_bytes_get_size(src),
 		};
 		g_autoptr(GError) error_local = NULL;
 
-		if (!g_seekable_seek(G_SEEKABLE(stream), offset + st->len, G_SEEK_SET, NULL, error))
-			return FALSE;
 		if (fu_efi_lz77_decompressor_internal(&helper,
 						      decompressor_versions[i],
 						      &error_local)) {
@@ -80,19 +80,21 @@ fu_efi_section_parse_lzma_sections(FuEfiSection *self,
 				   FwupdInstallFlags flags,
 				   GError **error)
 {
-	g_autoptr(GBytes) blob = NULL;
 	g_autoptr(GBytes) blob_uncomp = NULL;
+	g_autoptr(GInputStream) stream_lzma = NULL;
 	g_autoptr(GInputStream) stream_uncomp = NULL;
 
-	/* parse all sections */
-	blob = fu_input_stream_read_bytes(stream, 0, G_MAXSIZE, error);
-	if (blob == NULL)
+	/* decompress directly from the stream, as sections need to be seekable */
+	stream_lzma = fu_lzma_decompress_stream(stream, error);
+	if (stream_lzma == NULL)
 		return FALSE;
-	blob_uncomp = fu_lzma_decompress_bytes(blob, error);
+	blob_uncomp = fu_input_stream_read_bytes(stream_lzma, 0x0, G_MAXSIZE, error);
 	if (blob_uncomp == NULL) {
 		g_prefix_error(error, "failed to decompress: ");
 		return FALSE;
 	}
+
+	/* parse all sections */
 	stream_uncomp = g_memory_input_stream_new_from_bytes(blob_uncomp);
 	if (!fu_efi_parse_sections(FU_FIRMWARE(self), stream_uncomp, 0, flags, error)) {
 		g_prefix_error(error, "failed to parse sections: ");
@@ -170,6 +170,14 @@ typedef enum {
 	 * Since: 1.9.20
 	 **/
 	FU_FIRMWARE_FLAG_HAS_CHECK_COMPATIBLE = 1u << 8,
+	/**
+	 * FU_FIRMWARE_FLAG_PARSE_PARALLEL:
+	 *
+	 * Independent child images may be parsed on more than one thread.
+	 *
+	 * Since: 2.0.0
+	 **/
+	FU_FIRMWARE_FLAG_PARSE_PARALLEL = 1u << 9,
 	/**
 	 * FU_FIRMWARE_FLAG_UNKNOWN:
 	 *
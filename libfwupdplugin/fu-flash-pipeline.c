@@ -0,0 +1,558 @@
+/*
+ * Copyright 2024 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#define G_LOG_DOMAIN "FuFlashPipeline"
+
+#include "config.h"
+
+#include <string.h>
+
+#include "fu-bytes.h"
+#include "fu-chunk-array.h"
+#include "fu-crc.h"
+#include "fu-flash-pipeline.h"
+#include "fu-mem.h"
+
+/**
+ * FuFlashPipeline:
+ *
+ * A reusable erase, program and verify loop for devices with sector-based flash.
+ *
+ * The device supplies the flash geometry and the primitive operations, and the pipeline skips
+ * the sectors that are already correct, does not program pages that are blank after an erase,
+ * and only verifies the sectors that were written -- using a device-side checksum if possible.
+ *
+ * See also: [class@FuChunkArray]
+ */
+
+struct _FuFlashPipeline {
+	GObject parent_instance;
+	FuDevice *device;
+	FuFlashPipelineFlags flags;
+	guint32 address;
+	guint32 sector_size;
+	guint32 page_size;
+	gpointer user_data;
+	FuFlashPipelineEraseFunc erase_func;
+	FuFlashPipelineWriteFunc write_func;
+	FuFlashPipelineReadFunc read_func;
+	FuFlashPipelineChecksumFunc checksum_func;
+	guint pages_skipped;
+	gdouble erase_secs;
+	gdouble write_secs;
+	gdouble read_secs;
+	gdouble verify_secs;
+};
+
+G_DEFINE_TYPE(FuFlashPipeline, fu_flash_pipeline, G_TYPE_OBJECT)
+
+/**
+ * fu_flash_pipeline_add_flag:
+ * @self: a #FuFlashPipeline
+ * @flag: the #FuFlashPipelineFlags, e.g. %FU_FLASH_PIPELINE_FLAG_VERIFY
+ *
+ * Adds a flag that changes how the flash is written.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_flash_pipeline_add_flag(FuFlashPipeline *self, FuFlashPipelineFlags flag)
+{
+	g_return_if_fail(FU_IS_FLASH_PIPELINE(self));
+	self->flags |= flag;
+}
+
+/**
+ * fu_flash_pipeline_set_address:
+ * @self: a #FuFlashPipeline
+ * @address: the address of the first byte of the image
+ *
+ * Sets the flash address the image is written to, which defaults to zero.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_flash_pipeline_set_address(FuFlashPipeline *self, guint32 address)
+{
+	g_return_if_fail(FU_IS_FLASH_PIPELINE(self));
+	self->address = address;
+}
+
+/**
+ * fu_flash_pipeline_set_sector_size:
+ * @self: a #FuFlashPipeline
+ * @sector_size: the erase size in bytes
+ *
+ * Sets the smallest size that can be erased.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_flash_pipeline_set_sector_size(FuFlashPipeline *self, guint32 sector_size)
+{
+	g_return_if_fail(FU_IS_FLASH_PIPELINE(self));
+	self->sector_size = sector_size;
+}
+
+/**
+ * fu_flash_pipeline_set_page_size:
+ * @self: a #FuFlashPipeline
+ * @page_size: the program size in bytes
+ *
+ * Sets the largest size that can be programmed at once, which defaults to the sector size.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_flash_pipeline_set_page_size(FuFlashPipeline *self, guint32 page_size)
+{
+	g_return_if_fail(FU_IS_FLASH_PIPELINE(self));
+	self->page_size = page_size;
+}
+
+/**
+ * fu_flash_pipeline_set_user_data:
+ * @self: a #FuFlashPipeline
+ * @user_data: (nullable): user data passed to each function
+ *
+ * Sets the user data used for each of the device functions.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_flash_pipeline_set_user_data(FuFlashPipeline *self, gpointer user_data)
+{
+	g_return_if_fail(FU_IS_FLASH_PIPELINE(self));
+	self->user_data = user_data;
+}
+
+/**
+ * fu_flash_pipeline_set_erase_func:
+ * @self: a #FuFlashPipeline
+ * @func: (nullable): a #FuFlashPipelineEraseFunc
+ *
+ * Sets the function used to erase a sector. If unset, the flash is assumed to not need an erase.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_flash_pipeline_set_erase_func(FuFlashPipeline *self, FuFlashPipelineEraseFunc func)
+{
+	g_return_if_fail(FU_IS_FLASH_PIPELINE(self));
+	self->erase_func = func;
+}
+
+/**
+ * fu_flash_pipeline_set_write_func:
+ * @self: a #FuFlashPipeline
+ * @func: a #FuFlashPipelineWriteFunc
+ *
+ * Sets the function used to program a page.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_flash_pipeline_set_write_func(FuFlashPipeline *self, FuFlashPipelineWriteFunc func)
+{
+	g_return_if_fail(FU_IS_FLASH_PIPELINE(self));
+	self->write_func = func;
+}
+
+/**
+ * fu_flash_pipeline_set_read_func:
+ * @self: a #FuFlashPipeline
+ * @func: (nullable): a #FuFlashPipelineReadFunc
+ *
+ * Sets the function used to read back the flash contents.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_flash_pipeline_set_read_func(FuFlashPipeline *self, FuFlashPipelineReadFunc func)
+{
+	g_return_if_fail(FU_IS_FLASH_PIPELINE(self));
+	self->read_func = func;
+}
+
+/**
+ * fu_flash_pipeline_set_checksum_func:
+ * @self: a #FuFlashPipeline
+ * @func: (nullable): a #FuFlashPipelineChecksumFunc
+ *
+ * Sets the function used to ask the device for a checksum, which is used in preference to
+ * reading back the flash contents when verifying.
+ *
+ * If not set then the device `->read_checksum()` vfunc is used if implemented.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_flash_pipeline_set_checksum_func(FuFlashPipeline *self, FuFlashPipelineChecksumFunc func)
+{
+	g_return_if_fail(FU_IS_FLASH_PIPELINE(self));
+	self->checksum_func = func;
+}
+
+static gboolean
+fu_flash_pipeline_read(FuFlashPipeline *self,
+		       gsize address,
+		       guint8 *buf,
+		       gsize bufsz,
+		       GError **error)
+{
+	g_autoptr(GTimer) timer = g_timer_new();
+	if (!self->read_func(self->device, address, buf, bufsz, self->user_data, error)) {
+		g_prefix_error(error, "failed to read at 0x%x: ", (guint)address);
+		return FALSE;
+	}
+	self->read_secs += g_timer_elapsed(timer, NULL);
+	return TRUE;
+}
+
+static gboolean
+fu_flash_pipeline_sector_is_unchanged(FuFlashPipeline *self,
+				      FuChunk *chk,
+				      gboolean *unchanged,
+				      GError **error)
+{
+	g_autofree guint8 *buf = g_malloc0(fu_chunk_get_data_sz(chk));
+
+	if (!fu_flash_pipeline_read(self,
+				    fu_chunk_get_address(chk),
+				    buf,
+				    fu_chunk_get_data_sz(chk),
+				    error))
+		return FALSE;
+	*unchanged = memcmp(buf, fu_chunk_get_data(chk), fu_chunk_get_data_sz(chk)) == 0;
+	return TRUE;
+}
+
+static gboolean
+fu_flash_pipeline_write_sector(FuFlashPipeline *self,
+			       FuChunk *chk,
+			       gboolean *written,
+			       GError **error)
+{
+	guint32 page_size = self->page_size != 0 ? self->page_size : self->sector_size;
+	g_autoptr(FuChunkArray) pages = NULL;
+	g_autoptr(GBytes) blob = fu_chunk_get_bytes(chk);
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	/* already correct */
+	if (self->flags & FU_FLASH_PIPELINE_FLAG_SKIP_UNCHANGED && self->read_func != NULL) {
+		gboolean unchanged = FALSE;
+		if (!fu_flash_pipeline_sector_is_unchanged(self, chk, &unchanged, error))
+			return FALSE;
+		if (unchanged) {
+			*written = FALSE;
+			return TRUE;
+		}
+	}
+
+	/* erase */
+	if (self->erase_func != NULL) {
+		g_timer_start(timer);
+		if (!self->erase_func(self->device,
+				      fu_chunk_get_address(chk),
+				      fu_chunk_get_data_sz(chk),
+				      self->user_data,
+				      error)) {
+			g_prefix_error(error,
+				       "failed to erase at 0x%x: ",
+				       (guint)fu_chunk_get_address(chk));
+			return FALSE;
+		}
+		self->erase_secs += g_timer_elapsed(timer, NULL);
+	}
+
+	/* program each page */
+	g_timer_start(timer);
+	pages = fu_chunk_array_new_from_bytes(blob, fu_chunk_get_address(chk), page_size);
+	for (guint i = 0; i < fu_chunk_array_length(pages); i++) {
+		g_autoptr(FuChunk) page = fu_chunk_array_index(pages, i, error);
+		if (page == NULL)
+			return FALSE;
+
+		/* erased flash is already all 0xFF */
+		if (self->flags & FU_FLASH_PIPELINE_FLAG_SKIP_BLANK && self->erase_func != NULL) {
+			g_autoptr(GBytes) blob_page = fu_chunk_get_bytes(page);
+			if (fu_bytes_is_empty(blob_page)) {
+				self->pages_skipped++;
+				continue;
+			}
+		}
+		if (!self->write_func(self->device, page, self->user_data, error)) {
+			g_prefix_error(error,
+				       "failed to write at 0x%x: ",
+				       (guint)fu_chunk_get_address(page));
+			return FALSE;
+		}
+	}
+	self->write_secs += g_timer_elapsed(timer, NULL);
+
+	/* success */
+	*written = TRUE;
+	return TRUE;
+}
+
+static gboolean
+fu_flash_pipeline_verify_sector(FuFlashPipeline *self, FuChunk *chk, GError **error)
+{
+	g_autofree guint8 *buf = NULL;
+
+	/* ask the device, which is much quicker than reading it back */
+	if (self->checksum_func != NULL) {
+		guint32 crc = 0;
+		guint32 crc_expected = fu_crc32(fu_chunk_get_data(chk), fu_chunk_get_data_sz(chk));
+		if (!self->checksum_func(self->device,
+					 fu_chunk_get_address(chk),
+					 fu_chunk_get_data_sz(chk),
+					 &crc,
+					 self->user_data,
+					 error)) {
+			g_prefix_error(error,
+				       "failed to get checksum at 0x%x: ",
+				       (guint)fu_chunk_get_address(chk));
+			return FALSE;
+		}
+		if (crc == crc_expected)
+			return TRUE;
+		if (self->read_func == NULL) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "checksum invalid at 0x%x, got 0x%08x, expected 0x%08x",
+				    (guint)fu_chunk_get_address(chk),
+				    crc,
+				    crc_expected);
+			return FALSE;
+		}
+		g_debug("checksum invalid at 0x%x, reading back", (guint)fu_chunk_get_address(chk));
+	} else if (FU_DEVICE_GET_CLASS(self->device)->read_checksum != NULL) {
+		g_autoptr(GBytes) blob = fu_chunk_get_bytes(chk);
+		g_autoptr(GError) error_local = NULL;
+		if (fu_device_verify_checksum(self->device,
+					      fu_chunk_get_address(chk),
+					      blob,
+					      &error_local))
+			return TRUE;
+		if (!g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED) &&
+		    !g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_INVALID_DATA)) {
+			g_propagate_error(error, g_steal_pointer(&error_local));
+			return FALSE;
+		}
+		if (self->read_func == NULL) {
+			g_propagate_prefixed_error(error,
+						   g_steal_pointer(&error_local),
+						   "failed to verify at 0x%x: ",
+						   (guint)fu_chunk_get_address(chk));
+			return FALSE;
+		}
+		g_debug("%s, reading back", error_local->message);
+	}
+
+	/* read back and compare, which also shows where it is different */
+	buf = g_malloc0(fu_chunk_get_data_sz(chk));
+	if (!fu_flash_pipeline_read(self,
+				    fu_chunk_get_address(chk),
+				    buf,
+				    fu_chunk_get_data_sz(chk),
+				    error))
+		return FALSE;
+	if (!fu_memcmp_safe(buf,
+			    fu_chunk_get_data_sz(chk),
+			    0x0,
+			    fu_chunk_get_data(chk),
+			    fu_chunk_get_data_sz(chk),
+			    0x0,
+			    fu_chunk_get_data_sz(chk),
+			    error)) {
+		g_prefix_error(error,
+			       "failed to verify at 0x%x: ",
+			       (guint)fu_chunk_get_address(chk));
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_flash_pipeline_verify(FuFlashPipeline *self,
+			 GPtrArray *chunks,
+			 FuProgress *progress,
+			 GError **error)
+{
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_set_steps(progress, chunks->len);
+	for (guint i = 0; i < chunks->len; i++) {
+		FuChunk *chk = g_ptr_array_index(chunks, i);
+		if (!fu_flash_pipeline_verify_sector(self, chk, error))
+			return FALSE;
+		fu_progress_step_done(progress);
+	}
+	self->verify_secs += g_timer_elapsed(timer, NULL);
+	return TRUE;
+}
+
+/**
+ * fu_flash_pipeline_write:
+ * @self: a #FuFlashPipeline
+ * @stream: a #GInputStream
+ * @progress: a #FuProgress
+ * @error: (nullable): optional return location for an error
+ *
+ * Writes the image to the flash one sector at a time, erasing each sector first if required.
+ *
+ * If %FU_FLASH_PIPELINE_FLAG_VERIFY is set then each sector that was written is verified
+ * afterwards, using the checksum function or device vfunc if available, and otherwise by reading
+ * back the contents. If the device cannot checksum a sector and there is no read function then
+ * %FWUPD_ERROR_NOT_SUPPORTED is returned.
+ *
+ * Returns: %TRUE on success
+ *
+ * Since: 2.0.0
+ **/
+gboolean
+fu_flash_pipeline_write(FuFlashPipeline *self,
+			GInputStream *stream,
+			FuProgress *progress,
+			GError **error)
+{
+	gboolean verify = FALSE;
+	g_autoptr(FuChunkArray) chunks = NULL;
+	g_autoptr(GPtrArray) chunks_written = g_ptr_array_new_with_free_func(g_object_unref);
+
+	g_return_val_if_fail(FU_IS_FLASH_PIPELINE(self), FALSE);
+	g_return_val_if_fail(G_IS_INPUT_STREAM(stream), FALSE);
+	g_return_val_if_fail(FU_IS_PROGRESS(progress), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* sanity check */
+	if (self->write_func == NULL || self->sector_size == 0) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_SUPPORTED,
+				    "write function and sector size required");
+		return FALSE;
+	}
+	if (self->address % self->sector_size != 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "address 0x%x is not aligned to the sector size 0x%x",
+			    (guint)self->address,
+			    (guint)self->sector_size);
+		return FALSE;
+	}
+
+	if (self->flags & FU_FLASH_PIPELINE_FLAG_VERIFY) {
+		if (self->checksum_func == NULL && self->read_func == NULL &&
+		    FU_DEVICE_GET_CLASS(self->device)->read_checksum == NULL) {
+			g_set_error_literal(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_NOT_SUPPORTED,
+					    "verify requires a checksum or read function");
+			return FALSE;
+		}
+		verify = TRUE;
+	}
+
+	/* reset the statistics from any previous write */
+	self->pages_skipped = 0;
+	self->erase_secs = 0.f;
+	self->write_secs = 0.f;
+	self->read_secs = 0.f;
+	self->verify_secs = 0.f;
+
+	/* progress */
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, verify ? 90 : 100, NULL);
+	if (verify)
+		fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_VERIFY, 10, NULL);
+
+	/* erase and program each sector */
+	chunks = fu_chunk_array_new_from_stream(stream, self->address, self->sector_size, error);
+	if (chunks == NULL)
+		return FALSE;
+	fu_progress_set_steps(fu_progress_get_child(progress), fu_chunk_array_length(chunks));
+	for (guint i = 0; i < fu_chunk_array_length(chunks); i++) {
+		gboolean written = FALSE;
+		g_autoptr(FuChunk) chk = fu_chunk_array_index(chunks, i, error);
+		if (chk == NULL)
+			return FALSE;
+		if (!fu_flash_pipeline_write_sector(self, chk, &written, error))
+			return FALSE;
+		if (written)
+			g_ptr_array_add(chunks_written, g_steal_pointer(&chk));
+		fu_progress_step_done(fu_progress_get_child(progress));
+	}
+	fu_progress_step_done(progress);
+
+	/* only the sectors that were written need verifying */
+	if (verify) {
+		if (!fu_flash_pipeline_verify(self,
+					      chunks_written,
+					      fu_progress_get_child(progress),
+					      error))
+			return FALSE;
+		fu_progress_step_done(progress);
+	}
+
+	/* timing */
+	g_debug("wrote %u of %u sectors, skipping %u blank pages: "
+		"erase %.0fms, write %.0fms, read %.0fms, verify %.0fms",
+		chunks_written->len,
+		fu_chunk_array_length(chunks),
+		self->pages_skipped,
+		self->erase_secs * 1000.f,
+		self->write_secs * 1000.f,
+		self->read_secs * 1000.f,
+		self->verify_secs * 1000.f);
+
+	/* success */
+	return TRUE;
+}
+
+static void
+fu_flash_pipeline_init(FuFlashPipeline *self)
+{
+}
+
+static void
+fu_flash_pipeline_finalize(GObject *object)
+{
+	FuFlashPipeline *self = FU_FLASH_PIPELINE(object);
+	g_object_unref(self->device);
+	G_OBJECT_CLASS(fu_flash_pipeline_parent_class)->finalize(object);
+}
+
+static void
+fu_flash_pipeline_class_init(FuFlashPipelineClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+	object_class->finalize = fu_flash_pipeline_finalize;
+}
+
+/**
+ * fu_flash_pipeline_new:
+ * @device: a #FuDevice
+ *
+ * Creates a new flash pipeline for a device.
+ *
+ * Returns: (transfer full): a #FuFlashPipeline
+ *
+ * Since: 2.0.0
+ **/
+FuFlashPipeline *
+fu_flash_pipeline_new(FuDevice *device)
+{
+	FuFlashPipeline *self;
+	g_return_val_if_fail(FU_IS_DEVICE(device), NULL);
+	self = g_object_new(FU_TYPE_FLASH_PIPELINE, NULL);
+	self->device = g_object_ref(device);
+	return self;
+}
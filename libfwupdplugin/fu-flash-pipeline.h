@@ -0,0 +1,133 @@
+/*
+ * Copyright 2024 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#pragma once
+
+#include "fu-chunk.h"
+#include "fu-device.h"
+
+#define FU_TYPE_FLASH_PIPELINE (fu_flash_pipeline_get_type())
+G_DECLARE_FINAL_TYPE(FuFlashPipeline, fu_flash_pipeline, FU, FLASH_PIPELINE, GObject)
+
+/**
+ * FuFlashPipelineFlags:
+ * @FU_FLASH_PIPELINE_FLAG_NONE:		No flags set
+ * @FU_FLASH_PIPELINE_FLAG_SKIP_UNCHANGED:	Skip sectors that are already correct
+ * @FU_FLASH_PIPELINE_FLAG_SKIP_BLANK:		Do not program blank pages after erase
+ * @FU_FLASH_PIPELINE_FLAG_VERIFY:		Verify the sectors that were written
+ *
+ * Flags used when writing with a #FuFlashPipeline.
+ **/
+typedef enum {
+	FU_FLASH_PIPELINE_FLAG_NONE = 0,
+	FU_FLASH_PIPELINE_FLAG_SKIP_UNCHANGED = 1 << 0,
+	FU_FLASH_PIPELINE_FLAG_SKIP_BLANK = 1 << 1,
+	FU_FLASH_PIPELINE_FLAG_VERIFY = 1 << 2,
+	/*< private >*/
+	FU_FLASH_PIPELINE_FLAG_LAST
+} FuFlashPipelineFlags;
+
+/**
+ * FuFlashPipelineEraseFunc:
+ * @device: a #FuDevice
+ * @address: sector address
+ * @size: sector size
+ * @user_data: (closure): user data
+ * @error: (nullable): optional return location for an error
+ *
+ * Erases one sector of the flash.
+ *
+ * Returns: %TRUE on success
+ */
+typedef gboolean (*FuFlashPipelineEraseFunc)(FuDevice *device,
+					     gsize address,
+					     gsize size,
+					     gpointer user_data,
+					     GError **error);
+/**
+ * FuFlashPipelineWriteFunc:
+ * @device: a #FuDevice
+ * @chk: a #FuChunk of at most the page size
+ * @user_data: (closure): user data
+ * @error: (nullable): optional return location for an error
+ *
+ * Programs one page of the flash.
+ *
+ * Returns: %TRUE on success
+ */
+typedef gboolean (*FuFlashPipelineWriteFunc)(FuDevice *device,
+					     FuChunk *chk,
+					     gpointer user_data,
+					     GError **error);
+/**
+ * FuFlashPipelineReadFunc:
+ * @device: a #FuDevice
+ * @address: start address
+ * @buf: buffer to read into
+ * @bufsz: size of @buf
+ * @user_data: (closure): user data
+ * @error: (nullable): optional return location for an error
+ *
+ * Reads data from the flash.
+ *
+ * Returns: %TRUE on success
+ */
+typedef gboolean (*FuFlashPipelineReadFunc)(FuDevice *device,
+					    gsize address,
+					    guint8 *buf,
+					    gsize bufsz,
+					    gpointer user_data,
+					    GError **error);
+/**
+ * FuFlashPipelineChecksumFunc:
+ * @device: a #FuDevice
+ * @address: start address
+ * @size: number of bytes
+ * @crc: (out): the CRC-32 of the range, as computed by fu_crc32()
+ * @user_data: (closure): user data
+ * @error: (nullable): optional return location for an error
+ *
+ * Asks the device to compute a checksum of a range of the flash.
+ *
+ * Returns: %TRUE on success
+ */
+typedef gboolean (*FuFlashPipelineChecksumFunc)(FuDevice *device,
+						gsize address,
+						gsize size,
+						guint32 *crc,
+						gpointer user_data,
+						GError **error);
+
+FuFlashPipeline *
+fu_flash_pipeline_new(FuDevice *device) G_GNUC_NON_NULL(1);
+void
+fu_flash_pipeline_add_flag(FuFlashPipeline *self, FuFlashPipelineFlags flag) G_GNUC_NON_NULL(1);
+void
+fu_flash_pipeline_set_address(FuFlashPipeline *self, guint32 address) G_GNUC_NON_NULL(1);
+void
+fu_flash_pipeline_set_sector_size(FuFlashPipeline *self, guint32 sector_size)
+    G_GNUC_NON_NULL(1);
+void
+fu_flash_pipeline_set_page_size(FuFlashPipeline *self, guint32 page_size) G_GNUC_NON_NULL(1);
+void
+fu_flash_pipeline_set_user_data(FuFlashPipeline *self, gpointer user_data) G_GNUC_NON_NULL(1);
+void
+fu_flash_pipeline_set_erase_func(FuFlashPipeline *self, FuFlashPipelineEraseFunc func)
+    G_GNUC_NON_NULL(1);
+void
+fu_flash_pipeline_set_write_func(FuFlashPipeline *self, FuFlashPipelineWriteFunc func)
+    G_GNUC_NON_NULL(1);
+void
+fu_flash_pipeline_set_read_func(FuFlashPipeline *self, FuFlashPipelineReadFunc func)
+    G_GNUC_NON_NULL(1);
+void
+fu_flash_pipeline_set_checksum_func(FuFlashPipeline *self, FuFlashPipelineChecksumFunc func)
+    G_GNUC_NON_NULL(1);
+gboolean
+fu_flash_pipeline_write(FuFlashPipeline *self,
+			GInputStream *stream,
+			FuProgress *progress,
+			GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1, 2, 3);
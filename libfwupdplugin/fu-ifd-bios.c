@@ -10,6 +10,7 @@
 
 #include "fu-bytes.h"
 #include "fu-common.h"
+#include "fu-efi-struct.h"
 #include "fu-efi-volume.h"
 #include "fu-ifd-bios.h"
 #include "fu-input-stream.h"
@@ -27,22 +28,89 @@ G_DEFINE_TYPE(FuIfdBios, fu_ifd_bios, FU_TYPE_IFD_IMAGE)
 
 #define FU_IFD_BIOS_FIT_SIGNATURE 0x5449465F
 
-static gboolean
-fu_ifd_bios_parse(FuFirmware *firmware,
-		  GInputStream *stream,
-		  gsize offset,
-		  FwupdInstallFlags flags,
-		  GError **error)
+typedef struct {
+	GBytes *blob; /* from the volume offset to the end of the region */
+	gsize offset;
+	FwupdInstallFlags flags;
+	FuFirmware *firmware;
+	GError *error;
+} FuIfdBiosVolumeHelper;
+
+static void
+fu_ifd_bios_volume_helper_free(FuIfdBiosVolumeHelper *helper)
 {
-	gsize streamsz = 0;
-	guint img_cnt = 0;
+	if (helper->blob != NULL)
+		g_bytes_unref(helper->blob);
+	if (helper->firmware != NULL)
+		g_object_unref(helper->firmware);
+	if (helper->error != NULL)
+		g_error_free(helper->error);
+	g_free(helper);
+}
 
-	/* get size */
-	if (!fu_input_stream_size(stream, &streamsz, error))
-		return FALSE;
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuIfdBiosVolumeHelper, fu_ifd_bios_volume_helper_free)
+
+/* runs on a worker thread, and only touches the helper */
+static void
+fu_ifd_bios_parse_volume_cb(gpointer data, gpointer user_data)
+{
+	FuIfdBiosVolumeHelper *helper = (FuIfdBiosVolumeHelper *)data;
+	g_autoptr(GInputStream) stream = g_memory_input_stream_new_from_bytes(helper->blob);
+	fu_firmware_parse_stream(helper->firmware, stream, 0x0, helper->flags, &helper->error);
+}
+
+/* find the volumes using just the headers */
+static GPtrArray *
+fu_ifd_bios_scan_volumes(GInputStream *stream,
+			 gsize offset,
+			 gsize streamsz,
+			 FwupdInstallFlags flags,
+			 GError **error)
+{
+	g_autoptr(GPtrArray) helpers =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_ifd_bios_volume_helper_free);
 
-	/* read each volume in order */
 	while (offset < streamsz) {
+		guint64 fv_length;
+		g_autoptr(FuIfdBiosVolumeHelper) helper = NULL;
+		g_autoptr(GByteArray) st_hdr = NULL;
+
+		st_hdr = fu_struct_efi_volume_parse_stream(stream, offset, NULL);
+		if (st_hdr == NULL) {
+			offset += 0x1000;
+			continue;
+		}
+		fv_length = fu_struct_efi_volume_get_length(st_hdr);
+		if (fv_length == 0x0 || fv_length > streamsz - offset) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "invalid volume length 0x%x @0x%x",
+				    (guint)fv_length,
+				    (guint)offset);
+			return NULL;
+		}
+		helper = g_new0(FuIfdBiosVolumeHelper, 1);
+		helper->offset = offset;
+		helper->flags = flags;
+		helper->firmware = fu_efi_volume_new();
+		g_ptr_array_add(helpers, g_steal_pointer(&helper));
+		offset += fv_length;
+	}
+	return g_steal_pointer(&helpers);
+}
+
+/* read each volume in order, skipping ahead when one cannot be parsed */
+static gboolean
+fu_ifd_bios_parse_range(FuFirmware *firmware,
+			GInputStream *stream,
+			gsize offset,
+			gsize offset_end,
+			FwupdInstallFlags flags,
+			guint *img_cnt,
+			GError **error)
+{
+	while (offset < offset_end) {
 		g_autoptr(FuFirmware) firmware_tmp = fu_efi_volume_new();
 		g_autoptr(GError) error_local = NULL;
 
@@ -50,7 +118,7 @@ fu_ifd_bios_parse(FuFirmware *firmware,
 		if (!fu_firmware_parse_stream(firmware_tmp, stream, offset, flags, &error_local)) {
 			g_debug("failed to read volume @0x%x of 0x%x: %s",
 				(guint)offset,
-				(guint)streamsz,
+				(guint)offset_end,
 				error_local->message);
 			offset += 0x1000;
 			continue;
@@ -61,7 +129,120 @@ fu_ifd_bios_parse(FuFirmware *firmware,
 
 		/* next! */
 		offset += fu_firmware_get_size(firmware_tmp);
-		img_cnt++;
+		(*img_cnt)++;
+	}
+
+	/* success */
+	return TRUE;
+}
+
+/* each volume is independent, so parse and decompress them on all the CPUs */
+static gboolean
+fu_ifd_bios_parse_parallel(FuFirmware *firmware,
+			   GInputStream *stream,
+			   GPtrArray *helpers,
+			   gsize streamsz,
+			   FwupdInstallFlags flags,
+			   guint *img_cnt,
+			   GError **error)
+{
+	GThreadPool *pool;
+	g_autoptr(GBytes) blob = NULL;
+
+	/* each worker gets its own stream as seeking is not threadsafe */
+	blob = fu_input_stream_read_bytes(stream, 0x0, streamsz, error);
+	if (blob == NULL)
+		return FALSE;
+	for (guint i = 0; i < helpers->len; i++) {
+		FuIfdBiosVolumeHelper *helper = g_ptr_array_index(helpers, i);
+		helper->blob =
+		    g_bytes_new_from_bytes(blob, helper->offset, streamsz - helper->offset);
+	}
+	pool = g_thread_pool_new(fu_ifd_bios_parse_volume_cb,
+				 NULL,
+				 (gint)MIN(g_get_num_processors(), helpers->len),
+				 FALSE,
+				 error);
+	if (pool == NULL)
+		return FALSE;
+	for (guint i = 0; i < helpers->len; i++)
+		g_thread_pool_push(pool, g_ptr_array_index(helpers, i), NULL);
+	g_thread_pool_free(pool, FALSE, TRUE);
+
+	/* a volume that failed is skipped in the same way as the sequential parser */
+	for (guint i = 0; i < helpers->len; i++) {
+		FuIfdBiosVolumeHelper *helper = g_ptr_array_index(helpers, i);
+		if (helper->error != NULL) {
+			gsize offset_end = streamsz;
+			if (i + 1 < helpers->len) {
+				FuIfdBiosVolumeHelper *helper_next =
+				    g_ptr_array_index(helpers, i + 1);
+				offset_end = helper_next->offset;
+			}
+			g_debug("failed to read volume @0x%x of 0x%x: %s",
+				(guint)helper->offset,
+				(guint)streamsz,
+				helper->error->message);
+			if (!fu_ifd_bios_parse_range(firmware,
+						     stream,
+						     helper->offset + 0x1000,
+						     offset_end,
+						     flags,
+						     img_cnt,
+						     error))
+				return FALSE;
+			continue;
+		}
+		fu_firmware_set_offset(helper->firmware, helper->offset);
+		if (!fu_firmware_add_image_full(firmware, helper->firmware, error))
+			return FALSE;
+		(*img_cnt)++;
+	}
+
+	/* success */
+	return TRUE;
+}
+
+static gboolean
+fu_ifd_bios_parse(FuFirmware *firmware,
+		  GInputStream *stream,
+		  gsize offset,
+		  FwupdInstallFlags flags,
+		  GError **error)
+{
+	gsize streamsz = 0;
+	guint img_cnt = 0;
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GPtrArray) helpers = NULL;
+
+	/* get size */
+	if (!fu_input_stream_size(stream, &streamsz, error))
+		return FALSE;
+
+	/* use the fast path if opted-in and the volume headers look sane */
+	if (fu_firmware_has_flag(firmware, FU_FIRMWARE_FLAG_PARSE_PARALLEL)) {
+		helpers = fu_ifd_bios_scan_volumes(stream, offset, streamsz, flags, &error_local);
+		if (helpers == NULL)
+			g_debug("using sequential parse: %s", error_local->message);
+	}
+	if (helpers != NULL && helpers->len > 1) {
+		if (!fu_ifd_bios_parse_parallel(firmware,
+						stream,
+						helpers,
+						streamsz,
+						flags,
+						&img_cnt,
+						error))
+			return FALSE;
+	} else {
+		if (!fu_ifd_bios_parse_range(firmware,
+					     stream,
+					     offset,
+					     streamsz,
+					     flags,
+					     &img_cnt,
+					     error))
+			return FALSE;
 	}
 
 	/* found nothing */
@@ -197,6 +197,8 @@ fu_ifd_firmware_parse(FuFirmware *firmware,
 			return FALSE;
 		if (i == FU_IFD_REGION_BIOS) {
 			img = fu_ifd_bios_new();
+			if (fu_firmware_has_flag(firmware, FU_FIRMWARE_FLAG_PARSE_PARALLEL))
+				fu_firmware_add_flag(img, FU_FIRMWARE_FLAG_PARSE_PARALLEL);
 		} else {
 			img = fu_ifd_image_new();
 		}
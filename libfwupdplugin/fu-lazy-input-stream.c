@@ -0,0 +1,279 @@
+/*
+ * Copyright 2024 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#define G_LOG_DOMAIN "FuLazyInputStream"
+
+#include "config.h"
+
+#include "fwupd-codec.h"
+#include "fwupd-common-private.h"
+
+#include "fu-input-stream.h"
+#include "fu-lazy-input-stream.h"
+
+/**
+ * FuLazyInputStream:
+ *
+ * A seekable input stream of a known size where the content is only created when first read.
+ *
+ * This allows expensive operations like decompression to be deferred until the data is
+ * actually required, or avoided completely if the data is never used.
+ */
+
+struct _FuLazyInputStream {
+	GInputStream parent_instance;
+	GInputStream *base_stream; /* nullable */
+	gsize size;
+	goffset pos;
+	FuLazyInputStreamFunc func;
+	gpointer user_data;
+	GDestroyNotify user_data_free;
+};
+
+static void
+fu_lazy_input_stream_seekable_iface_init(GSeekableIface *iface);
+static void
+fu_lazy_input_stream_codec_iface_init(FwupdCodecInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE(FuLazyInputStream,
+			fu_lazy_input_stream,
+			G_TYPE_INPUT_STREAM,
+			G_IMPLEMENT_INTERFACE(G_TYPE_SEEKABLE, fu_lazy_input_stream_seekable_iface_init)
+			    G_IMPLEMENT_INTERFACE(FWUPD_TYPE_CODEC,
+						  fu_lazy_input_stream_codec_iface_init))
+
+static void
+fu_lazy_input_stream_add_string(FwupdCodec *converter, guint idt, GString *str)
+{
+	FuLazyInputStream *self = FU_LAZY_INPUT_STREAM(converter);
+	fwupd_codec_string_append_hex(str, idt, "Size", self->size);
+	fwupd_codec_string_append_bool(str, idt, "Loaded", self->base_stream != NULL);
+}
+
+static void
+fu_lazy_input_stream_codec_iface_init(FwupdCodecInterface *iface)
+{
+	iface->add_string = fu_lazy_input_stream_add_string;
+}
+
+static gboolean
+fu_lazy_input_stream_ensure_base_stream(FuLazyInputStream *self, GError **error)
+{
+	gsize base_sz = 0;
+	g_autoptr(GInputStream) base_stream = NULL;
+
+	/* already done */
+	if (self->base_stream != NULL)
+		return TRUE;
+
+	/* create and check it is what we promised */
+	base_stream = self->func(self->user_data, error);
+	if (base_stream == NULL)
+		return FALSE;
+	if (!G_IS_SEEKABLE(base_stream) || !g_seekable_can_seek(G_SEEKABLE(base_stream))) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_SUPPORTED,
+				    "lazy base stream is not seekable");
+		return FALSE;
+	}
+	if (!fu_input_stream_size(base_stream, &base_sz, error))
+		return FALSE;
+	if (base_sz != self->size) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "lazy base stream was 0x%x bytes in size, expected 0x%x",
+			    (guint)base_sz,
+			    (guint)self->size);
+		return FALSE;
+	}
+	self->base_stream = g_steal_pointer(&base_stream);
+
+	/* never going to be called again */
+	if (self->user_data_free != NULL)
+		self->user_data_free(self->user_data);
+	self->user_data = NULL;
+	self->user_data_free = NULL;
+	return TRUE;
+}
+
+static goffset
+fu_lazy_input_stream_tell(GSeekable *seekable)
+{
+	FuLazyInputStream *self = FU_LAZY_INPUT_STREAM(seekable);
+	return self->pos;
+}
+
+static gboolean
+fu_lazy_input_stream_can_seek(GSeekable *seekable)
+{
+	return TRUE;
+}
+
+static gboolean
+fu_lazy_input_stream_seek(GSeekable *seekable,
+			  goffset offset,
+			  GSeekType type,
+			  GCancellable *cancellable,
+			  GError **error)
+{
+	FuLazyInputStream *self = FU_LAZY_INPUT_STREAM(seekable);
+	goffset pos = offset;
+
+	g_return_val_if_fail(FU_IS_LAZY_INPUT_STREAM(self), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* this does not need the base stream, so do not create it */
+	if (type == G_SEEK_CUR)
+		pos += self->pos;
+	else if (type == G_SEEK_END)
+		pos += (goffset)self->size;
+	if (pos < 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "cannot seek to negative offset %" G_GOFFSET_FORMAT,
+			    pos);
+		return FALSE;
+	}
+	self->pos = pos;
+	return TRUE;
+}
+
+static gboolean
+fu_lazy_input_stream_can_truncate(GSeekable *seekable)
+{
+	return FALSE;
+}
+
+static gboolean
+fu_lazy_input_stream_truncate(GSeekable *seekable,
+			      goffset offset,
+			      GCancellable *cancellable,
+			      GError **error)
+{
+	g_set_error_literal(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "cannot truncate FuLazyInputStream");
+	return FALSE;
+}
+
+static void
+fu_lazy_input_stream_seekable_iface_init(GSeekableIface *iface)
+{
+	iface->tell = fu_lazy_input_stream_tell;
+	iface->can_seek = fu_lazy_input_stream_can_seek;
+	iface->seek = fu_lazy_input_stream_seek;
+	iface->can_truncate = fu_lazy_input_stream_can_truncate;
+	iface->truncate_fn = fu_lazy_input_stream_truncate;
+}
+
+/**
+ * fu_lazy_input_stream_new:
+ * @size: size of the stream in bytes
+ * @func: (scope notified): a #FuLazyInputStreamFunc
+ * @user_data: user data to pass to @func
+ * @user_data_free: (nullable): a #GDestroyNotify for @user_data
+ *
+ * Creates a lazy input stream where the content is provided by @func the first time the stream
+ * is read. The size is known up-front, so seeking and querying the size does not call @func.
+ *
+ * Returns: (transfer full): a #FuLazyInputStream
+ *
+ * Since: 2.0.0
+ **/
+GInputStream *
+fu_lazy_input_stream_new(gsize size,
+			 FuLazyInputStreamFunc func,
+			 gpointer user_data,
+			 GDestroyNotify user_data_free)
+{
+	FuLazyInputStream *self;
+
+	g_return_val_if_fail(func != NULL, NULL);
+
+	self = g_object_new(FU_TYPE_LAZY_INPUT_STREAM, NULL);
+	self->size = size;
+	self->func = func;
+	self->user_data = user_data;
+	self->user_data_free = user_data_free;
+	return G_INPUT_STREAM(self);
+}
+
+/**
+ * fu_lazy_input_stream_get_loaded:
+ * @self: a #FuLazyInputStream
+ *
+ * Gets if the stream content has been created.
+ *
+ * Returns: boolean
+ *
+ * Since: 2.0.0
+ **/
+gboolean
+fu_lazy_input_stream_get_loaded(FuLazyInputStream *self)
+{
+	g_return_val_if_fail(FU_IS_LAZY_INPUT_STREAM(self), FALSE);
+	return self->base_stream != NULL;
+}
+
+static gssize
+fu_lazy_input_stream_read(GInputStream *stream,
+			  void *buffer,
+			  gsize count,
+			  GCancellable *cancellable,
+			  GError **error)
+{
+	FuLazyInputStream *self = FU_LAZY_INPUT_STREAM(stream);
+	gssize rc;
+
+	g_return_val_if_fail(FU_IS_LAZY_INPUT_STREAM(self), -1);
+	g_return_val_if_fail(error == NULL || *error == NULL, -1);
+
+	/* past the end, so no need to create the base stream */
+	if ((gsize)self->pos >= self->size)
+		return 0;
+	if (!fu_lazy_input_stream_ensure_base_stream(self, error))
+		return -1;
+	if (!g_seekable_seek(G_SEEKABLE(self->base_stream),
+			     self->pos,
+			     G_SEEK_SET,
+			     cancellable,
+			     error))
+		return -1;
+	count = MIN(count, self->size - (gsize)self->pos);
+	rc = g_input_stream_read(self->base_stream, buffer, count, cancellable, error);
+	if (rc > 0)
+		self->pos += rc;
+	return rc;
+}
+
+static void
+fu_lazy_input_stream_finalize(GObject *object)
+{
+	FuLazyInputStream *self = FU_LAZY_INPUT_STREAM(object);
+	if (self->user_data_free != NULL)
+		self->user_data_free(self->user_data);
+	if (self->base_stream != NULL)
+		g_object_unref(self->base_stream);
+	G_OBJECT_CLASS(fu_lazy_input_stream_parent_class)->finalize(object);
+}
+
+static void
+fu_lazy_input_stream_class_init(FuLazyInputStreamClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+	GInputStreamClass *istream_class = G_INPUT_STREAM_CLASS(klass);
+	istream_class->read_fn = fu_lazy_input_stream_read;
+	object_class->finalize = fu_lazy_input_stream_finalize;
+}
+
+static void
+fu_lazy_input_stream_init(FuLazyInputStream *self)
+{
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright 2024 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#pragma once
+
+#include <fwupd.h>
+
+#define FU_TYPE_LAZY_INPUT_STREAM (fu_lazy_input_stream_get_type())
+
+G_DECLARE_FINAL_TYPE(FuLazyInputStream, fu_lazy_input_stream, FU, LAZY_INPUT_STREAM, GInputStream)
+
+/**
+ * FuLazyInputStreamFunc:
+ * @user_data: user data
+ * @error: (nullable): optional return location for an error
+ *
+ * Creates the seekable stream that provides the data for a #FuLazyInputStream.
+ *
+ * Returns: (transfer full): a #GInputStream, or %NULL on error
+ *
+ * Since: 2.0.0
+ **/
+typedef GInputStream *(*FuLazyInputStreamFunc)(gpointer user_data, GError **error);
+
+GInputStream *
+fu_lazy_input_stream_new(gsize size,
+			 FuLazyInputStreamFunc func,
+			 gpointer user_data,
+			 GDestroyNotify user_data_free) G_GNUC_NON_NULL(2);
+gboolean
+fu_lazy_input_stream_get_loaded(FuLazyInputStream *self) G_GNUC_NON_NULL(1);
@@ -10,7 +10,44 @@
 #include <lzma.h>
 #endif
 
+#include "fu-input-stream.h"
 #include "fu-lzma-common.h"
+#include "fu-lzma-converter.h"
+
+/**
+ * fu_lzma_decompress_stream:
+ * @stream: a #GInputStream
+ * @error: (nullable): optional return location for an error
+ *
+ * Decompresses a LZMA or XZ stream as it is read, without loading the compressed or decompressed
+ * data into memory.
+ *
+ * NOTE: the returned stream is not seekable.
+ *
+ * Returns: (transfer full): a #GInputStream
+ *
+ * Since: 2.0.0
+ **/
+GInputStream *
+fu_lzma_decompress_stream(GInputStream *stream, GError **error)
+{
+#ifdef HAVE_LZMA
+	g_autoptr(GConverter) conv = fu_lzma_converter_new();
+	GInputStream *istr;
+	if (G_IS_SEEKABLE(stream) && g_seekable_can_seek(G_SEEKABLE(stream))) {
+		if (!g_seekable_seek(G_SEEKABLE(stream), 0x0, G_SEEK_SET, NULL, error))
+			return NULL;
+	}
+
+	/* the caller may still need @stream, e.g. to write the compressed data again */
+	istr = g_converter_input_stream_new(stream, conv);
+	g_filter_input_stream_set_close_base_stream(G_FILTER_INPUT_STREAM(istr), FALSE);
+	return istr;
+#else
+	g_set_error_literal(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "missing lzma support");
+	return NULL;
+#endif
+}
 
 /**
  * fu_lzma_decompress_bytes:
@@ -26,51 +63,24 @@
 GBytes *
 fu_lzma_decompress_bytes(GBytes *blob, GError **error)
 {
-#ifdef HAVE_LZMA
-	const gsize tmpbufsz = 0x20000;
-	lzma_ret rc;
-	lzma_stream strm = LZMA_STREAM_INIT;
-	uint64_t memlimit = G_MAXUINT32;
-	g_autofree guint8 *tmpbuf = g_malloc0(tmpbufsz);
-	g_autoptr(GByteArray) buf = g_byte_array_new();
-
-	strm.next_in = g_bytes_get_data(blob, NULL);
-	strm.avail_in = g_bytes_get_size(blob);
+	g_autoptr(GBytes) blob_uncomp = NULL;
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GInputStream) stream = g_memory_input_stream_new_from_bytes(blob);
+	g_autoptr(GInputStream) stream_uncomp = NULL;
 
-	rc = lzma_auto_decoder(&strm, memlimit, LZMA_TELL_UNSUPPORTED_CHECK);
-	if (rc != LZMA_OK) {
-		lzma_end(&strm);
-		g_set_error(error,
-			    FWUPD_ERROR,
-			    FWUPD_ERROR_NOT_SUPPORTED,
-			    "failed to set up LZMA decoder rc=%u",
-			    rc);
+	stream_uncomp = fu_lzma_decompress_stream(stream, error);
+	if (stream_uncomp == NULL)
 		return NULL;
-	}
-	do {
-		strm.next_out = tmpbuf;
-		strm.avail_out = tmpbufsz;
-		rc = lzma_code(&strm, LZMA_RUN);
-		if (rc != LZMA_OK && rc != LZMA_STREAM_END)
-			break;
-		g_byte_array_append(buf, tmpbuf, tmpbufsz - strm.avail_out);
-	} while (rc == LZMA_OK);
-	lzma_end(&strm);
-
-	/* success */
-	if (rc != LZMA_OK && rc != LZMA_STREAM_END) {
+	blob_uncomp = fu_input_stream_read_bytes(stream_uncomp, 0x0, G_MAXSIZE, &error_local);
+	if (blob_uncomp == NULL) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_NOT_SUPPORTED,
-			    "failed to decode LZMA data rc=%u",
-			    rc);
+			    "failed to decode LZMA data: %s",
+			    error_local->message);
 		return NULL;
 	}
-	return g_bytes_new(buf->data, buf->len);
-#else
-	g_set_error_literal(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "missing lzma support");
-	return NULL;
-#endif
+	return g_steal_pointer(&blob_uncomp);
 }
 
 /**
@@ -8,6 +8,8 @@
 
 #include <fwupd.h>
 
+GInputStream *
+fu_lzma_decompress_stream(GInputStream *stream, GError **error) G_GNUC_NON_NULL(1);
 GBytes *
 fu_lzma_decompress_bytes(GBytes *blob, GError **error) G_GNUC_NON_NULL(1);
 GBytes *
@@ -0,0 +1,221 @@
+/*
+ * Copyright 2024 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#define G_LOG_DOMAIN "FuLzmaConverter"
+
+#include "config.h"
+
+#ifdef HAVE_LZMA
+#include <lzma.h>
+#endif
+
+#include "fu-lzma-converter.h"
+
+/**
+ * FuLzmaConverter:
+ *
+ * A #GConverter that decompresses LZMA or XZ data, which allows the decompressed data to be
+ * consumed using g_converter_input_stream_new() without holding the compressed or decompressed
+ * data in memory.
+ *
+ * XZ data with multiple blocks is decompressed using all the CPUs, if supported by liblzma.
+ */
+
+struct _FuLzmaConverter {
+	GObject parent_instance;
+#ifdef HAVE_LZMA
+	lzma_stream strm;
+	gboolean initialized;
+#endif
+};
+
+static void
+fu_lzma_converter_iface_init(GConverterIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE(FuLzmaConverter,
+			fu_lzma_converter,
+			G_TYPE_OBJECT,
+			G_IMPLEMENT_INTERFACE(G_TYPE_CONVERTER, fu_lzma_converter_iface_init))
+
+#ifdef HAVE_LZMA
+#define FU_LZMA_CONVERTER_MEMLIMIT G_MAXUINT32
+
+static const guint8 fu_lzma_converter_xz_magic[] = {0xFD, '7', 'z', 'X', 'Z', 0x00};
+
+static gboolean
+fu_lzma_converter_init_decoder(FuLzmaConverter *self,
+			       const guint8 *buf,
+			       gsize bufsz,
+			       GError **error)
+{
+	lzma_ret rc;
+
+#if LZMA_VERSION >= 50040000
+	/* only the XZ container has independent blocks that can be decoded in parallel */
+	if (bufsz >= sizeof(fu_lzma_converter_xz_magic) &&
+	    memcmp(buf, fu_lzma_converter_xz_magic, sizeof(fu_lzma_converter_xz_magic)) == 0) {
+		lzma_mt mt = {
+		    .flags = LZMA_TELL_UNSUPPORTED_CHECK,
+		    .threads = g_get_num_processors(),
+		    .memlimit_threading = FU_LZMA_CONVERTER_MEMLIMIT,
+		    .memlimit_stop = FU_LZMA_CONVERTER_MEMLIMIT,
+		};
+		rc = lzma_stream_decoder_mt(&self->strm, &mt);
+		if (rc == LZMA_OK) {
+			self->initialized = TRUE;
+			return TRUE;
+		}
+		g_debug("failed to set up threaded XZ decoder rc=%u, falling back", rc);
+	}
+#endif
+	rc = lzma_auto_decoder(&self->strm, FU_LZMA_CONVERTER_MEMLIMIT, LZMA_TELL_UNSUPPORTED_CHECK);
+	if (rc != LZMA_OK) {
+		lzma_end(&self->strm);
+		g_set_error(error,
+			    G_IO_ERROR,
+			    G_IO_ERROR_NOT_SUPPORTED,
+			    "failed to set up LZMA decoder rc=%u",
+			    rc);
+		return FALSE;
+	}
+	self->initialized = TRUE;
+	return TRUE;
+}
+#endif
+
+static GConverterResult
+fu_lzma_converter_convert(GConverter *converter,
+			  const void *inbuf,
+			  gsize inbuf_size,
+			  void *outbuf,
+			  gsize outbuf_size,
+			  GConverterFlags flags,
+			  gsize *bytes_read,
+			  gsize *bytes_written,
+			  GError **error)
+{
+#ifdef HAVE_LZMA
+	FuLzmaConverter *self = FU_LZMA_CONVERTER(converter);
+	lzma_ret rc;
+
+	/* the container magic is needed to choose the decoder */
+	if (!self->initialized) {
+		if (inbuf_size < sizeof(fu_lzma_converter_xz_magic) &&
+		    (flags & G_CONVERTER_INPUT_AT_END) == 0) {
+			g_set_error_literal(error,
+					    G_IO_ERROR,
+					    G_IO_ERROR_PARTIAL_INPUT,
+					    "need more data for the LZMA header");
+			return G_CONVERTER_ERROR;
+		}
+		if (!fu_lzma_converter_init_decoder(self, inbuf, inbuf_size, error))
+			return G_CONVERTER_ERROR;
+	}
+
+	self->strm.next_in = inbuf;
+	self->strm.avail_in = inbuf_size;
+	self->strm.next_out = outbuf;
+	self->strm.avail_out = outbuf_size;
+	rc = lzma_code(&self->strm,
+		       (flags & G_CONVERTER_INPUT_AT_END) ? LZMA_FINISH : LZMA_RUN);
+	*bytes_read = inbuf_size - self->strm.avail_in;
+	*bytes_written = outbuf_size - self->strm.avail_out;
+	if (rc == LZMA_STREAM_END)
+		return G_CONVERTER_FINISHED;
+	if (rc == LZMA_OK) {
+		if ((flags & G_CONVERTER_FLUSH) != 0 && self->strm.avail_in == 0)
+			return G_CONVERTER_FLUSHED;
+		return G_CONVERTER_CONVERTED;
+	}
+	if (rc == LZMA_BUF_ERROR) {
+		if (self->strm.avail_out == 0) {
+			g_set_error_literal(error,
+					    G_IO_ERROR,
+					    G_IO_ERROR_NO_SPACE,
+					    "need more space for LZMA output");
+			return G_CONVERTER_ERROR;
+		}
+		if ((flags & G_CONVERTER_INPUT_AT_END) == 0) {
+			g_set_error_literal(error,
+					    G_IO_ERROR,
+					    G_IO_ERROR_PARTIAL_INPUT,
+					    "need more LZMA input");
+			return G_CONVERTER_ERROR;
+		}
+		g_set_error_literal(error,
+				    G_IO_ERROR,
+				    G_IO_ERROR_INVALID_DATA,
+				    "LZMA data was truncated");
+		return G_CONVERTER_ERROR;
+	}
+	g_set_error(error,
+		    G_IO_ERROR,
+		    G_IO_ERROR_INVALID_DATA,
+		    "failed to decode LZMA data rc=%u",
+		    rc);
+	return G_CONVERTER_ERROR;
+#else
+	g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "missing lzma support");
+	return G_CONVERTER_ERROR;
+#endif
+}
+
+static void
+fu_lzma_converter_reset(GConverter *converter)
+{
+#ifdef HAVE_LZMA
+	FuLzmaConverter *self = FU_LZMA_CONVERTER(converter);
+	if (self->initialized) {
+		lzma_end(&self->strm);
+		self->initialized = FALSE;
+	}
+#endif
+}
+
+static void
+fu_lzma_converter_iface_init(GConverterIface *iface)
+{
+	iface->convert = fu_lzma_converter_convert;
+	iface->reset = fu_lzma_converter_reset;
+}
+
+static void
+fu_lzma_converter_init(FuLzmaConverter *self)
+{
+#ifdef HAVE_LZMA
+	lzma_stream strm_init = LZMA_STREAM_INIT;
+	self->strm = strm_init;
+#endif
+}
+
+static void
+fu_lzma_converter_finalize(GObject *object)
+{
+	fu_lzma_converter_reset(G_CONVERTER(object));
+	G_OBJECT_CLASS(fu_lzma_converter_parent_class)->finalize(object);
+}
+
+static void
+fu_lzma_converter_class_init(FuLzmaConverterClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+	object_class->finalize = fu_lzma_converter_finalize;
+}
+
+/**
+ * fu_lzma_converter_new:
+ *
+ * Creates a new LZMA decompressor.
+ *
+ * Returns: (transfer full): a #GConverter
+ *
+ * Since: 2.0.0
+ **/
+GConverter *
+fu_lzma_converter_new(void)
+{
+	return G_CONVERTER(g_object_new(FU_TYPE_LZMA_CONVERTER, NULL));
+}
@@ -0,0 +1,16 @@
+/*
+ * Copyright 2024 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#pragma once
+
+#include <fwupd.h>
+
+#define FU_TYPE_LZMA_CONVERTER (fu_lzma_converter_get_type())
+
+G_DECLARE_FINAL_TYPE(FuLzmaConverter, fu_lzma_converter, FU, LZMA_CONVERTER, GObject)
+
+GConverter *
+fu_lzma_converter_new(void);
@@ -12,6 +12,11 @@
 
 #include <glib/gstdio.h>
 #include <string.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <glib-unix.h>
+#include <unistd.h>
+#endif
 
 #include "fwupd-security-attr-private.h"
 
@@ -22,6 +27,7 @@
 #include "fu-coswid-firmware.h"
 #include "fu-device-private.h"
 #include "fu-device-progress.h"
+#include "fu-efi-common.h"
 #include "fu-efi-lz77-decompressor.h"
 #include "fu-lzma-common.h"
 #include "fu-plugin-private.h"
@@ -335,6 +341,144 @@ fu_device_cfi_device_func(void)
 	g_assert_cmpint(fu_cfi_device_get_block_size(cfi_device), ==, 0x8000);
 }
 
+#define FU_TYPE_SELF_TEST_CFI_DEVICE (fu_self_test_cfi_device_get_type())
+G_DECLARE_FINAL_TYPE(FuSelfTestCfiDevice,
+		     fu_self_test_cfi_device,
+		     FU,
+		     SELF_TEST_CFI_DEVICE,
+		     FuCfiDevice)
+
+struct _FuSelfTestCfiDevice {
+	FuCfiDevice parent_instance;
+	guint8 flash[0x4000];
+	gboolean wel;
+	guint cnt_erase;
+	guint cnt_write;
+};
+
+G_DEFINE_TYPE(FuSelfTestCfiDevice, fu_self_test_cfi_device, FU_TYPE_CFI_DEVICE)
+
+static gboolean
+fu_self_test_cfi_device_chip_select(FuCfiDevice *device, gboolean value, GError **error)
+{
+	return TRUE;
+}
+
+/* emulate a SPI flash chip where programming can only clear bits */
+static gboolean
+fu_self_test_cfi_device_send_command(FuCfiDevice *device,
+				     const guint8 *wbuf,
+				     gsize wbufsz,
+				     guint8 *rbuf,
+				     gsize rbufsz,
+				     FuProgress *progress,
+				     GError **error)
+{
+	FuSelfTestCfiDevice *self = FU_SELF_TEST_CFI_DEVICE(device);
+	guint32 addr = 0;
+
+	if (wbufsz >= 4)
+		addr = fu_memread_uint24(wbuf + 1, G_BIG_ENDIAN);
+	switch (wbuf[0]) {
+	case 0x02: /* page program */
+		for (gsize i = 4; i < wbufsz; i++)
+			self->flash[addr + i - 4] &= wbuf[i];
+		self->wel = FALSE;
+		self->cnt_write++;
+		break;
+	case 0x03: /* read data */
+		memcpy(rbuf, self->flash + addr, rbufsz);
+		break;
+	case 0x05: /* read status */
+		rbuf[1] = self->wel ? 0b10 : 0b0;
+		break;
+	case 0x06: /* write enable */
+		self->wel = TRUE;
+		break;
+	case 0x20: /* sector erase */
+		memset(self->flash + addr, 0xFF, fu_cfi_device_get_sector_size(device));
+		self->wel = FALSE;
+		self->cnt_erase++;
+		break;
+	default:
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "command 0x%02x not supported",
+			    wbuf[0]);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static void
+fu_self_test_cfi_device_init(FuSelfTestCfiDevice *self)
+{
+	fu_device_remove_internal_flag(FU_DEVICE(self),
+				       FU_DEVICE_INTERNAL_FLAG_USE_PARENT_FOR_OPEN);
+	fu_cfi_device_set_page_size(FU_CFI_DEVICE(self), 0x100);
+	fu_cfi_device_set_sector_size(FU_CFI_DEVICE(self), 0x1000);
+}
+
+static void
+fu_self_test_cfi_device_class_init(FuSelfTestCfiDeviceClass *klass)
+{
+	FuCfiDeviceClass *cfi_class = FU_CFI_DEVICE_CLASS(klass);
+	cfi_class->chip_select = fu_self_test_cfi_device_chip_select;
+	cfi_class->send_command = fu_self_test_cfi_device_send_command;
+}
+
+static void
+fu_device_cfi_device_differential_func(void)
+{
+	gboolean ret;
+	guint8 buf[0x4000];
+	g_autoptr(FuSelfTestCfiDevice) device = NULL;
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+
+	/* existing contents: data, already erased, data, data */
+	device = g_object_new(FU_TYPE_SELF_TEST_CFI_DEVICE, NULL);
+	memset(device->flash + 0x0000, 0x12, 0x1000);
+	memset(device->flash + 0x1000, 0xFF, 0x1000);
+	memset(device->flash + 0x2000, 0x34, 0x1000);
+	memset(device->flash + 0x3000, 0xAA, 0x1000);
+
+	/* unchanged, program one page only, erase only, erase then program one page */
+	memset(buf + 0x0000, 0x12, 0x1000);
+	memset(buf + 0x1000, 0xFF, 0x1000);
+	memset(buf + 0x1000, 0x0F, 0x100);
+	memset(buf + 0x2000, 0xFF, 0x1000);
+	memset(buf + 0x3000, 0xFF, 0x1000);
+	memset(buf + 0x3000, 0x55, 0x100);
+	blob = g_bytes_new(buf, sizeof(buf));
+	stream = g_memory_input_stream_new_from_bytes(blob);
+	ret = fu_device_write_firmware(FU_DEVICE(device),
+				       stream,
+				       progress,
+				       FWUPD_INSTALL_FLAG_NONE,
+				       &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(device->cnt_erase, ==, 2);
+	g_assert_cmpint(device->cnt_write, ==, 2);
+	g_assert_cmpmem(device->flash, sizeof(device->flash), buf, sizeof(buf));
+
+	/* nothing to do the second time */
+	fu_progress_reset(progress);
+	ret = fu_device_write_firmware(FU_DEVICE(device),
+				       stream,
+				       progress,
+				       FWUPD_INSTALL_FLAG_NONE,
+				       &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(device->cnt_erase, ==, 2);
+	g_assert_cmpint(device->cnt_write, ==, 2);
+}
+
 static void
 fu_device_metadata_func(void)
 {
@@ -562,6 +706,77 @@ fu_context_firmware_gtypes_func(void)
 	g_assert_cmpint(fu_context_get_firmware_gtype_by_id(ctx, "n/a"), ==, G_TYPE_INVALID);
 }
 
+static void
+fu_context_firmware_cache_func(void)
+{
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuDevice) device1 = fu_device_new(ctx);
+	g_autoptr(FuDevice) device2 = fu_device_new(ctx);
+	g_autoptr(FuFirmware) firmware1 = NULL;
+	g_autoptr(FuFirmware) firmware2 = NULL;
+	g_autoptr(FuFirmware) firmware3 = NULL;
+	g_autoptr(FuFirmware) firmware4 = NULL;
+	g_autoptr(FuFirmware) firmware_tmp = fu_firmware_new();
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GBytes) blob = g_bytes_new_static("hello world", 11);
+	g_autoptr(GInputStream) stream = g_memory_input_stream_new_from_bytes(blob);
+	g_autoptr(GInputStream) stream2 = g_memory_input_stream_new_from_bytes(blob);
+	g_autoptr(GError) error = NULL;
+
+	/* disabled by default */
+	fu_context_firmware_cache_add(ctx, "foo", stream, firmware_tmp);
+	g_assert_null(fu_context_firmware_cache_lookup(ctx, "foo"));
+
+	/* two identical devices installing the same stream share the parsed firmware */
+	fu_context_set_firmware_cache_max_age(ctx, 60);
+	fu_device_set_firmware_gtype(device1, FU_TYPE_FIRMWARE);
+	fu_device_set_firmware_gtype(device2, FU_TYPE_FIRMWARE);
+	firmware1 = fu_device_prepare_firmware(device1,
+					       stream,
+					       progress,
+					       FWUPD_INSTALL_FLAG_NONE,
+					       &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(firmware1);
+	firmware2 = fu_device_prepare_firmware(device2,
+					       stream,
+					       progress,
+					       FWUPD_INSTALL_FLAG_NONE,
+					       &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(firmware2);
+	g_assert_true(firmware1 == firmware2);
+
+	/* different flags or a different stream are parsed again */
+	firmware3 = fu_device_prepare_firmware(device2,
+					       stream,
+					       progress,
+					       FWUPD_INSTALL_FLAG_FORCE,
+					       &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(firmware3);
+	g_assert_true(firmware3 != firmware1);
+	firmware4 = fu_device_prepare_firmware(device2,
+					       stream2,
+					       progress,
+					       FWUPD_INSTALL_FLAG_NONE,
+					       &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(firmware4);
+	g_assert_true(firmware4 != firmware1);
+
+	/* the end of the transaction drops everything */
+	fu_context_firmware_cache_add(ctx, "foo", stream, firmware_tmp);
+	fu_context_firmware_cache_clear(ctx);
+	g_assert_null(fu_context_firmware_cache_lookup(ctx, "foo"));
+
+	/* disabling drops everything */
+	fu_context_firmware_cache_add(ctx, "foo", stream, firmware_tmp);
+	fu_context_set_firmware_cache_max_age(ctx, 0);
+	g_assert_cmpint(fu_context_get_firmware_cache_max_age(ctx), ==, 0);
+	g_assert_null(fu_context_firmware_cache_lookup(ctx, "foo"));
+}
+
 static void
 fu_context_hwids_dmi_func(void)
 {
@@ -1652,6 +1867,7 @@ fu_device_vfuncs_func(void)
 	g_autoptr(GInputStream) istream = g_memory_input_stream_new();
 	g_autoptr(FuFirmware) firmware = NULL;
 	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GBytes) blob_fw = g_bytes_new_static("hello", 5);
 	g_autoptr(GError) error = NULL;
 
 	/* nop: error */
@@ -1684,6 +1900,11 @@ fu_device_vfuncs_func(void)
 	g_assert_false(ret);
 	g_clear_error(&error);
 
+	ret = fu_device_verify_checksum(device, 0x0, blob_fw, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED);
+	g_assert_false(ret);
+	g_clear_error(&error);
+
 	/* nop: ignore */
 	ret = fu_device_detach(device, &error);
 	g_assert_no_error(error);
@@ -2158,6 +2379,121 @@ fu_chunk_array_func(void)
 	g_assert_null(chk4);
 }
 
+typedef struct {
+	guint8 flash[0x400];
+	guint cnt_erase;
+	guint cnt_write;
+	guint cnt_checksum;
+} FuFlashPipelineHelper;
+
+static gboolean
+fu_flash_pipeline_test_erase_cb(FuDevice *device,
+				gsize address,
+				gsize size,
+				gpointer user_data,
+				GError **error)
+{
+	FuFlashPipelineHelper *helper = (FuFlashPipelineHelper *)user_data;
+	memset(helper->flash + address, 0xFF, size);
+	helper->cnt_erase++;
+	return TRUE;
+}
+
+static gboolean
+fu_flash_pipeline_test_write_cb(FuDevice *device,
+				FuChunk *chk,
+				gpointer user_data,
+				GError **error)
+{
+	FuFlashPipelineHelper *helper = (FuFlashPipelineHelper *)user_data;
+	memcpy(helper->flash + fu_chunk_get_address(chk),
+	       fu_chunk_get_data(chk),
+	       fu_chunk_get_data_sz(chk));
+	helper->cnt_write++;
+	return TRUE;
+}
+
+static gboolean
+fu_flash_pipeline_test_read_cb(FuDevice *device,
+			       gsize address,
+			       guint8 *buf,
+			       gsize bufsz,
+			       gpointer user_data,
+			       GError **error)
+{
+	FuFlashPipelineHelper *helper = (FuFlashPipelineHelper *)user_data;
+	memcpy(buf, helper->flash + address, bufsz);
+	return TRUE;
+}
+
+static gboolean
+fu_flash_pipeline_test_checksum_cb(FuDevice *device,
+				   gsize address,
+				   gsize size,
+				   guint32 *crc,
+				   gpointer user_data,
+				   GError **error)
+{
+	FuFlashPipelineHelper *helper = (FuFlashPipelineHelper *)user_data;
+	*crc = fu_crc32(helper->flash + address, size);
+	helper->cnt_checksum++;
+	return TRUE;
+}
+
+static void
+fu_flash_pipeline_func(void)
+{
+	gboolean ret;
+	guint8 buf[0x400] = {0x0};
+	FuFlashPipelineHelper helper = {.flash = {0x0}};
+	g_autoptr(FuDevice) device = fu_device_new(NULL);
+	g_autoptr(FuFlashPipeline) pipeline = fu_flash_pipeline_new(device);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(FuProgress) progress2 = fu_progress_new(G_STRLOC);
+	g_autoptr(FuProgress) progress3 = fu_progress_new(G_STRLOC);
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+
+	/* sector 0x0 is unchanged, sector 0x1 has one blank page and the others change */
+	memset(buf + 0x100, 0xFF, 0x40);
+	memset(buf + 0x140, 0xAA, 0xC0);
+	memset(buf + 0x200, 0xBB, 0x200);
+	blob = g_bytes_new(buf, sizeof(buf));
+	stream = g_memory_input_stream_new_from_bytes(blob);
+
+	fu_flash_pipeline_set_sector_size(pipeline, 0x100);
+	fu_flash_pipeline_set_page_size(pipeline, 0x40);
+	fu_flash_pipeline_set_user_data(pipeline, &helper);
+	fu_flash_pipeline_set_erase_func(pipeline, fu_flash_pipeline_test_erase_cb);
+	fu_flash_pipeline_set_write_func(pipeline, fu_flash_pipeline_test_write_cb);
+	fu_flash_pipeline_set_read_func(pipeline, fu_flash_pipeline_test_read_cb);
+	fu_flash_pipeline_set_checksum_func(pipeline, fu_flash_pipeline_test_checksum_cb);
+	fu_flash_pipeline_add_flag(pipeline, FU_FLASH_PIPELINE_FLAG_SKIP_UNCHANGED);
+	fu_flash_pipeline_add_flag(pipeline, FU_FLASH_PIPELINE_FLAG_SKIP_BLANK);
+	fu_flash_pipeline_add_flag(pipeline, FU_FLASH_PIPELINE_FLAG_VERIFY);
+	ret = fu_flash_pipeline_write(pipeline, stream, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(helper.cnt_erase, ==, 3);
+	g_assert_cmpint(helper.cnt_write, ==, 11);
+	g_assert_cmpint(helper.cnt_checksum, ==, 3);
+	g_assert_cmpint(memcmp(helper.flash, buf, sizeof(buf)), ==, 0);
+
+	/* writing the same image again does nothing */
+	ret = fu_flash_pipeline_write(pipeline, stream, progress2, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(helper.cnt_erase, ==, 3);
+	g_assert_cmpint(helper.cnt_write, ==, 11);
+
+	/* the address has to be aligned to the sector */
+	fu_flash_pipeline_set_address(pipeline, 0x80);
+	ret = fu_flash_pipeline_write(pipeline, stream, progress3, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_DATA);
+	g_assert_false(ret);
+}
+
 static void
 fu_chunk_func(void)
 {
@@ -3156,6 +3492,62 @@ fu_firmware_archive_func(void)
 	g_assert_null(img_both);
 }
 
+static void
+fu_firmware_cab_lazy_func(void)
+{
+	gboolean ret;
+	g_autoptr(FuCabImage) img1 = fu_cab_image_new();
+	g_autoptr(FuFirmware) cab1 = fu_cab_firmware_new();
+	g_autoptr(FuFirmware) cab2 = fu_cab_firmware_new();
+	g_autoptr(FuFirmware) cab3 = fu_cab_firmware_new();
+	g_autoptr(FuFirmware) img2 = NULL;
+	g_autoptr(FuFirmware) img3 = NULL;
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GBytes) blob1 = g_bytes_new_static("hello world", 11);
+	g_autoptr(GBytes) blob2 = NULL;
+	g_autoptr(GBytes) blob3 = NULL;
+	g_autoptr(GBytes) blob_bad = NULL;
+	g_autoptr(GBytes) fw = NULL;
+	g_autoptr(GError) error = NULL;
+
+	/* create compressed archive */
+	fu_cab_firmware_set_compressed(FU_CAB_FIRMWARE(cab1), TRUE);
+	fu_firmware_set_id(FU_FIRMWARE(img1), "hello.txt");
+	fu_firmware_set_bytes(FU_FIRMWARE(img1), blob1);
+	fu_firmware_add_image(cab1, FU_FIRMWARE(img1));
+	fw = fu_firmware_write(cab1, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(fw);
+
+	/* parse lazily, then decompress */
+	fu_cab_firmware_set_lazy_decompress(FU_CAB_FIRMWARE(cab2), TRUE);
+	ret = fu_firmware_parse(cab2, fw, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	img2 = fu_firmware_get_image_by_id(cab2, "hello.txt", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(img2);
+	blob2 = fu_firmware_get_bytes(img2, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob2);
+	g_assert_cmpint(g_bytes_compare(blob1, blob2), ==, 0);
+
+	/* corrupt the CFDATA, which is only detected when the file is read */
+	fu_byte_array_append_bytes(buf, fw);
+	buf->data[buf->len - 1] ^= 0xFF;
+	blob_bad = g_bytes_new(buf->data, buf->len);
+	fu_cab_firmware_set_lazy_decompress(FU_CAB_FIRMWARE(cab3), TRUE);
+	ret = fu_firmware_parse(cab3, blob_bad, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	img3 = fu_firmware_get_image_by_id(cab3, "hello.txt", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(img3);
+	blob3 = fu_firmware_get_bytes(img3, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE);
+	g_assert_null(blob3);
+}
+
 static void
 fu_firmware_linear_func(void)
 {
@@ -3782,6 +4174,215 @@ fu_device_retry_hardware_func(void)
 	g_assert_cmpint(helper.cnt_failed, ==, 2);
 }
 
+static void
+fu_device_retry_backoff_func(void)
+{
+	gboolean ret;
+	g_autoptr(FuDevice) device = fu_device_new(NULL);
+	g_autoptr(FuDevice) device2 = fu_device_new(NULL);
+	g_autoptr(GError) error = NULL;
+	FuDeviceRetryHelper helper = {
+	    .cnt_success = 0,
+	    .cnt_failed = 0,
+	};
+	FuDeviceRetryHelper helper2 = {
+	    .cnt_success = 0,
+	    .cnt_failed = 0,
+	};
+
+	/* 1ms then 2ms */
+	ret = fu_device_retry_backoff(device,
+				      fu_device_retry_success_3rd_try,
+				      1000,
+				      1,
+				      10,
+				      FU_DEVICE_RETRY_FLAG_BACKOFF,
+				      &helper,
+				      &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(helper.cnt_success, ==, 1);
+	g_assert_cmpint(helper.cnt_failed, ==, 2);
+	g_assert_cmpint(fu_device_get_sleep_total(device), ==, 3);
+
+	/* never succeeds, and the last delay is clamped to the deadline */
+	ret = fu_device_retry_backoff(device2,
+				      fu_device_retry_failed,
+				      20,
+				      2,
+				      8,
+				      FU_DEVICE_RETRY_FLAG_BACKOFF | FU_DEVICE_RETRY_FLAG_JITTER,
+				      &helper2,
+				      &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL);
+	g_assert_false(ret);
+	g_assert_cmpint(helper2.cnt_failed, >=, 2);
+	g_assert_cmpint(fu_device_get_sleep_total(device2), <=, 20);
+}
+
+static void
+fu_device_wait_readable_func(void)
+{
+#ifndef _WIN32
+	gboolean ret;
+	gchar buf[1] = {0x0};
+	gint fds[2] = {-1, -1};
+	g_autoptr(FuDevice) device = fu_device_new(NULL);
+	g_autoptr(FuDevice) device_emulated = fu_device_new(NULL);
+	g_autoptr(GError) error = NULL;
+
+	ret = g_unix_open_pipe(fds, FD_CLOEXEC, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* nothing written yet */
+	ret = fu_device_wait_readable(device, fds[0], 10, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_TIMED_OUT);
+	g_assert_false(ret);
+	g_assert_cmpint(fu_device_get_sleep_total(device), >=, 9);
+	g_clear_error(&error);
+
+	/* emulated devices never wait */
+	fu_device_add_flag(device_emulated, FWUPD_DEVICE_FLAG_EMULATED);
+	ret = fu_device_wait_readable(device_emulated, fds[0], 10, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(fu_device_get_sleep_total(device_emulated), ==, 0);
+
+	/* data available */
+	g_assert_cmpint(write(fds[1], "X", 1), ==, 1);
+	ret = fu_device_wait_readable(device, fds[0], 1000, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* other end closed, with nothing left to read */
+	g_assert_cmpint(read(fds[0], buf, sizeof(buf)), ==, 1);
+	close(fds[1]);
+	ret = fu_device_wait_readable(device, fds[0], 1000, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_READ);
+	g_assert_false(ret);
+	close(fds[0]);
+#else
+	g_test_skip("no pipes on Windows");
+#endif
+}
+
+#define FU_TYPE_SELF_TEST_DEVICE (fu_self_test_device_get_type())
+G_DECLARE_FINAL_TYPE(FuSelfTestDevice, fu_self_test_device, FU, SELF_TEST_DEVICE, FuDevice)
+
+struct _FuSelfTestDevice {
+	FuDevice parent_instance;
+	GBytes *flash;
+};
+
+G_DEFINE_TYPE(FuSelfTestDevice, fu_self_test_device, FU_TYPE_DEVICE)
+
+static gboolean
+fu_self_test_device_read_checksum(FuDevice *device,
+				  gsize address,
+				  gsize size,
+				  FuChecksumKind *kind,
+				  guint32 *value,
+				  GError **error)
+{
+	FuSelfTestDevice *self = FU_SELF_TEST_DEVICE(device);
+	const guint8 *buf;
+
+	if (self->flash == NULL) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_SUPPORTED,
+				    "no flash contents");
+		return FALSE;
+	}
+	buf = g_bytes_get_data(self->flash, NULL);
+	*kind = FU_CHECKSUM_KIND_SUM32;
+	*value = fu_sum32(buf + address, size);
+	return TRUE;
+}
+
+static void
+fu_self_test_device_init(FuSelfTestDevice *self)
+{
+}
+
+static void
+fu_self_test_device_finalize(GObject *object)
+{
+	FuSelfTestDevice *self = FU_SELF_TEST_DEVICE(object);
+	if (self->flash != NULL)
+		g_bytes_unref(self->flash);
+	G_OBJECT_CLASS(fu_self_test_device_parent_class)->finalize(object);
+}
+
+static void
+fu_self_test_device_class_init(FuSelfTestDeviceClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+	FuDeviceClass *device_class = FU_DEVICE_CLASS(klass);
+	object_class->finalize = fu_self_test_device_finalize;
+	device_class->read_checksum = fu_self_test_device_read_checksum;
+}
+
+static void
+fu_device_verify_checksum_func(void)
+{
+	gboolean ret;
+	g_autoptr(FuSelfTestDevice) device = g_object_new(FU_TYPE_SELF_TEST_DEVICE, NULL);
+	g_autoptr(GBytes) blob1 = g_bytes_new_static("world", 5);
+	g_autoptr(GBytes) blob2 = g_bytes_new_static("earth", 5);
+	g_autoptr(GError) error = NULL;
+
+	device->flash = g_bytes_new_static("hello world", 11);
+
+	/* matches */
+	ret = fu_device_verify_checksum(FU_DEVICE(device), 6, blob1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* checksum invalid */
+	ret = fu_device_verify_checksum(FU_DEVICE(device), 6, blob2, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_DATA);
+	g_assert_false(ret);
+}
+
+static void
+fu_flash_pipeline_verify_unsupported_func(void)
+{
+	gboolean ret;
+	FuFlashPipelineHelper helper = {.flash = {0x0}};
+	g_autoptr(FuDevice) device1 = fu_device_new(NULL);
+	g_autoptr(FuSelfTestDevice) device2 = g_object_new(FU_TYPE_SELF_TEST_DEVICE, NULL);
+	g_autoptr(FuFlashPipeline) pipeline1 = fu_flash_pipeline_new(device1);
+	g_autoptr(FuFlashPipeline) pipeline2 = fu_flash_pipeline_new(FU_DEVICE(device2));
+	g_autoptr(FuProgress) progress1 = fu_progress_new(G_STRLOC);
+	g_autoptr(FuProgress) progress2 = fu_progress_new(G_STRLOC);
+	g_autoptr(GBytes) blob = g_bytes_new_static("hello world", 11);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GInputStream) stream = g_memory_input_stream_new_from_bytes(blob);
+
+	/* there is no way to verify at all, so nothing is written */
+	fu_flash_pipeline_set_sector_size(pipeline1, 0x100);
+	fu_flash_pipeline_set_user_data(pipeline1, &helper);
+	fu_flash_pipeline_set_write_func(pipeline1, fu_flash_pipeline_test_write_cb);
+	fu_flash_pipeline_add_flag(pipeline1, FU_FLASH_PIPELINE_FLAG_VERIFY);
+	ret = fu_flash_pipeline_write(pipeline1, stream, progress1, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED);
+	g_assert_false(ret);
+	g_assert_cmpint(helper.cnt_write, ==, 0);
+	g_clear_error(&error);
+
+	/* the device cannot checksum and there is nothing to read back with */
+	fu_flash_pipeline_set_sector_size(pipeline2, 0x100);
+	fu_flash_pipeline_set_user_data(pipeline2, &helper);
+	fu_flash_pipeline_set_write_func(pipeline2, fu_flash_pipeline_test_write_cb);
+	fu_flash_pipeline_add_flag(pipeline2, FU_FLASH_PIPELINE_FLAG_VERIFY);
+	ret = fu_flash_pipeline_write(pipeline2, stream, progress2, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED);
+	g_assert_false(ret);
+	g_assert_cmpint(helper.cnt_write, ==, 1);
+}
+
 static void
 fu_bios_settings_load_func(void)
 {
@@ -4240,6 +4841,83 @@ fu_security_attrs_compare_func(void)
 	g_assert_false(fu_security_attrs_equal(attrs2, attrs1));
 }
 
+static void
+fu_firmware_ifd_bios_func(void)
+{
+	gboolean ret;
+	gsize bufsz = 0;
+	g_autofree gchar *filename = NULL;
+	g_autofree gchar *xml = NULL;
+	g_autofree guint8 *buf = NULL;
+	g_autoptr(FuFirmware) firmware1 = fu_ifd_bios_new();
+	g_autoptr(FuFirmware) firmware2 = fu_ifd_bios_new();
+	g_autoptr(FuFirmware) firmware3 = fu_ifd_bios_new();
+	g_autoptr(FuFirmware) firmware4 = fu_ifd_bios_new();
+	g_autoptr(FuFirmware) firmware5 = fu_ifd_bios_new();
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GBytes) blob_corrupt = NULL;
+	g_autoptr(GPtrArray) imgs2 = NULL;
+	g_autoptr(GPtrArray) imgs3 = NULL;
+	g_autoptr(GPtrArray) imgs4 = NULL;
+	g_autoptr(GPtrArray) imgs5 = NULL;
+	g_autoptr(GError) error = NULL;
+
+	filename = g_test_build_filename(G_TEST_DIST, "tests", "ifd-bios.builder.xml", NULL);
+	ret = g_file_get_contents(filename, &xml, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_firmware_build_from_xml(firmware1, xml, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	blob = fu_firmware_write(firmware1, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob);
+
+	/* both volumes are parsed, in order */
+	ret = fu_firmware_parse(firmware2, blob, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	imgs2 = fu_firmware_get_images(firmware2);
+	g_assert_cmpint(imgs2->len, ==, 2);
+	g_assert_cmpint(fu_firmware_get_offset(g_ptr_array_index(imgs2, 0)), ==, 0x0);
+	g_assert_cmpint(fu_firmware_get_offset(g_ptr_array_index(imgs2, 1)),
+			==,
+			fu_firmware_get_size(g_ptr_array_index(imgs2, 0)));
+
+	/* a corrupt volume is skipped, and the others are still parsed */
+	buf = fu_memdup_safe(g_bytes_get_data(blob, NULL), g_bytes_get_size(blob), &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(buf);
+	bufsz = g_bytes_get_size(blob);
+	buf[fu_firmware_get_offset(g_ptr_array_index(imgs2, 1)) + 0x32] ^= 0xFF; /* checksum */
+	blob_corrupt = g_bytes_new_take(g_steal_pointer(&buf), bufsz);
+	ret = fu_firmware_parse(firmware3, blob_corrupt, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	imgs3 = fu_firmware_get_images(firmware3);
+	g_assert_cmpint(imgs3->len, ==, 1);
+	g_assert_cmpint(fu_firmware_get_offset(g_ptr_array_index(imgs3, 0)), ==, 0x0);
+
+	/* same results when parsing the volumes in parallel */
+	fu_firmware_add_flag(firmware4, FU_FIRMWARE_FLAG_PARSE_PARALLEL);
+	ret = fu_firmware_parse(firmware4, blob, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	imgs4 = fu_firmware_get_images(firmware4);
+	g_assert_cmpint(imgs4->len, ==, 2);
+	g_assert_cmpint(fu_firmware_get_offset(g_ptr_array_index(imgs4, 0)), ==, 0x0);
+	g_assert_cmpint(fu_firmware_get_offset(g_ptr_array_index(imgs4, 1)),
+			==,
+			fu_firmware_get_size(g_ptr_array_index(imgs4, 0)));
+	fu_firmware_add_flag(firmware5, FU_FIRMWARE_FLAG_PARSE_PARALLEL);
+	ret = fu_firmware_parse(firmware5, blob_corrupt, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	imgs5 = fu_firmware_get_images(firmware5);
+	g_assert_cmpint(imgs5->len, ==, 1);
+	g_assert_cmpint(fu_firmware_get_offset(g_ptr_array_index(imgs5, 0)), ==, 0x0);
+}
+
 static void
 fu_firmware_builder_round_trip_func(void)
 {
@@ -4833,6 +5511,57 @@ fu_partial_input_stream_func(void)
 	g_assert_null(stream_error);
 }
 
+static GInputStream *
+fu_lazy_input_stream_load_cb(gpointer user_data, GError **error)
+{
+	guint *cnt = (guint *)user_data;
+	g_autoptr(GBytes) blob = g_bytes_new_static("12345678", 8);
+	(*cnt)++;
+	return g_memory_input_stream_new_from_bytes(blob);
+}
+
+static void
+fu_lazy_input_stream_func(void)
+{
+	gboolean ret;
+	gsize streamsz = 0;
+	guint cnt = 0;
+	guint8 buf[1] = {0x0};
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+	g_autoptr(GInputStream) stream_error = NULL;
+
+	/* getting the size does not load the data */
+	stream = fu_lazy_input_stream_new(8, fu_lazy_input_stream_load_cb, &cnt, NULL);
+	ret = fu_input_stream_size(stream, &streamsz, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(streamsz, ==, 8);
+	g_assert_cmpint(cnt, ==, 0);
+	g_assert_false(fu_lazy_input_stream_get_loaded(FU_LAZY_INPUT_STREAM(stream)));
+
+	/* read twice, only loaded once */
+	blob = fu_input_stream_read_bytes(stream, 2, 4, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob);
+	g_assert_cmpint(g_bytes_get_size(blob), ==, 4);
+	g_assert_cmpint(memcmp(g_bytes_get_data(blob, NULL), "3456", 4), ==, 0);
+	g_bytes_unref(blob);
+	blob = fu_input_stream_read_bytes(stream, 6, G_MAXSIZE, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob);
+	g_assert_cmpint(g_bytes_get_size(blob), ==, 2);
+	g_assert_cmpint(cnt, ==, 1);
+	g_assert_true(fu_lazy_input_stream_get_loaded(FU_LAZY_INPUT_STREAM(stream)));
+
+	/* loaded data is not the promised size */
+	stream_error = fu_lazy_input_stream_new(4, fu_lazy_input_stream_load_cb, &cnt, NULL);
+	ret = fu_input_stream_read_safe(stream_error, buf, sizeof(buf), 0x0, 0x0, 1, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_DATA);
+	g_assert_false(ret);
+}
+
 static void
 fu_composite_input_stream_func(void)
 {
@@ -5011,7 +5740,12 @@ fu_lzma_func(void)
 	g_autoptr(GByteArray) buf_in = g_byte_array_new();
 	g_autoptr(GBytes) blob_in = NULL;
 	g_autoptr(GBytes) blob_orig = NULL;
+	g_autoptr(GBytes) blob_orig2 = NULL;
+	g_autoptr(GBytes) blob_orig3 = NULL;
 	g_autoptr(GBytes) blob_out = NULL;
+	g_autoptr(GBytes) blob_trunc = NULL;
+	g_autoptr(GInputStream) stream_orig = NULL;
+	g_autoptr(GInputStream) stream_out = NULL;
 	g_autoptr(GError) error = NULL;
 
 #ifndef HAVE_LZMA
@@ -5039,6 +5773,91 @@ fu_lzma_func(void)
 	ret = fu_bytes_compare(blob_in, blob_orig, &error);
 	g_assert_no_error(error);
 	g_assert_true(ret);
+
+	/* decompress as a stream */
+	stream_out = g_memory_input_stream_new_from_bytes(blob_out);
+	stream_orig = fu_lzma_decompress_stream(stream_out, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(stream_orig);
+	blob_orig2 = fu_input_stream_read_bytes(stream_orig, 0x0, G_MAXSIZE, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_orig2);
+	ret = fu_bytes_compare(blob_in, blob_orig2, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* truncated */
+	blob_trunc = g_bytes_new_from_bytes(blob_out, 0, g_bytes_get_size(blob_out) / 2);
+	blob_orig3 = fu_lzma_decompress_bytes(blob_trunc, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED);
+	g_assert_null(blob_orig3);
+}
+
+static void
+fu_efi_section_lzma_func(void)
+{
+	gboolean ret;
+	const gchar *xml_inner = "<firmware gtype=\"FuEfiSection\">\n"
+				 "  <type>0x19</type>\n"
+				 "  <data>aGVsbG8gd29ybGQ=</data>\n"
+				 "</firmware>\n";
+	const gchar *xml_outer = "<firmware gtype=\"FuEfiSection\">\n"
+				 "  <type>0x02</type>\n"
+				 "  <id>" FU_EFI_SECTION_GUID_LZMA_COMPRESS "</id>\n"
+				 "</firmware>\n";
+	g_autofree gchar *xml = NULL;
+	g_autoptr(FuFirmware) section_inner = fu_efi_section_new();
+	g_autoptr(FuFirmware) section_outer = fu_efi_section_new();
+	g_autoptr(FuFirmware) section_parsed = fu_efi_section_new();
+	g_autoptr(GBytes) blob_inner = NULL;
+	g_autoptr(GBytes) blob_lzma = NULL;
+	g_autoptr(GBytes) blob_outer = NULL;
+	g_autoptr(GBytes) blob_written = NULL;
+	g_autoptr(GPtrArray) imgs = NULL;
+	g_autoptr(GError) error = NULL;
+
+#ifndef HAVE_LZMA
+	g_test_skip("not compiled with lzma support");
+	return;
+#endif
+
+	/* a raw section compressed inside a GUID-defined section */
+	ret = fu_firmware_build_from_xml(section_inner, xml_inner, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	blob_inner = fu_firmware_write(section_inner, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_inner);
+	blob_lzma = fu_lzma_compress_bytes(blob_inner, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_lzma);
+	ret = fu_firmware_build_from_xml(section_outer, xml_outer, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fu_firmware_set_bytes(section_outer, blob_lzma);
+	blob_outer = fu_firmware_write(section_outer, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_outer);
+
+	/* parse */
+	ret = fu_firmware_parse(section_parsed, blob_outer, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	imgs = fu_firmware_get_images(section_parsed);
+	g_assert_cmpint(imgs->len, ==, 1);
+
+	/* the compressed data can still be read after parsing */
+	blob_written = fu_firmware_write(section_parsed, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_written);
+	ret = fu_bytes_compare(blob_written, blob_outer, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	xml = fu_firmware_export_to_xml(section_parsed,
+					FU_FIRMWARE_EXPORT_FLAG_INCLUDE_DEBUG,
+					&error);
+	g_assert_no_error(error);
+	g_assert_nonnull(xml);
 }
 
 static void
@@ -5174,6 +5993,9 @@ fu_plugin_struct_func(void)
 	g_autoptr(GByteArray) st = fu_struct_self_test_new();
 	g_autoptr(GByteArray) st2 = NULL;
 	g_autoptr(GByteArray) st3 = NULL;
+	g_autoptr(GByteArray) buf = NULL;
+	g_autoptr(GPtrArray) array = NULL;
+	g_autoptr(GPtrArray) array_invalid = NULL;
 	g_autoptr(GError) error = NULL;
 	g_autofree gchar *str1 = NULL;
 	g_autofree gchar *str2 = NULL;
@@ -5190,6 +6012,11 @@ fu_plugin_struct_func(void)
 	g_assert_true(ret);
 	g_assert_cmpint(fu_struct_self_test_get_revision(st), ==, 0xFF);
 	g_assert_cmpint(fu_struct_self_test_get_length(st), ==, 0xDEAD);
+	g_assert_cmpint(fu_struct_self_test_get_signature_unchecked(st), ==, 0x12345678);
+	g_assert_cmpint(fu_struct_self_test_get_length_unchecked(st), ==, 0xDEAD);
+	fu_struct_self_test_set_oem_revision_unchecked(st, 0x1);
+	g_assert_cmpint(fu_struct_self_test_get_oem_revision(st), ==, 0x1);
+	fu_struct_self_test_set_oem_revision(st, 0x0);
 
 	/* pack */
 	str1 = fu_byte_array_to_string(st);
@@ -5207,6 +6034,28 @@ fu_plugin_struct_func(void)
 	oem_table_id = fu_struct_self_test_get_oem_table_id(st2);
 	g_assert_cmpstr(oem_table_id, ==, "X");
 
+	/* parse into existing storage */
+	fu_struct_self_test_set_revision(st2, 0x0);
+	ret = fu_struct_self_test_parse_into(st2, st->data, st->len, 0x0, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(st2->len, ==, 51);
+	g_assert_cmpint(fu_struct_self_test_get_revision(st2), ==, 0xFF);
+
+	/* parse array */
+	buf = g_byte_array_new();
+	g_byte_array_append(buf, st->data, st->len);
+	g_byte_array_append(buf, st->data, st->len);
+	array = fu_struct_self_test_parse_array(buf->data, buf->len, 0x0, 2, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(array);
+	g_assert_cmpint(array->len, ==, 2);
+	g_assert_cmpint(fu_struct_self_test_get_length(g_ptr_array_index(array, 1)), ==, 0xDEAD);
+	array_invalid = fu_struct_self_test_parse_array(buf->data, buf->len, 0x0, 3, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_READ);
+	g_assert_null(array_invalid);
+	g_clear_error(&error);
+
 	/* to string */
 	str2 = fu_struct_self_test_to_string(st);
 	g_assert_cmpstr(str2,
@@ -5360,11 +6209,13 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/input-stream{chunkify}", fu_input_stream_chunkify_func);
 	g_test_add_func("/fwupd/partial-input-stream", fu_partial_input_stream_func);
 	g_test_add_func("/fwupd/composite-input-stream", fu_composite_input_stream_func);
+	g_test_add_func("/fwupd/lazy-input-stream", fu_lazy_input_stream_func);
 	g_test_add_func("/fwupd/struct", fu_plugin_struct_func);
 	g_test_add_func("/fwupd/struct{wrapped}", fu_plugin_struct_wrapped_func);
 	g_test_add_func("/fwupd/plugin{quirks-append}", fu_plugin_quirks_append_func);
 	g_test_add_func("/fwupd/string{password-mask}", fu_strpassmask_func);
 	g_test_add_func("/fwupd/lzma", fu_lzma_func);
+	g_test_add_func("/fwupd/efi-section{lzma}", fu_efi_section_lzma_func);
 	g_test_add_func("/fwupd/common{strnsplit}", fu_strsplit_func);
 	g_test_add_func("/fwupd/common{olson-timezone-id}", fu_common_olson_timezone_id_func);
 	g_test_add_func("/fwupd/common{memmem}", fu_common_memmem_func);
@@ -5397,6 +6248,9 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/backend", fu_backend_func);
 	g_test_add_func("/fwupd/chunk", fu_chunk_func);
 	g_test_add_func("/fwupd/chunks", fu_chunk_array_func);
+	g_test_add_func("/fwupd/flash-pipeline", fu_flash_pipeline_func);
+	g_test_add_func("/fwupd/flash-pipeline{verify-unsupported}",
+			fu_flash_pipeline_verify_unsupported_func);
 	g_test_add_func("/fwupd/common{align-up}", fu_common_align_up_func);
 	g_test_add_func("/fwupd/volume{gpt-type}", fu_volume_gpt_type_func);
 	g_test_add_func("/fwupd/common{byte-array}", fu_common_byte_array_func);
@@ -5419,6 +6273,7 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/context{flags}", fu_context_flags_func);
 	g_test_add_func("/fwupd/context{hwids-dmi}", fu_context_hwids_dmi_func);
 	g_test_add_func("/fwupd/context{firmware-gtypes}", fu_context_firmware_gtypes_func);
+	g_test_add_func("/fwupd/context{firmware-cache}", fu_context_firmware_cache_func);
 	g_test_add_func("/fwupd/context{state}", fu_context_state_func);
 	g_test_add_func("/fwupd/string{utf16}", fu_string_utf16_func);
 	g_test_add_func("/fwupd/smbios", fu_smbios_func);
@@ -5431,6 +6286,7 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/firmware{common}", fu_firmware_common_func);
 	g_test_add_func("/fwupd/firmware{csv}", fu_firmware_csv_func);
 	g_test_add_func("/fwupd/firmware{archive}", fu_firmware_archive_func);
+	g_test_add_func("/fwupd/firmware{cab-lazy}", fu_firmware_cab_lazy_func);
 	g_test_add_func("/fwupd/firmware{linear}", fu_firmware_linear_func);
 	g_test_add_func("/fwupd/firmware{dedupe}", fu_firmware_dedupe_func);
 	g_test_add_func("/fwupd/firmware{build}", fu_firmware_build_func);
@@ -5448,6 +6304,7 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/firmware{dfu}", fu_firmware_dfu_func);
 	g_test_add_func("/fwupd/firmware{dfu-patch}", fu_firmware_dfu_patch_func);
 	g_test_add_func("/fwupd/firmware{dfuse}", fu_firmware_dfuse_func);
+	g_test_add_func("/fwupd/firmware{ifd-bios}", fu_firmware_ifd_bios_func);
 	g_test_add_func("/fwupd/firmware{builder-round-trip}", fu_firmware_builder_round_trip_func);
 	g_test_add_func("/fwupd/firmware{fmap}", fu_firmware_fmap_func);
 	g_test_add_func("/fwupd/firmware{gtypes}", fu_firmware_new_from_gtypes_func);
@@ -5476,7 +6333,12 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/device{retry-success}", fu_device_retry_success_func);
 	g_test_add_func("/fwupd/device{retry-failed}", fu_device_retry_failed_func);
 	g_test_add_func("/fwupd/device{retry-hardware}", fu_device_retry_hardware_func);
+	g_test_add_func("/fwupd/device{retry-backoff}", fu_device_retry_backoff_func);
+	g_test_add_func("/fwupd/device{wait-readable}", fu_device_wait_readable_func);
+	g_test_add_func("/fwupd/device{verify-checksum}", fu_device_verify_checksum_func);
 	g_test_add_func("/fwupd/device{cfi-device}", fu_device_cfi_device_func);
+	g_test_add_func("/fwupd/device{cfi-device-differential}",
+			fu_device_cfi_device_differential_func);
 	g_test_add_func("/fwupd/device{progress}", fu_plugin_device_progress_func);
 	return g_test_run();
 }
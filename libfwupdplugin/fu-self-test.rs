@@ -7,7 +7,7 @@ enum FuSelfTestRevision {
     All	= 0xF_F,
 }
 
-#[derive(New, Validate, Parse, ToString)]
+#[derive(New, Validate, Parse, ParseInto, ParseArray, ToString, Unchecked)]
 struct FuStructSelfTest {
     signature: u32be == 0x1234_5678,
     length: u32le = $struct_size, // bytes
@@ -130,11 +130,15 @@ fu_uswid_firmware_parse(FuFirmware *firmware,
 		if (payload == NULL)
 			return FALSE;
 	} else if (priv->compression == FU_USWID_PAYLOAD_COMPRESSION_LZMA) {
-		g_autoptr(GBytes) payload_tmp = NULL;
-		payload_tmp = fu_input_stream_read_bytes(stream, offset + hdrsz, payloadsz, error);
-		if (payload_tmp == NULL)
+		g_autoptr(GInputStream) istream1 = NULL;
+		g_autoptr(GInputStream) istream2 = NULL;
+		istream1 = fu_partial_input_stream_new(stream, offset + hdrsz, payloadsz, error);
+		if (istream1 == NULL)
+			return FALSE;
+		istream2 = fu_lzma_decompress_stream(istream1, error);
+		if (istream2 == NULL)
 			return FALSE;
-		payload = fu_lzma_decompress_bytes(payload_tmp, error);
+		payload = fu_input_stream_read_bytes(istream2, 0, G_MAXSIZE, error);
 		if (payload == NULL)
 			return FALSE;
 	} else if (priv->compression == FU_USWID_PAYLOAD_COMPRESSION_NONE) {
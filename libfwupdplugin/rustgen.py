@@ -152,9 +152,12 @@ class StructObj:
             "Parse": Export.NONE,
             "ParseBytes": Export.NONE,
             "ParseStream": Export.NONE,
+            "ParseInto": Export.NONE,
+            "ParseArray": Export.NONE,
             "ParseInternal": Export.NONE,
             "New": Export.NONE,
             "ToString": Export.NONE,
+            "Unchecked": Export.NONE,
         }
 
     def c_method(self, suffix: str):
@@ -207,6 +210,10 @@ class StructObj:
             self.add_private_export("ParseInternal")
         elif derive == "ParseStream":
             self.add_private_export("ParseInternal")
+        elif derive == "ParseInto":
+            self.add_private_export("ParseInternal")
+        elif derive == "ParseArray":
+            self.add_private_export("ParseInternal")
         elif derive == "ParseBytes":
             self.add_private_export("Parse")
         elif derive == "ParseInternal":
@@ -237,7 +244,13 @@ class StructObj:
             self._exports[derive] = Export.PUBLIC
 
         # for convenience
-        if derive in ["Parse", "ParseBytes", "ParseStream"]:
+        if derive in [
+            "Parse",
+            "ParseBytes",
+            "ParseStream",
+            "ParseInto",
+            "ParseArray",
+        ]:
             self.add_public_export("Getters")
         if derive == "New":
             self.add_public_export("Setters")
@@ -355,6 +368,89 @@ class StructItem:
             return "uint64"
         return ""
 
+    @property
+    def type_raw(self) -> str:
+        if self.type == Type.U8:
+            return "guint8"
+        if self.type == Type.U16:
+            return "guint16"
+        if self.type in [Type.U24, Type.U32]:
+            return "guint32"
+        if self.type == Type.U64:
+            return "guint64"
+        return "void"
+
+    def _c_byteswap(self, direction: str, val: str) -> str:
+        if self.endian == Endian.NATIVE:
+            return val
+        width: int = self.size * 8
+        return f"GUINT{width}_{direction}_{self.endian.value.upper()}({val})"
+
+    def _c_u24_read(self, little: bool) -> str:
+        idxs = [0, 1, 2] if little else [2, 1, 0]
+        return " | ".join(
+            f"((guint32) st->data[{self.offset + idx}] << {shift})"
+            for idx, shift in zip(idxs, [0, 8, 16])
+        )
+
+    def _c_u24_write(self, little: bool, indent: int = 4) -> str:
+        idxs = [0, 1, 2] if little else [2, 1, 0]
+        return "\n".join(
+            f"{' ' * indent}st->data[{self.offset + idx}] = (guint8) (value >> {shift});"
+            for idx, shift in zip(idxs, [0, 8, 16])
+        )
+
+    @property
+    def c_getter_body(self) -> str:
+        """the endian-specialised body of an integer getter, with no checks"""
+        if self.type == Type.U8:
+            return f"    return st->data[{self.offset}];"
+        if self.type == Type.U24:
+            if self.endian == Endian.LITTLE:
+                expr = self._c_u24_read(True)
+            elif self.endian == Endian.BIG:
+                expr = self._c_u24_read(False)
+            else:
+                expr = (
+                    f"G_BYTE_ORDER == G_LITTLE_ENDIAN ? {self._c_u24_read(True)} "
+                    f": {self._c_u24_read(False)}"
+                )
+            return f"    return {expr};"
+        cast = f"({self.type_glib}) " if self.enum_obj else ""
+        return "\n".join(
+            [
+                f"    {self.type_raw} val;",
+                f"    memcpy(&val, st->data + {self.offset}, sizeof(val));",
+                f"    return {cast}{self._c_byteswap('FROM', 'val')};",
+            ]
+        )
+
+    @property
+    def c_setter_body(self) -> str:
+        """the endian-specialised body of an integer setter, with no checks"""
+        if self.type == Type.U8:
+            return f"    st->data[{self.offset}] = value;"
+        if self.type == Type.U24:
+            if self.endian == Endian.LITTLE:
+                return self._c_u24_write(True)
+            if self.endian == Endian.BIG:
+                return self._c_u24_write(False)
+            return "\n".join(
+                [
+                    "    if (G_BYTE_ORDER == G_LITTLE_ENDIAN) {",
+                    self._c_u24_write(True, indent=8),
+                    "    } else {",
+                    self._c_u24_write(False, indent=8),
+                    "    }",
+                ]
+            )
+        return "\n".join(
+            [
+                f"    {self.type_raw} val = {self._c_byteswap('TO', 'value')};",
+                f"    memcpy(st->data + {self.offset}, &val, sizeof(val));",
+            ]
+        )
+
     def _parse_default(self, val: str) -> str:
         if self.enum_obj:
             enum_item = self.enum_obj.item(val)
@@ -83,6 +83,51 @@ fu_bcm57xx_verify_magic(GInputStream *stream, gsize offset, GError **error)
 	return TRUE;
 }
 
+/* returns the ranges of @blob_new that differ from @blob_old, as #FuChunk objects that
+ * are page-aligned and no larger than @block_sz */
+GPtrArray *
+fu_bcm57xx_nvram_diff(GBytes *blob_old, GBytes *blob_new, gsize page_sz, gsize block_sz)
+{
+	gsize bufsz_old = 0;
+	gsize bufsz_new = 0;
+	gsize dirty_start = G_MAXSIZE;
+	const guint8 *buf_old = g_bytes_get_data(blob_old, &bufsz_old);
+	const guint8 *buf_new = g_bytes_get_data(blob_new, &bufsz_new);
+	g_autoptr(GPtrArray) chunks = g_ptr_array_new_with_free_func(g_object_unref);
+
+	for (gsize addr = 0; addr < bufsz_new; addr += page_sz) {
+		gsize pagesz = MIN(page_sz, bufsz_new - addr);
+		gboolean dirty = addr + pagesz > bufsz_old ||
+				 memcmp(buf_old + addr, buf_new + addr, pagesz) != 0;
+
+		/* start a new range */
+		if (dirty && dirty_start == G_MAXSIZE)
+			dirty_start = addr;
+
+		/* flush the range if it is now clean, or as big as allowed */
+		if (dirty_start != G_MAXSIZE &&
+		    (!dirty || addr + pagesz - dirty_start >= block_sz)) {
+			gsize end = dirty ? addr + pagesz : addr;
+			g_ptr_array_add(chunks,
+					fu_chunk_new(chunks->len,
+						     0x0,
+						     dirty_start,
+						     buf_new + dirty_start,
+						     end - dirty_start));
+			dirty_start = G_MAXSIZE;
+		}
+	}
+	if (dirty_start != G_MAXSIZE) {
+		g_ptr_array_add(chunks,
+				fu_chunk_new(chunks->len,
+					     0x0,
+					     dirty_start,
+					     buf_new + dirty_start,
+					     bufsz_new - dirty_start));
+	}
+	return g_steal_pointer(&chunks);
+}
+
 void
 fu_bcm57xx_veritem_free(Bcm57xxVeritem *veritem)
 {
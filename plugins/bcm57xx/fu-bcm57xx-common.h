@@ -18,6 +18,8 @@
 
 #define BCM_NVRAM_MAGIC 0x669955AA
 
+#define BCM_NVRAM_PAGE_SZ 0x100
+
 /* offsets into NVMRAM */
 #define BCM_NVRAM_HEADER_BASE	 0x00
 #define BCM_NVRAM_DIRECTORY_BASE 0x14
@@ -62,6 +64,8 @@ gboolean
 fu_bcm57xx_verify_crc(GInputStream *stream, GError **error);
 gboolean
 fu_bcm57xx_verify_magic(GInputStream *stream, gsize offset, GError **error);
+GPtrArray *
+fu_bcm57xx_nvram_diff(GBytes *blob_old, GBytes *blob_new, gsize page_sz, gsize block_sz);
 
 /* parses stage1 version */
 void
@@ -36,6 +36,8 @@ struct _FuBcm57xxDevice {
 	FuUdevDevice parent_instance;
 	gchar *ethtool_iface;
 	int ethtool_fd;
+	guint8 *eeprom_buf; /* reused for each SIOCETHTOOL transfer */
+	gsize eeprom_bufsz;
 };
 
 G_DEFINE_TYPE(FuBcm57xxDevice, fu_bcm57xx_device, FU_TYPE_UDEV_DEVICE)
@@ -55,6 +57,20 @@ fu_bcm57xx_device_probe(FuDevice *device, GError **error)
 	return fu_udev_device_set_physical_id(FU_UDEV_DEVICE(device), "pci", error);
 }
 
+#ifdef HAVE_ETHTOOL_H
+static struct ethtool_eeprom *
+fu_bcm57xx_device_get_eeprom(FuBcm57xxDevice *self, gsize bufsz)
+{
+	gsize eepromsz = sizeof(struct ethtool_eeprom) + bufsz;
+	if (eepromsz > self->eeprom_bufsz) {
+		self->eeprom_buf = g_realloc(self->eeprom_buf, eepromsz);
+		self->eeprom_bufsz = eepromsz;
+	}
+	memset(self->eeprom_buf, 0x0, eepromsz);
+	return (struct ethtool_eeprom *)self->eeprom_buf;
+}
+#endif
+
 static gboolean
 fu_bcm57xx_device_nvram_write(FuBcm57xxDevice *self,
 			      guint32 address,
@@ -63,10 +79,9 @@ fu_bcm57xx_device_nvram_write(FuBcm57xxDevice *self,
 			      GError **error)
 {
 #ifdef HAVE_ETHTOOL_H
-	gsize eepromsz;
 	gint rc = -1;
 	struct ifreq ifr = {0};
-	g_autofree struct ethtool_eeprom *eeprom = NULL;
+	struct ethtool_eeprom *eeprom;
 
 	/* failed to load tg3 */
 	if (self->ethtool_iface == NULL) {
@@ -88,8 +103,7 @@ fu_bcm57xx_device_nvram_write(FuBcm57xxDevice *self,
 	}
 
 	/* write EEPROM (NVRAM) data */
-	eepromsz = sizeof(struct ethtool_eeprom) + bufsz;
-	eeprom = (struct ethtool_eeprom *)g_malloc0(eepromsz);
+	eeprom = fu_bcm57xx_device_get_eeprom(self, bufsz);
 	eeprom->cmd = ETHTOOL_SEEPROM;
 	eeprom->magic = BCM_NVRAM_MAGIC;
 	eeprom->len = bufsz;
@@ -134,10 +148,9 @@ fu_bcm57xx_device_nvram_read(FuBcm57xxDevice *self,
 			     GError **error)
 {
 #ifdef HAVE_ETHTOOL_H
-	gsize eepromsz;
 	gint rc = -1;
 	struct ifreq ifr = {0};
-	g_autofree struct ethtool_eeprom *eeprom = NULL;
+	struct ethtool_eeprom *eeprom;
 
 	/* failed to load tg3 */
 	if (self->ethtool_iface == NULL) {
@@ -159,8 +172,7 @@ fu_bcm57xx_device_nvram_read(FuBcm57xxDevice *self,
 	}
 
 	/* read EEPROM (NVRAM) data */
-	eepromsz = sizeof(struct ethtool_eeprom) + bufsz;
-	eeprom = (struct ethtool_eeprom *)g_malloc0(eepromsz);
+	eeprom = fu_bcm57xx_device_get_eeprom(self, bufsz);
 	eeprom->cmd = ETHTOOL_GEEPROM;
 	eeprom->len = bufsz;
 	eeprom->offset = address;
@@ -188,8 +200,8 @@ fu_bcm57xx_device_nvram_read(FuBcm57xxDevice *self,
 	if (!fu_memcpy_safe(buf,
 			    bufsz,
 			    0x0, /* dst */
-			    (guint8 *)eeprom,
-			    eepromsz, /* src */
+			    self->eeprom_buf,
+			    self->eeprom_bufsz, /* src */
 			    G_STRUCT_OFFSET(struct ethtool_eeprom, data),
 			    bufsz,
 			    error))
@@ -404,25 +416,23 @@ fu_bcm57xx_device_prepare_firmware(FuDevice *device,
 	str_proposed = fu_firmware_to_string(firmware);
 	g_info("proposed device firmware: %s", str_proposed);
 
+	/* keep the existing NVRAM so that only the changed pages are written */
+	fu_firmware_set_bytes(firmware, fw_old);
+
 	/* success */
 	return g_steal_pointer(&firmware);
 }
 
 static gboolean
 fu_bcm57xx_device_write_chunks(FuBcm57xxDevice *self,
-			       FuChunkArray *chunks,
+			       GPtrArray *chunks,
 			       FuProgress *progress,
 			       GError **error)
 {
 	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_set_steps(progress, fu_chunk_array_length(chunks));
-	for (guint i = 0; i < fu_chunk_array_length(chunks); i++) {
-		g_autoptr(FuChunk) chk = NULL;
-
-		/* prepare chunk */
-		chk = fu_chunk_array_index(chunks, i, error);
-		if (chk == NULL)
-			return FALSE;
+	fu_progress_set_steps(progress, chunks->len);
+	for (guint i = 0; i < chunks->len; i++) {
+		FuChunk *chk = g_ptr_array_index(chunks, i);
 		if (!fu_bcm57xx_device_nvram_write(self,
 						   fu_chunk_get_address(chk),
 						   fu_chunk_get_data(chk),
@@ -443,8 +453,9 @@ fu_bcm57xx_device_write_firmware(FuDevice *device,
 {
 	FuBcm57xxDevice *self = FU_BCM57XX_DEVICE(device);
 	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GBytes) blob_old = NULL;
 	g_autoptr(GBytes) blob_verify = NULL;
-	g_autoptr(FuChunkArray) chunks = NULL;
+	g_autoptr(GPtrArray) chunks = NULL;
 
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
@@ -459,8 +470,14 @@ fu_bcm57xx_device_write_firmware(FuDevice *device,
 		return FALSE;
 	fu_progress_step_done(progress);
 
-	/* hit hardware */
-	chunks = fu_chunk_array_new_from_bytes(blob, 0x0, FU_BCM57XX_BLOCK_SZ);
+	/* the NVRAM was already read when merging the images */
+	blob_old = fu_firmware_get_bytes(firmware, error);
+	if (blob_old == NULL)
+		return FALSE;
+
+	/* hit hardware, only writing the pages that have changed */
+	chunks = fu_bcm57xx_nvram_diff(blob_old, blob, BCM_NVRAM_PAGE_SZ, FU_BCM57XX_BLOCK_SZ);
+	g_debug("writing %u changed ranges", chunks->len);
 	if (!fu_bcm57xx_device_write_chunks(self, chunks, fu_progress_get_child(progress), error))
 		return FALSE;
 	fu_progress_step_done(progress);
@@ -657,6 +674,7 @@ fu_bcm57xx_device_finalize(GObject *object)
 {
 	FuBcm57xxDevice *self = FU_BCM57XX_DEVICE(object);
 	g_free(self->ethtool_iface);
+	g_free(self->eeprom_buf);
 	G_OBJECT_CLASS(fu_bcm57xx_device_parent_class)->finalize(object);
 }
 
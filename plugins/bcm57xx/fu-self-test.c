@@ -50,6 +50,46 @@ fu_bcm57xx_common_veritem_func(void)
 	g_assert_cmpint(veritem3->verfmt, ==, FWUPD_VERSION_FORMAT_UNKNOWN);
 }
 
+static void
+fu_bcm57xx_common_nvram_diff_func(void)
+{
+	FuChunk *chk;
+	guint8 buf_old[0x1000] = {0x0};
+	guint8 buf_new[0x1000] = {0x0};
+	g_autoptr(GBytes) blob_old = NULL;
+	g_autoptr(GBytes) blob_new = NULL;
+	g_autoptr(GBytes) blob_same = NULL;
+	g_autoptr(GPtrArray) chunks1 = NULL;
+	g_autoptr(GPtrArray) chunks2 = NULL;
+
+	/* nothing to do */
+	blob_old = g_bytes_new(buf_old, sizeof(buf_old));
+	blob_same = g_bytes_new(buf_new, sizeof(buf_new));
+	chunks1 = fu_bcm57xx_nvram_diff(blob_old, blob_same, 0x100, 0x400);
+	g_assert_cmpint(chunks1->len, ==, 0);
+
+	/* one byte in page 0x1, pages 0x4 to 0x9, and the last byte */
+	buf_new[0x180] = 0xFF;
+	memset(buf_new + 0x400, 0xFF, 0x600);
+	buf_new[0xFFF] = 0xFF;
+	blob_new = g_bytes_new(buf_new, sizeof(buf_new));
+	chunks2 = fu_bcm57xx_nvram_diff(blob_old, blob_new, 0x100, 0x400);
+	g_assert_cmpint(chunks2->len, ==, 4);
+	chk = g_ptr_array_index(chunks2, 0);
+	g_assert_cmpint(fu_chunk_get_address(chk), ==, 0x100);
+	g_assert_cmpint(fu_chunk_get_data_sz(chk), ==, 0x100);
+	chk = g_ptr_array_index(chunks2, 1);
+	g_assert_cmpint(fu_chunk_get_address(chk), ==, 0x400);
+	g_assert_cmpint(fu_chunk_get_data_sz(chk), ==, 0x400);
+	chk = g_ptr_array_index(chunks2, 2);
+	g_assert_cmpint(fu_chunk_get_address(chk), ==, 0x800);
+	g_assert_cmpint(fu_chunk_get_data_sz(chk), ==, 0x200);
+	chk = g_ptr_array_index(chunks2, 3);
+	g_assert_cmpint(fu_chunk_get_address(chk), ==, 0xF00);
+	g_assert_cmpint(fu_chunk_get_data_sz(chk), ==, 0x100);
+	g_assert_cmpint(fu_chunk_get_data(chk)[0xFF], ==, 0xFF);
+}
+
 static void
 fu_bcm57xx_firmware_talos_func(void)
 {
@@ -142,5 +182,6 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/bcm57xx/firmware{xml}", fu_bcm57xx_firmware_xml_func);
 	g_test_add_func("/fwupd/bcm57xx/firmware{talos}", fu_bcm57xx_firmware_talos_func);
 	g_test_add_func("/fwupd/bcm57xx/common{veritem}", fu_bcm57xx_common_veritem_func);
+	g_test_add_func("/fwupd/bcm57xx/common{nvram-diff}", fu_bcm57xx_common_nvram_diff_func);
 	return g_test_run();
 }
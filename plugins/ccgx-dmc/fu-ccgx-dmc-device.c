@@ -413,7 +413,6 @@ fu_ccgx_dmc_get_image_write_status_cb(FuDevice *device, gpointer user_data, GErr
 			    FWUPD_ERROR_NOT_SUPPORTED,
 			    "invalid intr req data in image write status = %u",
 			    req_data[0]);
-		fu_device_sleep(device, DMC_FW_WRITE_STATUS_RETRY_DELAY_MS);
 		return FALSE;
 	}
 	return TRUE;
@@ -456,12 +455,16 @@ fu_ccgx_dmc_write_firmware_record(FuCcgxDmcDevice *self,
 		/* increase fw written size */
 		*fw_data_written += row_size;
 
-		/* get status */
-		if (!fu_device_retry(FU_DEVICE(self),
-				     fu_ccgx_dmc_get_image_write_status_cb,
-				     DMC_FW_WRITE_STATUS_RETRY_COUNT,
-				     NULL,
-				     error))
+		/* get status, allowing each interrupt read to time out */
+		if (!fu_device_retry_backoff(FU_DEVICE(self),
+					     fu_ccgx_dmc_get_image_write_status_cb,
+					     DMC_FW_WRITE_STATUS_RETRY_COUNT *
+						 DMC_GET_REQUEST_TIMEOUT,
+					     1,
+					     DMC_FW_WRITE_STATUS_RETRY_DELAY_MS,
+					     FU_DEVICE_RETRY_FLAG_BACKOFF,
+					     NULL,
+					     error))
 			return FALSE;
 
 		/* done */
@@ -6,6 +6,8 @@
 
 #include "config.h"
 
+#include <fwupdplugin.h>
+
 #include <string.h>
 
 #include "fu-dfu-common.h"
@@ -45,3 +47,70 @@ fu_dfu_utils_bytes_join_array(GPtrArray *chunks)
 	}
 	return g_bytes_new_take(buffer, total_size);
 }
+
+static void
+fu_dfu_utils_chunks_coalesce_flush(GPtrArray *chunks, GPtrArray *blobs, gsize address)
+{
+	FuChunk *chk;
+	g_autoptr(GBytes) blob = NULL;
+
+	if (blobs->len == 0)
+		return;
+	blob = fu_dfu_utils_bytes_join_array(blobs);
+	chk = fu_chunk_bytes_new(blob);
+	fu_chunk_set_idx(chk, chunks->len);
+	fu_chunk_set_address(chk, address);
+	g_ptr_array_add(chunks, chk);
+	g_ptr_array_set_size(blobs, 0);
+}
+
+/**
+ * fu_dfu_utils_chunks_coalesce:
+ * @chunks: (element-type FuChunk): chunks
+ *
+ * Joins each chunk that starts at the address where the previous chunk ends.
+ *
+ * Returns: (transfer container) (element-type FuChunk): chunks
+ **/
+GPtrArray *
+fu_dfu_utils_chunks_coalesce(GPtrArray *chunks)
+{
+	gsize address = 0;
+	gsize address_next = G_MAXSIZE;
+	g_autoptr(GPtrArray) blobs = g_ptr_array_new_with_free_func((GDestroyNotify)g_bytes_unref);
+	g_autoptr(GPtrArray) chunks_new = g_ptr_array_new_with_free_func(g_object_unref);
+
+	for (guint i = 0; i < chunks->len; i++) {
+		FuChunk *chk = g_ptr_array_index(chunks, i);
+		if (fu_chunk_get_address(chk) != address_next)
+			fu_dfu_utils_chunks_coalesce_flush(chunks_new, blobs, address);
+		if (blobs->len == 0)
+			address = fu_chunk_get_address(chk);
+		g_ptr_array_add(blobs, fu_chunk_get_bytes(chk));
+		address_next = fu_chunk_get_address(chk) + fu_chunk_get_data_sz(chk);
+	}
+	fu_dfu_utils_chunks_coalesce_flush(chunks_new, blobs, address);
+	return g_steal_pointer(&chunks_new);
+}
+
+#define FU_DFU_UTILS_POLL_STATUS_DELAY_MIN 5 /* ms */
+
+/**
+ * fu_dfu_utils_poll_status_delay:
+ * @delay: the previous delay in ms, or 0 for the first
+ * @poll_timeout: the bwPollTimeout in ms reported by the device
+ *
+ * Gets the delay before polling GetStatus again, which starts short and then doubles, but
+ * never exceeds the time the device asked for.
+ *
+ * Returns: delay in ms
+ **/
+guint
+fu_dfu_utils_poll_status_delay(guint delay, guint poll_timeout)
+{
+	if (delay == 0)
+		return MIN(FU_DFU_UTILS_POLL_STATUS_DELAY_MIN, poll_timeout);
+	if (delay >= poll_timeout / 2)
+		return poll_timeout;
+	return delay * 2;
+}
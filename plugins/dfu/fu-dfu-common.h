@@ -153,7 +153,17 @@
  * Requires Force Detach in wIndex to bypass status checking.
  */
 #define FU_DFU_DEVICE_FLAG_INDEX_FORCE_DETACH (1ull << (8 + 19))
+/**
+ * FU_DFU_DEVICE_FLAG_POLL_STATUS:
+ *
+ * Poll GetStatus with a short increasing delay rather than waiting for the full bwPollTimeout.
+ */
+#define FU_DFU_DEVICE_FLAG_POLL_STATUS (1ull << (8 + 20))
 
 /* helpers */
 GBytes *
 fu_dfu_utils_bytes_join_array(GPtrArray *chunks);
+GPtrArray *
+fu_dfu_utils_chunks_coalesce(GPtrArray *chunks);
+guint
+fu_dfu_utils_poll_status_delay(guint delay, guint poll_timeout);
@@ -1643,4 +1643,7 @@ fu_dfu_device_init(FuDfuDevice *self)
 	fu_device_register_private_flag(FU_DEVICE(self),
 					FU_DFU_DEVICE_FLAG_INDEX_FORCE_DETACH,
 					"index-force-detach");
+	fu_device_register_private_flag(FU_DEVICE(self),
+					FU_DFU_DEVICE_FLAG_POLL_STATUS,
+					"poll-status");
 }
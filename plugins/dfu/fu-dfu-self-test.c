@@ -9,6 +9,7 @@
 #include <string.h>
 
 #include "fu-context-private.h"
+#include "fu-dfu-common.h"
 #include "fu-dfu-device.h"
 #include "fu-dfu-sector.h"
 #include "fu-dfu-target-private.h"
@@ -49,6 +50,51 @@ fu_dfu_target_sectors_to_string(FuDfuTarget *target)
 	return g_string_free(str, FALSE);
 }
 
+static void
+fu_dfu_utils_chunks_coalesce_func(void)
+{
+	FuChunk *chk;
+	g_autoptr(GPtrArray) chunks = g_ptr_array_new_with_free_func(g_object_unref);
+	g_autoptr(GPtrArray) chunks_new = NULL;
+	g_autoptr(GBytes) blob = NULL;
+
+	/* two contiguous elements, then one after a gap */
+	g_ptr_array_add(chunks, fu_chunk_new(0, 0, 0x08000000, (const guint8 *)"abc", 3));
+	g_ptr_array_add(chunks, fu_chunk_new(1, 0, 0x08000003, (const guint8 *)"def", 3));
+	g_ptr_array_add(chunks, fu_chunk_new(2, 0, 0x08001000, (const guint8 *)"xyz", 3));
+	chunks_new = fu_dfu_utils_chunks_coalesce(chunks);
+	g_assert_cmpint(chunks_new->len, ==, 2);
+	chk = g_ptr_array_index(chunks_new, 0);
+	g_assert_cmpint(fu_chunk_get_address(chk), ==, 0x08000000);
+	g_assert_cmpint(fu_chunk_get_data_sz(chk), ==, 6);
+	blob = fu_chunk_get_bytes(chk);
+	g_assert_cmpint(memcmp(g_bytes_get_data(blob, NULL), "abcdef", 6), ==, 0);
+	chk = g_ptr_array_index(chunks_new, 1);
+	g_assert_cmpint(fu_chunk_get_address(chk), ==, 0x08001000);
+	g_assert_cmpint(fu_chunk_get_data_sz(chk), ==, 3);
+}
+
+static void
+fu_dfu_utils_poll_status_delay_func(void)
+{
+	guint delay = 0;
+	const guint delays[] = {5, 10, 20, 40, 80, 100, 100};
+
+	/* doubles, up to bwPollTimeout */
+	for (guint i = 0; i < G_N_ELEMENTS(delays); i++) {
+		delay = fu_dfu_utils_poll_status_delay(delay, 100);
+		g_assert_cmpint(delay, ==, delays[i]);
+	}
+
+	/* shorter than the minimum delay */
+	g_assert_cmpint(fu_dfu_utils_poll_status_delay(0, 3), ==, 3);
+	g_assert_cmpint(fu_dfu_utils_poll_status_delay(3, 3), ==, 3);
+	g_assert_cmpint(fu_dfu_utils_poll_status_delay(0, 0), ==, 0);
+
+	/* never overflows */
+	g_assert_cmpint(fu_dfu_utils_poll_status_delay(G_MAXUINT - 1, G_MAXUINT), ==, G_MAXUINT);
+}
+
 static void
 fu_dfu_target_dfuse_func(void)
 {
@@ -159,5 +205,7 @@ main(int argc, char **argv)
 
 	/* tests go here */
 	g_test_add_func("/dfu/target(DfuSe}", fu_dfu_target_dfuse_func);
+	g_test_add_func("/dfu/utils{chunks-coalesce}", fu_dfu_utils_chunks_coalesce_func);
+	g_test_add_func("/dfu/utils{poll-status-delay}", fu_dfu_utils_poll_status_delay_func);
 	return g_test_run();
 }
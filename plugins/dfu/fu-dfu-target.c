@@ -402,32 +402,48 @@ fu_dfu_target_status_to_error_msg(FuDfuStatus status)
 }
 
 static gboolean
-fu_dfu_target_manifest_wait(FuDfuTarget *self, GError **error)
+fu_dfu_target_manifest_wait_cb(FuDevice *device, gpointer user_data, GError **error)
 {
-	FuDfuDevice *device = FU_DFU_DEVICE(fu_device_get_proxy(FU_DEVICE(self)));
-	guint polling_count = 0;
-
-	/* get the status */
-	if (!fu_dfu_device_refresh(device, 0, error))
-		return FALSE;
+	FuDfuDevice *dfu_device = FU_DFU_DEVICE(device);
 
 	/* wait for FU_DFU_STATE_DFU_MANIFEST to not be set */
-	while (fu_dfu_device_get_state(device) == FU_DFU_STATE_DFU_MANIFEST_SYNC ||
-	       fu_dfu_device_get_state(device) == FU_DFU_STATE_DFU_MANIFEST) {
-		g_debug("waiting for FU_DFU_STATE_DFU_MANIFEST to clear");
-
-		if (polling_count++ > DFU_TARGET_MANIFEST_MAX_POLLING_TRIES) {
-			g_set_error_literal(error,
-					    FWUPD_ERROR,
-					    FWUPD_ERROR_INTERNAL,
-					    "reach to max polling tries");
-			return FALSE;
-		}
+	if (!fu_dfu_device_refresh(dfu_device, 0, error))
+		return FALSE;
+	if (fu_dfu_device_get_state(dfu_device) == FU_DFU_STATE_DFU_MANIFEST_SYNC ||
+	    fu_dfu_device_get_state(dfu_device) == FU_DFU_STATE_DFU_MANIFEST) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_BUSY,
+				    "waiting for FU_DFU_STATE_DFU_MANIFEST to clear");
+		return FALSE;
+	}
+	return TRUE;
+}
 
-		fu_device_sleep(FU_DEVICE(device),
-				fu_dfu_device_get_download_timeout(device) + 1000);
-		if (!fu_dfu_device_refresh(device, 0, error))
-			return FALSE;
+static gboolean
+fu_dfu_target_manifest_wait(FuDfuTarget *self, GError **error)
+{
+	FuDfuDevice *device = FU_DFU_DEVICE(fu_device_get_proxy(FU_DEVICE(self)));
+	guint download_timeout = fu_dfu_device_get_download_timeout(device);
+	guint delay_max = MIN(download_timeout + 1000, 99999);
+	guint delay_min = delay_max;
+	FuDeviceRetryFlags flags = FU_DEVICE_RETRY_FLAG_NONE;
+
+	/* the device is often ready after bwPollTimeout, so only add the extra second later */
+	if (fu_device_has_private_flag(FU_DEVICE(device), FU_DFU_DEVICE_FLAG_POLL_STATUS)) {
+		delay_min = MIN(download_timeout, delay_max);
+		flags |= FU_DEVICE_RETRY_FLAG_FAST_FIRST;
+	}
+	if (!fu_device_retry_backoff(FU_DEVICE(device),
+				     fu_dfu_target_manifest_wait_cb,
+				     delay_max * DFU_TARGET_MANIFEST_MAX_POLLING_TRIES,
+				     delay_min,
+				     delay_max,
+				     flags,
+				     NULL,
+				     error)) {
+		g_prefix_error(error, "reached max polling tries: ");
+		return FALSE;
 	}
 
 	/* in an error state */
@@ -443,11 +459,22 @@ fu_dfu_target_manifest_wait(FuDfuTarget *self, GError **error)
 	return TRUE;
 }
 
+/* some devices report a very conservative bwPollTimeout, but not all devices cope with
+ * GetStatus being sent early and so this has to be opted into */
+static gboolean
+fu_dfu_target_can_poll_status(FuDfuTarget *self)
+{
+	FuDfuDevice *device = FU_DFU_DEVICE(fu_device_get_proxy(FU_DEVICE(self)));
+	return fu_device_has_private_flag(FU_DEVICE(device), FU_DFU_DEVICE_FLAG_POLL_STATUS);
+}
+
 gboolean
 fu_dfu_target_check_status(FuDfuTarget *self, GError **error)
 {
 	FuDfuDevice *device = FU_DFU_DEVICE(fu_device_get_proxy(FU_DEVICE(self)));
 	FuDfuStatus status;
+	gboolean poll_status = fu_dfu_target_can_poll_status(self);
+	guint delay = 0;
 	g_autoptr(GTimer) timer = g_timer_new();
 
 	/* get the status */
@@ -456,9 +483,20 @@ fu_dfu_target_check_status(FuDfuTarget *self, GError **error)
 
 	/* wait for dfuDNBUSY to not be set */
 	while (fu_dfu_device_get_state(device) == FU_DFU_STATE_DFU_DNBUSY) {
+		guint timeout_ms = 0;
 		g_debug("waiting for FU_DFU_STATE_DFU_DNBUSY to clear");
-		fu_device_sleep(FU_DEVICE(device), fu_dfu_device_get_download_timeout(device));
-		if (!fu_dfu_device_refresh(device, 0, error))
+		if (poll_status) {
+			delay = fu_dfu_utils_poll_status_delay(
+			    delay,
+			    fu_dfu_device_get_download_timeout(device));
+			fu_device_sleep(FU_DEVICE(device), delay);
+			timeout_ms = fu_dfu_device_get_timeout(device) +
+				     fu_dfu_device_get_download_timeout(device);
+		} else {
+			fu_device_sleep(FU_DEVICE(device),
+					fu_dfu_device_get_download_timeout(device));
+		}
+		if (!fu_dfu_device_refresh(device, timeout_ms, error))
 			return FALSE;
 		/* this is a really long time to save fwupd in case
 		 * the device has got wedged */
@@ -707,7 +745,8 @@ fu_dfu_target_download_chunk(FuDfuTarget *self,
 	/* wait for the device to write contents to the EEPROM */
 	if (buf->len == 0 && fu_dfu_device_get_download_timeout(device) > 0)
 		fu_progress_set_status(progress, FWUPD_STATUS_DEVICE_BUSY);
-	if (fu_dfu_device_get_download_timeout(device) > 0) {
+	if (fu_dfu_device_get_download_timeout(device) > 0 &&
+	    !fu_dfu_target_can_poll_status(self)) {
 		g_debug("sleeping for %ums…", fu_dfu_device_get_download_timeout(device));
 		fu_device_sleep(FU_DEVICE(device), fu_dfu_device_get_download_timeout(device));
 	}
@@ -1210,6 +1249,16 @@ fu_dfu_target_download(FuDfuTarget *self,
 				    "no image chunks");
 		return FALSE;
 	}
+
+	/* DfuSe erases whole sectors, so contiguous elements have to be written together -- which
+	 * also means fewer set-address requests and fewer short transfers */
+	if (fu_dfu_device_get_version(FU_DFU_DEVICE(device)) == FU_DFU_FIRMARE_VERSION_DFUSE) {
+		g_autoptr(GPtrArray) chunks_tmp = fu_dfu_utils_chunks_coalesce(chunks);
+		if (chunks_tmp->len != chunks->len)
+			g_debug("coalesced %u elements into %u", chunks->len, chunks_tmp->len);
+		g_ptr_array_unref(chunks);
+		chunks = g_steal_pointer(&chunks_tmp);
+	}
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_set_steps(progress, chunks->len);
 	for (guint i = 0; i < chunks->len; i++) {
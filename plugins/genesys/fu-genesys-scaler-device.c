@@ -1156,12 +1156,14 @@ fu_genesys_scaler_device_flash_control_sector_erase(FuGenesysScalerDevice *self,
 		return FALSE;
 
 	/* 5s */
-	if (!fu_device_retry_full(FU_DEVICE(self),
-				  fu_genesys_scaler_device_wait_flash_control_register_cb,
-				  100,
-				  50, /* 50ms */
-				  &helper,
-				  error)) {
+	if (!fu_device_retry_backoff(FU_DEVICE(self),
+				     fu_genesys_scaler_device_wait_flash_control_register_cb,
+				     5000, /* ms */
+				     1,	   /* ms */
+				     50,   /* ms */
+				     FU_DEVICE_RETRY_FLAG_BACKOFF,
+				     &helper,
+				     error)) {
 		g_prefix_error(error, "error waiting for flash control read status register: ");
 		return FALSE;
 	}
@@ -1208,12 +1210,14 @@ fu_genesys_scaler_device_flash_control_sector_erase(FuGenesysScalerDevice *self,
 	}
 
 	/* 5s */
-	if (!fu_device_retry_full(FU_DEVICE(self),
-				  fu_genesys_scaler_device_wait_flash_control_register_cb,
-				  100,
-				  50, /* 50ms */
-				  &helper,
-				  error)) {
+	if (!fu_device_retry_backoff(FU_DEVICE(self),
+				     fu_genesys_scaler_device_wait_flash_control_register_cb,
+				     5000, /* ms */
+				     1,	   /* ms */
+				     50,   /* ms */
+				     FU_DEVICE_RETRY_FLAG_BACKOFF,
+				     &helper,
+				     error)) {
 		g_prefix_error(error, "error waiting for flash control read status register: ");
 		return FALSE;
 	}
@@ -1223,33 +1227,14 @@ fu_genesys_scaler_device_flash_control_sector_erase(FuGenesysScalerDevice *self,
 }
 
 static gboolean
-fu_genesys_scaler_device_erase_flash(FuGenesysScalerDevice *self,
-				     guint addr,
-				     guint bufsz,
-				     FuProgress *progress,
-				     GError **error)
+fu_genesys_scaler_device_pipeline_erase_cb(FuDevice *device,
+					   gsize address,
+					   gsize size,
+					   gpointer user_data,
+					   GError **error)
 {
-	g_autoptr(GPtrArray) chunks = NULL;
-
-	chunks = fu_chunk_array_new(NULL, bufsz, addr, 0, self->sector_size);
-	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_set_steps(progress, chunks->len);
-	for (guint i = 0; i < chunks->len; i++) {
-		FuChunk *chk = g_ptr_array_index(chunks, i);
-
-		if (!fu_genesys_scaler_device_flash_control_sector_erase(self,
-									 fu_chunk_get_address(chk),
-									 error)) {
-			g_prefix_error(error,
-				       "error erasing flash at address 0x%06x: ",
-				       (guint)fu_chunk_get_address(chk));
-			return FALSE;
-		}
-		fu_progress_step_done(progress);
-	}
-
-	/* success */
-	return TRUE;
+	FuGenesysScalerDevice *self = FU_GENESYS_SCALER_DEVICE(device);
+	return fu_genesys_scaler_device_flash_control_sector_erase(self, address, error);
 }
 
 static gboolean
@@ -1341,11 +1326,14 @@ fu_genesys_scaler_device_flash_control_page_program(FuGenesysScalerDevice *self,
 	}
 
 	/* 200ms */
-	if (!fu_device_retry(FU_DEVICE(self),
-			     fu_genesys_scaler_device_wait_flash_control_register_cb,
-			     20,
-			     &helper,
-			     error)) {
+	if (!fu_device_retry_backoff(FU_DEVICE(self),
+				     fu_genesys_scaler_device_wait_flash_control_register_cb,
+				     200, /* ms */
+				     1,	  /* ms */
+				     10,  /* ms */
+				     FU_DEVICE_RETRY_FLAG_BACKOFF,
+				     &helper,
+				     error)) {
 		g_prefix_error(error, "error waiting for flash control read status register: ");
 		return FALSE;
 	}
@@ -1355,64 +1343,32 @@ fu_genesys_scaler_device_flash_control_page_program(FuGenesysScalerDevice *self,
 }
 
 static gboolean
-fu_genesys_scaler_device_write_sector(FuGenesysScalerDevice *self,
-				      guint addr,
-				      const guint8 *buf,
-				      guint bufsz,
-				      FuProgress *progress,
-				      GError **error)
+fu_genesys_scaler_device_pipeline_write_cb(FuDevice *device,
+					   FuChunk *chk,
+					   gpointer user_data,
+					   GError **error)
 {
-	g_autoptr(GPtrArray) chunks = NULL;
-
-	chunks = fu_chunk_array_new(buf, bufsz, addr, 0, self->page_size);
-	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_set_steps(progress, chunks->len);
-	for (guint i = 0; i < chunks->len; i++) {
-		FuChunk *chk = g_ptr_array_index(chunks, i);
-
-		if (!fu_genesys_scaler_device_flash_control_page_program(
-			self,
-			fu_chunk_get_address(chk),
-			fu_chunk_get_data(chk),
-			fu_chunk_get_data_sz(chk),
-			fu_progress_get_child(progress),
-			error))
-			return FALSE;
-		fu_progress_step_done(progress);
-	}
-
-	/* success */
-	return TRUE;
+	FuGenesysScalerDevice *self = FU_GENESYS_SCALER_DEVICE(device);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	return fu_genesys_scaler_device_flash_control_page_program(self,
+								   fu_chunk_get_address(chk),
+								   fu_chunk_get_data(chk),
+								   fu_chunk_get_data_sz(chk),
+								   progress,
+								   error);
 }
 
 static gboolean
-fu_genesys_scaler_device_write_flash(FuGenesysScalerDevice *self,
-				     guint addr,
-				     const guint8 *buf,
-				     guint bufsz,
-				     FuProgress *progress,
-				     GError **error)
+fu_genesys_scaler_device_pipeline_read_cb(FuDevice *device,
+					  gsize address,
+					  guint8 *buf,
+					  gsize bufsz,
+					  gpointer user_data,
+					  GError **error)
 {
-	g_autoptr(GPtrArray) chunks = NULL;
-
-	chunks = fu_chunk_array_new(buf, bufsz, addr, 0, self->sector_size);
-	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_set_steps(progress, chunks->len);
-	for (guint i = 0; i < chunks->len; i++) {
-		FuChunk *chk = g_ptr_array_index(chunks, i);
-
-		if (!fu_genesys_scaler_device_write_sector(self,
-							   fu_chunk_get_address(chk),
-							   fu_chunk_get_data(chk),
-							   fu_chunk_get_data_sz(chk),
-							   fu_progress_get_child(progress),
-							   error))
-			return FALSE;
-		fu_progress_step_done(progress);
-	}
-
-	/* success */
-	return TRUE;
+	FuGenesysScalerDevice *self = FU_GENESYS_SCALER_DEVICE(device);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	return fu_genesys_scaler_device_read_flash(self, address, buf, bufsz, progress, error);
 }
 
 static guint8
@@ -1754,16 +1710,10 @@ fu_genesys_scaler_device_write_firmware(FuDevice *device,
 {
 	FuGenesysScalerDevice *self = FU_GENESYS_SCALER_DEVICE(device);
 	guint addr = 0;
-	gsize size;
-	const guint8 *data;
-	g_autofree guint8 *buf = NULL;
 	g_autoptr(FuFirmware) payload = NULL;
+	g_autoptr(FuFlashPipeline) pipeline = fu_flash_pipeline_new(device);
 	g_autoptr(GBytes) fw_payload = NULL;
-
-	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_ERASE, 4, NULL);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 54, NULL);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_VERIFY, 42, NULL);
+	g_autoptr(GInputStream) stream = NULL;
 
 	if (fu_device_has_flag(device, FWUPD_DEVICE_FLAG_DUAL_IMAGE))
 		addr = GENESYS_SCALER_BANK_SIZE;
@@ -1774,41 +1724,18 @@ fu_genesys_scaler_device_write_firmware(FuDevice *device,
 	fw_payload = fu_firmware_get_bytes(payload, error);
 	if (fw_payload == NULL)
 		return FALSE;
-	data = g_bytes_get_data(fw_payload, &size);
-	if (data == NULL)
-		return FALSE;
-
-	if (!fu_genesys_scaler_device_erase_flash(self,
-						  addr,
-						  size,
-						  fu_progress_get_child(progress),
-						  error))
-		return FALSE;
-	fu_progress_step_done(progress);
-
-	if (!fu_genesys_scaler_device_write_flash(self,
-						  addr,
-						  data,
-						  size,
-						  fu_progress_get_child(progress),
-						  error))
-		return FALSE;
-	fu_progress_step_done(progress);
-
-	buf = g_malloc0(size);
-	if (!fu_genesys_scaler_device_read_flash(self,
-						 addr,
-						 buf,
-						 size,
-						 fu_progress_get_child(progress),
-						 error))
-		return FALSE;
-	if (!fu_memcmp_safe(buf, size, 0x0, data, size, 0x0, size, error))
-		return FALSE;
-	fu_progress_step_done(progress);
-
-	/* success */
-	return TRUE;
+	stream = g_memory_input_stream_new_from_bytes(fw_payload);
+
+	/* erase each sector, program each page that is not blank, then read back */
+	fu_flash_pipeline_set_address(pipeline, addr);
+	fu_flash_pipeline_set_sector_size(pipeline, self->sector_size);
+	fu_flash_pipeline_set_page_size(pipeline, self->page_size);
+	fu_flash_pipeline_set_erase_func(pipeline, fu_genesys_scaler_device_pipeline_erase_cb);
+	fu_flash_pipeline_set_write_func(pipeline, fu_genesys_scaler_device_pipeline_write_cb);
+	fu_flash_pipeline_set_read_func(pipeline, fu_genesys_scaler_device_pipeline_read_cb);
+	fu_flash_pipeline_add_flag(pipeline, FU_FLASH_PIPELINE_FLAG_SKIP_BLANK);
+	fu_flash_pipeline_add_flag(pipeline, FU_FLASH_PIPELINE_FLAG_VERIFY);
+	return fu_flash_pipeline_write(pipeline, stream, progress, error);
 }
 
 static void
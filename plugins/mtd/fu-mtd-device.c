@@ -24,6 +24,8 @@ G_DEFINE_TYPE(FuMtdDevice, fu_mtd_device, FU_TYPE_UDEV_DEVICE)
 
 #define FU_MTD_DEVICE_IOCTL_TIMEOUT 5000 /* ms */
 
+#define FU_MTD_DEVICE_FLAG_PARSE_PARALLEL (1 << 0)
+
 static void
 fu_mtd_device_to_string(FuDevice *device, guint idt, GString *str)
 {
@@ -67,6 +69,8 @@ fu_mtd_device_read_firmware(FuDevice *device, FuProgress *progress, GError **err
 		stream_partial = g_object_ref(stream);
 	}
 	firmware = g_object_new(fu_device_get_firmware_gtype(FU_DEVICE(self)), NULL);
+	if (fu_device_has_private_flag(device, FU_MTD_DEVICE_FLAG_PARSE_PARALLEL))
+		fu_firmware_add_flag(firmware, FU_FIRMWARE_FLAG_PARSE_PARALLEL);
 	if (!fu_firmware_parse_stream(firmware,
 				      stream_partial,
 				      0x0,
@@ -544,6 +548,9 @@ fu_mtd_device_init(FuMtdDevice *self)
 	fu_device_add_icon(FU_DEVICE(self), "drive-harddisk-solidstate");
 	fu_udev_device_add_flag(FU_UDEV_DEVICE(self), FU_UDEV_DEVICE_FLAG_OPEN_READ);
 	fu_udev_device_add_flag(FU_UDEV_DEVICE(self), FU_UDEV_DEVICE_FLAG_OPEN_SYNC);
+	fu_device_register_private_flag(FU_DEVICE(self),
+					FU_MTD_DEVICE_FLAG_PARSE_PARALLEL,
+					"parse-parallel");
 }
 
 static void
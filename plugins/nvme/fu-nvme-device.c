@@ -17,7 +17,9 @@
 struct _FuNvmeDevice {
 	FuUdevDevice parent_instance;
 	guint pci_depth;
-	guint64 write_block_size;
+	guint32 write_block_size;
+	guint32 fw_granularity;
+	guint32 max_transfer_size;
 };
 
 #define FU_NVME_COMMIT_ACTION_CA0 0b000 /* replace only */
@@ -39,6 +41,20 @@ struct _FuNvmeDevice {
  */
 #define FU_NVME_DEVICE_FLAG_COMMIT_CA3 (1 << 1)
 
+/**
+ * FU_NVME_DEVICE_FLAG_NO_LARGE_TRANSFER:
+ *
+ * Always send the firmware using the firmware update granularity, even if the controller
+ * reports it can accept larger transfers.
+ */
+#define FU_NVME_DEVICE_FLAG_NO_LARGE_TRANSFER (1 << 2)
+
+/* the default and minimum size of each firmware image download command */
+#define FU_NVME_DEVICE_BLOCK_SIZE_DEFAULT 0x1000
+
+/* used when the controller does not report a maximum data transfer size */
+#define FU_NVME_DEVICE_TRANSFER_SIZE_MAX 0x20000
+
 G_DEFINE_TYPE(FuNvmeDevice, fu_nvme_device, FU_TYPE_UDEV_DEVICE)
 
 #define FU_NVME_DEVICE_IOCTL_TIMEOUT 5000 /* ms */
@@ -48,6 +64,9 @@ fu_nvme_device_to_string(FuDevice *device, guint idt, GString *str)
 {
 	FuNvmeDevice *self = FU_NVME_DEVICE(device);
 	fwupd_codec_string_append_int(str, idt, "PciDepth", self->pci_depth);
+	fwupd_codec_string_append_hex(str, idt, "WriteBlockSize", self->write_block_size);
+	fwupd_codec_string_append_hex(str, idt, "FwGranularity", self->fw_granularity);
+	fwupd_codec_string_append_hex(str, idt, "MaxTransferSize", self->max_transfer_size);
 }
 
 /* @addr_start and @addr_end are *inclusive* to match the NMVe specification */
@@ -206,6 +225,7 @@ fu_nvme_device_parse_cns(FuNvmeDevice *self, const guint8 *buf, gsize sz, GError
 {
 	guint8 fawr;
 	guint8 fwug;
+	guint8 mdts;
 	guint8 nfws;
 	guint8 s1ro;
 	g_autofree gchar *gu = NULL;
@@ -235,10 +255,19 @@ fu_nvme_device_parse_cns(FuNvmeDevice *self, const guint8 *buf, gsize sz, GError
 	if (sr != NULL)
 		fu_device_set_version(FU_DEVICE(self), sr);
 
-	/* firmware update granularity (FWUG) */
+	/* maximum data transfer size (MDTS), in units of the minimum memory page size -- which
+	 * is only available from the CAP register, but is never smaller than 4kB */
+	mdts = buf[77];
+	if (mdts != 0x00 && mdts < 20)
+		self->max_transfer_size = ((guint32)FU_NVME_DEVICE_BLOCK_SIZE_DEFAULT) << mdts;
+
+	/* firmware update granularity (FWUG), where 0xff is no restriction */
 	fwug = buf[319];
-	if (fwug != 0x00 && fwug != 0xff)
-		self->write_block_size = ((guint64)fwug) * 0x1000;
+	if (fwug == 0xff)
+		self->fw_granularity = sizeof(guint32);
+	else if (fwug != 0x00)
+		self->fw_granularity = ((guint32)fwug) * FU_NVME_DEVICE_BLOCK_SIZE_DEFAULT;
+	g_debug("mdts: %u, fwug: %u", mdts, fwug);
 
 	/* firmware slot information */
 	fawr = (buf[260] & 0x10) >> 4;
@@ -358,6 +387,35 @@ fu_nvme_device_setup(FuDevice *device, GError **error)
 	return TRUE;
 }
 
+/* the largest multiple of the firmware update granularity that fits in the MDTS */
+guint32
+fu_nvme_device_get_transfer_size(FuNvmeDevice *self)
+{
+	guint32 max_transfer_size = FU_NVME_DEVICE_TRANSFER_SIZE_MAX;
+
+	g_return_val_if_fail(FU_IS_NVME_DEVICE(self), 0);
+
+	/* set by a quirk */
+	if (self->write_block_size > 0)
+		return self->write_block_size;
+
+	/* the controller does not tell us the alignment requirement */
+	if (self->fw_granularity == 0)
+		return FU_NVME_DEVICE_BLOCK_SIZE_DEFAULT;
+
+	/* the device does not accept blocks of different sizes */
+	if (fu_device_has_private_flag(FU_DEVICE(self), FU_NVME_DEVICE_FLAG_FORCE_ALIGN) ||
+	    fu_device_has_private_flag(FU_DEVICE(self), FU_NVME_DEVICE_FLAG_NO_LARGE_TRANSFER))
+		return MAX(self->fw_granularity, FU_NVME_DEVICE_BLOCK_SIZE_DEFAULT);
+
+	/* largest legal multiple of the granularity */
+	if (self->max_transfer_size > 0)
+		max_transfer_size = MIN(max_transfer_size, self->max_transfer_size);
+	if (self->fw_granularity >= max_transfer_size)
+		return self->fw_granularity;
+	return max_transfer_size - (max_transfer_size % self->fw_granularity);
+}
+
 static gboolean
 fu_nvme_device_write_firmware(FuDevice *device,
 			      FuFirmware *firmware,
@@ -369,7 +427,7 @@ fu_nvme_device_write_firmware(FuDevice *device,
 	g_autoptr(GBytes) fw2 = NULL;
 	g_autoptr(GBytes) fw = NULL;
 	g_autoptr(FuChunkArray) chunks = NULL;
-	guint64 block_size = self->write_block_size > 0 ? self->write_block_size : 0x1000;
+	guint32 block_size = fu_nvme_device_get_transfer_size(self);
 	guint8 commit_action = FU_NVME_COMMIT_ACTION_CA1;
 
 	/* progress */
@@ -391,7 +449,8 @@ fu_nvme_device_write_firmware(FuDevice *device,
 		fw2 = g_bytes_ref(fw);
 	}
 
-	/* write each block */
+	/* write each block, each chunk being a view into the already-aligned image */
+	g_debug("using transfer size of 0x%x", block_size);
 	chunks = fu_chunk_array_new_from_bytes(fw2, 0x00, block_size);
 	for (guint i = 0; i < fu_chunk_array_length(chunks); i++) {
 		g_autoptr(FuChunk) chk = NULL;
@@ -439,7 +498,7 @@ fu_nvme_device_set_quirk_kv(FuDevice *device, const gchar *key, const gchar *val
 		guint64 tmp = 0;
 		if (!fu_strtoull(value, &tmp, 0, G_MAXUINT32, error))
 			return FALSE;
-		self->write_block_size = tmp;
+		self->write_block_size = (guint32)tmp;
 		return TRUE;
 	}
 
@@ -479,6 +538,9 @@ fu_nvme_device_init(FuNvmeDevice *self)
 	fu_device_register_private_flag(FU_DEVICE(self),
 					FU_NVME_DEVICE_FLAG_COMMIT_CA3,
 					"commit-ca3");
+	fu_device_register_private_flag(FU_DEVICE(self),
+					FU_NVME_DEVICE_FLAG_NO_LARGE_TRANSFER,
+					"no-large-transfer");
 }
 
 static void
@@ -47,6 +47,42 @@ fu_nvme_cns_func(void)
 			"e1409b09-50cf-5aef-8ad8-760b9022f88d");
 }
 
+static void
+fu_nvme_transfer_size_func(void)
+{
+	guint8 buf[0x1000] = {0x0};
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuNvmeDevice) dev1 = NULL;
+	g_autoptr(FuNvmeDevice) dev2 = NULL;
+	g_autoptr(FuNvmeDevice) dev3 = NULL;
+	g_autoptr(GError) error = NULL;
+
+	/* model number */
+	memcpy(buf + 24, "SYNTHETIC", 9);
+
+	/* no FWUG, so use the spec default */
+	dev1 = fu_nvme_device_new_from_blob(ctx, buf, sizeof(buf), &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(dev1);
+	g_assert_cmpint(fu_nvme_device_get_transfer_size(dev1), ==, 0x1000);
+
+	/* FWUG of 12kB and MDTS of 128kB */
+	buf[77] = 5;
+	buf[319] = 3;
+	dev2 = fu_nvme_device_new_from_blob(ctx, buf, sizeof(buf), &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(dev2);
+	g_assert_cmpint(fu_nvme_device_get_transfer_size(dev2), ==, 0x1e000);
+
+	/* no FWUG restriction and MDTS of 64kB */
+	buf[77] = 4;
+	buf[319] = 0xff;
+	dev3 = fu_nvme_device_new_from_blob(ctx, buf, sizeof(buf), &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(dev3);
+	g_assert_cmpint(fu_nvme_device_get_transfer_size(dev3), ==, 0x10000);
+}
+
 static void
 fu_nvme_cns_all_func(void)
 {
@@ -101,5 +137,6 @@ main(int argc, char **argv)
 	/* tests go here */
 	g_test_add_func("/fwupd/cns", fu_nvme_cns_func);
 	g_test_add_func("/fwupd/cns{all}", fu_nvme_cns_all_func);
+	g_test_add_func("/fwupd/transfer-size", fu_nvme_transfer_size_func);
 	return g_test_run();
 }
@@ -10,7 +10,6 @@
 #include <glib/gstdio.h>
 #include <linux/ipmi.h>
 #include <linux/ipmi_msgdefs.h>
-#include <poll.h>
 #include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -288,7 +287,6 @@ fu_ipmi_device_transaction_cb(FuDevice *device, gpointer user_data, GError **err
 	FuIpmiDevice *self = FU_IPMI_DEVICE(device);
 	FuIOChannel *io_channel = fu_udev_device_get_io_channel(FU_UDEV_DEVICE(self));
 	FuIpmiDeviceTransactionHelper *helper = (FuIpmiDeviceTransactionHelper *)user_data;
-	GPollFD pollfds[1];
 	gsize resp_buf2sz = helper->resp_bufsz + 1;
 	gsize resp_len2 = 0;
 	g_autoptr(GTimer) timer = g_timer_new();
@@ -307,38 +305,22 @@ fu_ipmi_device_transaction_cb(FuDevice *device, gpointer user_data, GError **err
 				 error))
 		return FALSE;
 
-	pollfds[0].fd = fu_io_channel_unix_get_fd(io_channel);
-	pollfds[0].events = POLLIN;
-
 	for (;;) {
 		guint8 resp_netfn = 0;
 		guint8 resp_cmd = 0;
 		glong seq = 0;
-		gint rc;
-
-		rc = g_poll(pollfds,
-			    1,
-			    helper->timeout_ms - (g_timer_elapsed(timer, NULL) * 1000.f));
-		if (rc < 0) {
-			g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL, "poll() error %m");
-			return FALSE;
-		}
-		if (rc == 0) {
-			g_set_error(error,
-				    FWUPD_ERROR,
-				    FWUPD_ERROR_TIMED_OUT,
-				    "timeout waiting for response "
-				    "(netfn %d, cmd %d)",
-				    helper->netfn,
-				    helper->cmd);
-			return FALSE;
-		}
-
-		if (!(pollfds[0].revents & POLLIN)) {
-			g_set_error_literal(error,
-					    FWUPD_ERROR,
-					    FWUPD_ERROR_INTERNAL,
-					    "unexpected status");
+		guint elapsed = (guint)(g_timer_elapsed(timer, NULL) * 1000.f);
+
+		if (!fu_device_wait_readable(device,
+					     fu_io_channel_unix_get_fd(io_channel),
+					     (guint)helper->timeout_ms > elapsed
+						 ? (guint)helper->timeout_ms - elapsed
+						 : 0,
+					     error)) {
+			g_prefix_error(error,
+				       "failed waiting for response (netfn %d, cmd %d): ",
+				       helper->netfn,
+				       helper->cmd);
 			return FALSE;
 		}
 
@@ -16,6 +16,14 @@
 #include "fu-redfish-smbios.h"
 #include "fu-redfish-smc-device.h"
 
+/* enough to hide the BMC latency without overloading the embedded webserver */
+#define FU_REDFISH_BACKEND_MAX_ACTIVE_REQUESTS 8
+
+typedef struct {
+	gchar *etag;
+	GByteArray *buf;
+} FuRedfishBackendEtagItem;
+
 struct _FuRedfishBackend {
 	FuBackend parent_instance;
 	gchar *hostname;
@@ -33,6 +41,7 @@ struct _FuRedfishBackend {
 	gint64 max_image_size; /* bytes */
 	GType device_gtype;
 	GHashTable *request_cache; /* str:GByteArray */
+	GHashTable *etag_cache;	   /* str:FuRedfishBackendEtagItem */
 	CURLSH *curlsh;
 };
 
@@ -134,17 +143,211 @@ fu_redfish_backend_coldplug_member(FuRedfishBackend *self, JsonObject *member, G
 	return TRUE;
 }
 
+static FuRedfishBackendEtagItem *
+fu_redfish_backend_etag_item_new(const gchar *etag, GByteArray *buf)
+{
+	FuRedfishBackendEtagItem *item = g_new0(FuRedfishBackendEtagItem, 1);
+	item->etag = g_strdup(etag);
+	item->buf = g_byte_array_ref(buf);
+	return item;
+}
+
+static void
+fu_redfish_backend_etag_item_free(FuRedfishBackendEtagItem *item)
+{
+	g_free(item->etag);
+	g_byte_array_unref(item->buf);
+	g_free(item);
+}
+
+static GHashTable *
+fu_redfish_backend_etag_cache_new(void)
+{
+	return g_hash_table_new_full(g_str_hash,
+				     g_str_equal,
+				     g_free,
+				     (GDestroyNotify)fu_redfish_backend_etag_item_free);
+}
+
+static gchar *
+fu_redfish_backend_get_etag_cache_filename(FuRedfishBackend *self)
+{
+	g_autofree gchar *cachedir = NULL;
+	g_autofree gchar *basename = NULL;
+	g_autofree gchar *checksum = NULL;
+
+	/* the service root UUID is stable even if the BMC is given a new address, but it is
+	 * controlled by the BMC and so cannot be used as a path component directly */
+	if (self->uuid == NULL)
+		return NULL;
+	checksum = g_compute_checksum_for_string(G_CHECKSUM_SHA256, self->uuid, -1);
+	cachedir = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
+	basename = g_strdup_printf("%s.json", checksum);
+	return g_build_filename(cachedir, "redfish", basename, NULL);
+}
+
+static gboolean
+fu_redfish_backend_etag_cache_load(FuRedfishBackend *self, GError **error)
+{
+	JsonArray *json_arr;
+	JsonNode *json_root;
+	JsonObject *json_obj;
+	g_autofree gchar *fn = fu_redfish_backend_get_etag_cache_filename(self);
+	g_autoptr(JsonParser) parser = json_parser_new();
+
+	/* nothing saved */
+	g_hash_table_remove_all(self->etag_cache);
+	if (fn == NULL || !g_file_test(fn, G_FILE_TEST_EXISTS))
+		return TRUE;
+
+	if (!json_parser_load_from_file(parser, fn, error))
+		return FALSE;
+	json_root = json_parser_get_root(parser);
+	if (json_root == NULL || !JSON_NODE_HOLDS_OBJECT(json_root)) {
+		g_set_error_literal(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE, "no JSON object");
+		return FALSE;
+	}
+	json_obj = json_node_get_object(json_root);
+	if (!json_object_has_member(json_obj, "Members")) {
+		g_set_error_literal(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE, "no Members");
+		return FALSE;
+	}
+	json_arr = json_object_get_array_member(json_obj, "Members");
+	for (guint i = 0; i < json_array_get_length(json_arr); i++) {
+		JsonObject *json_item = json_array_get_object_element(json_arr, i);
+		const gchar *member_uri;
+		const gchar *etag;
+		const gchar *response;
+		g_autoptr(GByteArray) buf = g_byte_array_new();
+
+		member_uri =
+		    json_object_get_string_member_with_default(json_item, "@odata.id", NULL);
+		etag = json_object_get_string_member_with_default(json_item, "@odata.etag", NULL);
+		response = json_object_get_string_member_with_default(json_item, "Response", NULL);
+		if (member_uri == NULL || etag == NULL || response == NULL)
+			continue;
+		g_byte_array_append(buf, (const guint8 *)response, strlen(response));
+		g_hash_table_insert(self->etag_cache,
+				    g_strdup(member_uri),
+				    fu_redfish_backend_etag_item_new(etag, buf));
+	}
+
+	/* success */
+	return TRUE;
+}
+
+static gboolean
+fu_redfish_backend_etag_cache_save(FuRedfishBackend *self, GError **error)
+{
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
+	g_autofree gchar *fn = fu_redfish_backend_get_etag_cache_filename(self);
+	gsize datasz = 0;
+	g_autofree gchar *data = NULL;
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(JsonBuilder) builder = json_builder_new();
+	g_autoptr(JsonGenerator) json_generator = json_generator_new();
+	g_autoptr(JsonNode) json_root = NULL;
+
+	/* no stable ID */
+	if (fn == NULL)
+		return TRUE;
+
+	json_builder_begin_object(builder);
+	json_builder_set_member_name(builder, "Members");
+	json_builder_begin_array(builder);
+	g_hash_table_iter_init(&iter, self->etag_cache);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		FuRedfishBackendEtagItem *item = (FuRedfishBackendEtagItem *)value;
+		g_autofree gchar *response =
+		    g_strndup((const gchar *)item->buf->data, item->buf->len);
+		json_builder_begin_object(builder);
+		json_builder_set_member_name(builder, "@odata.id");
+		json_builder_add_string_value(builder, (const gchar *)key);
+		json_builder_set_member_name(builder, "@odata.etag");
+		json_builder_add_string_value(builder, item->etag);
+		json_builder_set_member_name(builder, "Response");
+		json_builder_add_string_value(builder, response);
+		json_builder_end_object(builder);
+	}
+	json_builder_end_array(builder);
+	json_builder_end_object(builder);
+
+	json_root = json_builder_get_root(builder);
+	json_generator_set_root(json_generator, json_root);
+	data = json_generator_to_data(json_generator, &datasz);
+	blob = g_bytes_new_take(g_steal_pointer(&data), datasz);
+	return fu_bytes_set_contents(fn, blob, error);
+}
+
+static FuRedfishRequest *
+fu_redfish_backend_member_request_new(FuRedfishBackend *self, const gchar *member_uri)
+{
+	FuRedfishBackendEtagItem *item = g_hash_table_lookup(self->etag_cache, member_uri);
+	FuRedfishRequest *request = fu_redfish_backend_request_new(self);
+
+	/* the BMC only has to send the member again if it changed since the last coldplug */
+	if (item != NULL)
+		fu_redfish_request_set_etag(request, item->etag, item->buf);
+	return request;
+}
+
+static void
+fu_redfish_backend_prefetch_members(FuRedfishBackend *self, JsonArray *members)
+{
+	g_autoptr(GPtrArray) requests = g_ptr_array_new_with_free_func(g_object_unref);
+	g_autoptr(GPtrArray) paths = g_ptr_array_new();
+	g_autoptr(GError) error_local = NULL;
+
+	for (guint i = 0; i < json_array_get_length(members); i++) {
+		JsonObject *member_id = json_array_get_object_element(members, i);
+		const gchar *member_uri;
+
+		member_uri =
+		    json_object_get_string_member_with_default(member_id, "@odata.id", NULL);
+		if (member_uri == NULL || g_hash_table_contains(self->request_cache, member_uri))
+			continue;
+		g_ptr_array_add(requests, fu_redfish_backend_member_request_new(self, member_uri));
+		g_ptr_array_add(paths, (gpointer)member_uri);
+	}
+	if (requests->len <= 1)
+		return;
+
+	/* any failures are reported when the member is requested again */
+	if (!fu_redfish_request_perform_multi(requests,
+					      paths,
+					      FU_REDFISH_BACKEND_MAX_ACTIVE_REQUESTS,
+					      FU_REDFISH_REQUEST_PERFORM_FLAG_NONE,
+					      &error_local))
+		g_debug("failed to prefetch members: %s", error_local->message);
+}
+
 static gboolean
 fu_redfish_backend_coldplug_collection(FuRedfishBackend *self,
 				       JsonObject *collection,
 				       GError **error)
 {
 	JsonArray *members = json_object_get_array_member(collection, "Members");
+	g_autoptr(GHashTable) etag_cache = fu_redfish_backend_etag_cache_new();
+	g_autoptr(GError) error_local = NULL;
+
+	/* use the responses saved when the daemon last ran */
+	if (!fu_redfish_backend_etag_cache_load(self, &error_local)) {
+		g_debug("ignoring saved inventory: %s", error_local->message);
+		g_clear_error(&error_local);
+	}
+
+	/* fetch all the members concurrently into the request cache */
+	fu_redfish_backend_prefetch_members(self, members);
+
 	for (guint i = 0; i < json_array_get_length(members); i++) {
 		JsonObject *json_obj;
 		JsonObject *member_id;
+		GByteArray *buf;
 		const gchar *member_uri;
-		g_autoptr(FuRedfishRequest) request = fu_redfish_backend_request_new(self);
+		const gchar *etag;
+		g_autoptr(FuRedfishRequest) request = NULL;
 
 		member_id = json_array_get_object_element(members, i);
 		member_uri = json_object_get_string_member(member_id, "@odata.id");
@@ -157,15 +360,35 @@ fu_redfish_backend_coldplug_collection(FuRedfishBackend *self,
 		}
 
 		/* create the device for the member */
+		request = fu_redfish_backend_member_request_new(self, member_uri);
 		if (!fu_redfish_request_perform(request,
 						member_uri,
-						FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON,
+						FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON |
+						    FU_REDFISH_REQUEST_PERFORM_FLAG_USE_CACHE,
 						error))
 			return FALSE;
 		json_obj = fu_redfish_request_get_json_object(request);
+
+		/* save for next time */
+		etag = json_object_get_string_member_with_default(json_obj, "@odata.etag", NULL);
+		buf = g_hash_table_lookup(self->request_cache, member_uri);
+		if (etag != NULL && buf != NULL) {
+			g_hash_table_insert(etag_cache,
+					    g_strdup(member_uri),
+					    fu_redfish_backend_etag_item_new(etag, buf));
+		}
+
 		if (!fu_redfish_backend_coldplug_member(self, json_obj, error))
 			return FALSE;
 	}
+
+	/* members that were removed from the BMC are not saved */
+	g_hash_table_unref(self->etag_cache);
+	self->etag_cache = g_steal_pointer(&etag_cache);
+	if (!fu_redfish_backend_etag_cache_save(self, &error_local))
+		g_debug("failed to save inventory: %s", error_local->message);
+
+	/* success */
 	return TRUE;
 }
 
@@ -487,6 +710,7 @@ fu_redfish_backend_finalize(GObject *object)
 {
 	FuRedfishBackend *self = FU_REDFISH_BACKEND(object);
 	g_hash_table_unref(self->request_cache);
+	g_hash_table_unref(self->etag_cache);
 	curl_share_cleanup(self->curlsh);
 	g_free(self->update_uri_path);
 	g_free(self->push_uri_path);
@@ -520,6 +744,7 @@ fu_redfish_backend_init(FuRedfishBackend *self)
 						    g_str_equal,
 						    g_free,
 						    (GDestroyNotify)g_byte_array_unref);
+	self->etag_cache = fu_redfish_backend_etag_cache_new();
 	self->curlsh = curl_share_init();
 	curl_share_setopt(self->curlsh, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
 	curl_share_setopt(self->curlsh, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
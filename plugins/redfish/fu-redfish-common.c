@@ -7,6 +7,7 @@
 #include "config.h"
 
 #include <fwupd.h>
+#include <math.h>
 
 #include "fu-redfish-common.h"
 
@@ -128,3 +129,155 @@ fu_redfish_common_parse_version_lenovo(const gchar *version,
 		*out_version = g_strdup(versplit[1]);
 	return TRUE;
 }
+
+/* parses an ISO 8601 duration like "P0DT00H05M30S" into milliseconds */
+gboolean
+fu_redfish_common_parse_duration(const gchar *str, guint64 *value, GError **error)
+{
+	gboolean in_time = FALSE;
+	gdouble total = 0;
+	guint values_time = 0;
+	const gchar *ptr;
+
+	/* sanity check */
+	if (str == NULL || str[0] != 'P' || str[1] == '\0') {
+		g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_DATA, "invalid duration");
+		return FALSE;
+	}
+	for (ptr = str + 1; *ptr != '\0';) {
+		gchar *endptr = NULL;
+		gdouble val;
+
+		/* hours, minutes and seconds follow */
+		if (*ptr == 'T' && !in_time) {
+			in_time = TRUE;
+			ptr++;
+			continue;
+		}
+		/* g_ascii_strtod() also accepts "inf" and "nan" */
+		val = g_ascii_strtod(ptr, &endptr);
+		if (endptr == ptr || !isfinite(val) || val < 0) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "invalid duration value: %s",
+				    ptr);
+			return FALSE;
+		}
+
+		/* years and months are not a fixed length, and not used for tasks */
+		if (*endptr == 'D' && !in_time) {
+			total += val * 60 * 60 * 24;
+		} else if (*endptr == 'H' && in_time) {
+			total += val * 60 * 60;
+		} else if (*endptr == 'M' && in_time) {
+			total += val * 60;
+		} else if (*endptr == 'S' && in_time) {
+			total += val;
+		} else {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "invalid duration designator: %s",
+				    endptr);
+			return FALSE;
+		}
+		if (in_time)
+			values_time++;
+		ptr = endptr + 1;
+	}
+
+	/* the time designator has to be followed by at least one value */
+	if (in_time && values_time == 0) {
+		g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_DATA, "invalid duration");
+		return FALSE;
+	}
+
+	/* so the conversion to milliseconds cannot overflow */
+	if (total > G_MAXUINT32) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "duration too large: %s",
+			    str);
+		return FALSE;
+	}
+
+	/* success */
+	if (value != NULL)
+		*value = (guint64)(total * 1000);
+	return TRUE;
+}
+
+/* aim to poll about four times in the time the task is expected to take to finish */
+guint
+fu_redfish_common_get_poll_delay(guint delay,
+				 gdouble elapsed,
+				 gint64 percentage_start,
+				 gdouble percentage_start_elapsed,
+				 gint64 percentage,
+				 guint64 estimated_duration)
+{
+	gdouble remaining = -1;
+
+	/* extrapolate from how quickly the percentage has been changing */
+	if (percentage_start >= 0 && percentage > percentage_start) {
+		remaining = (elapsed - percentage_start_elapsed) * (100 - percentage) /
+			    (percentage - percentage_start);
+	} else if (estimated_duration > elapsed) {
+		remaining = estimated_duration - elapsed;
+	}
+	if (remaining >= 0) {
+		return CLAMP((guint)(remaining / 4),
+			     FU_REDFISH_DEVICE_POLL_DELAY_MIN,
+			     FU_REDFISH_DEVICE_POLL_DELAY_MAX);
+	}
+
+	/* no idea, so back off gradually */
+	return CLAMP(delay * 3 / 2,
+		     FU_REDFISH_DEVICE_POLL_DELAY_MIN,
+		     FU_REDFISH_DEVICE_POLL_DELAY_UNKNOWN_MAX);
+}
+
+/* returns the data of the next complete server-sent event in @buf, or %NULL if none */
+gchar *
+fu_redfish_common_event_stream_pop(GByteArray *buf, gsize *offset)
+{
+	for (gsize i = *offset; i < buf->len; i++) {
+		g_autoptr(GString) data = NULL;
+		g_auto(GStrv) lines = NULL;
+		g_autofree gchar *event = NULL;
+		const gchar *str = (const gchar *)buf->data;
+
+		/* events are separated by a blank line */
+		if (str[i] != '\n')
+			continue;
+		if (!(i >= *offset + 1 && str[i - 1] == '\n') &&
+		    !(i >= *offset + 2 && str[i - 1] == '\r' && str[i - 2] == '\n'))
+			continue;
+		event = g_strndup(str + *offset, i - *offset);
+		*offset = i + 1;
+
+		/* only the data is interesting, and keepalive comments have none */
+		data = g_string_new(NULL);
+		lines = g_strsplit(event, "\n", -1);
+		for (guint j = 0; lines[j] != NULL; j++) {
+			g_strchomp(lines[j]);
+			if (!g_str_has_prefix(lines[j], "data:"))
+				continue;
+			if (data->len > 0)
+				g_string_append_c(data, '\n');
+			g_string_append(data, g_strchug(lines[j] + 5));
+		}
+		if (data->len == 0)
+			continue;
+		return g_string_free(g_steal_pointer(&data), FALSE);
+	}
+
+	/* everything has been processed, so the buffer does not grow forever */
+	if (*offset == buf->len) {
+		g_byte_array_set_size(buf, 0);
+		*offset = 0;
+	}
+	return NULL;
+}
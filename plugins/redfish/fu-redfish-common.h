@@ -23,6 +23,11 @@
 #define REDFISH_EFI_INDICATIONS_FW_CREDENTIALS 0x00000001
 #define REDFISH_EFI_INDICATIONS_OS_CREDENTIALS 0x00000002
 
+/* tasks */
+#define FU_REDFISH_DEVICE_POLL_DELAY_MIN	 250   /* ms */
+#define FU_REDFISH_DEVICE_POLL_DELAY_UNKNOWN_MAX 2000  /* ms */
+#define FU_REDFISH_DEVICE_POLL_DELAY_MAX	 10000 /* ms */
+
 /* shared */
 gchar *
 fu_redfish_common_buffer_to_ipv4(const guint8 *buffer);
@@ -38,3 +43,14 @@ fu_redfish_common_parse_version_lenovo(const gchar *version,
 				       gchar **out_build,
 				       gchar **out_version,
 				       GError **error);
+gboolean
+fu_redfish_common_parse_duration(const gchar *str, guint64 *value, GError **error);
+guint
+fu_redfish_common_get_poll_delay(guint delay,
+				 gdouble elapsed,
+				 gint64 percentage_start,
+				 gdouble percentage_start_elapsed,
+				 gint64 percentage,
+				 guint64 estimated_duration);
+gchar *
+fu_redfish_common_event_stream_pop(GByteArray *buf, gsize *offset);
@@ -543,6 +543,13 @@ typedef struct {
 	gboolean completed;
 	GHashTable *messages_seen;
 	FuProgress *progress;
+	GTimer *timer;
+	guint delay;			  /* ms */
+	gint64 percentage;		  /* -1 for unknown */
+	gint64 percentage_start;	  /* -1 for unknown */
+	gdouble percentage_start_elapsed; /* ms */
+	guint64 estimated_duration;	  /* ms, 0 for unknown */
+	FuRedfishRequest *event_stream;	  /* nullable */
 } FuRedfishDevicePollCtx;
 
 static void
@@ -653,8 +660,25 @@ fu_redfish_device_poll_task_once(FuRedfishDevice *self, FuRedfishDevicePollCtx *
 	json_obj = fu_redfish_request_get_json_object(request);
 	if (json_object_has_member(json_obj, "PercentComplete")) {
 		gint64 pc = json_object_get_int_member(json_obj, "PercentComplete");
-		if (pc >= 0 && pc <= 100)
+		if (pc >= 0 && pc <= 100) {
 			fu_progress_set_percentage(ctx->progress, (guint)pc);
+			if (ctx->percentage_start < 0) {
+				ctx->percentage_start = pc;
+				ctx->percentage_start_elapsed =
+				    g_timer_elapsed(ctx->timer, NULL) * 1000;
+			}
+			ctx->percentage = pc;
+		}
+	}
+
+	/* so is the estimate of how long the task will take */
+	if (json_object_has_member(json_obj, "EstimatedDuration")) {
+		const gchar *tmp = json_object_get_string_member(json_obj, "EstimatedDuration");
+		g_autoptr(GError) error_local = NULL;
+		if (!fu_redfish_common_parse_duration(tmp,
+						      &ctx->estimated_duration,
+						      &error_local))
+			g_debug("ignoring EstimatedDuration: %s", error_local->message);
 	}
 
 	/* print all messages we've not seen yet */
@@ -682,9 +706,10 @@ fu_redfish_device_poll_task_once(FuRedfishDevice *self, FuRedfishDevicePollCtx *
 			}
 			g_hash_table_add(ctx->messages_seen, g_steal_pointer(&message_key));
 
-			/* use the message */
+			/* use the message, and check again soon as the task is changing */
 			g_debug("message #%u [%s]: %s", i, message_id, message);
 			fu_redfish_device_poll_set_message_id(self, ctx, message_id);
+			ctx->delay = 0;
 		}
 	}
 
@@ -724,12 +749,18 @@ fu_redfish_device_poll_ctx_new(FuProgress *progress, const gchar *location)
 	ctx->location = g_strdup(location);
 	ctx->error_code = FWUPD_ERROR_INTERNAL;
 	ctx->progress = g_object_ref(progress);
+	ctx->timer = g_timer_new();
+	ctx->percentage = -1;
+	ctx->percentage_start = -1;
 	return ctx;
 }
 
 static void
 fu_redfish_device_poll_ctx_free(FuRedfishDevicePollCtx *ctx)
 {
+	if (ctx->event_stream != NULL)
+		g_object_unref(ctx->event_stream);
+	g_timer_destroy(ctx->timer);
 	g_hash_table_unref(ctx->messages_seen);
 	g_object_unref(ctx->progress);
 	g_free(ctx->location);
@@ -741,6 +772,137 @@ fu_redfish_device_poll_ctx_free(FuRedfishDevicePollCtx *ctx)
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuRedfishDevicePollCtx, fu_redfish_device_poll_ctx_free)
 #pragma clang diagnostic pop
 
+static guint
+fu_redfish_device_poll_ctx_get_delay(FuRedfishDevicePollCtx *ctx)
+{
+	ctx->delay = fu_redfish_common_get_poll_delay(ctx->delay,
+						      g_timer_elapsed(ctx->timer, NULL) * 1000,
+						      ctx->percentage_start,
+						      ctx->percentage_start_elapsed,
+						      ctx->percentage,
+						      ctx->estimated_duration);
+	return ctx->delay;
+}
+
+static FuRedfishRequest *
+fu_redfish_device_event_stream_new(FuRedfishDevice *self)
+{
+	FuRedfishDevicePrivate *priv = GET_PRIVATE(self);
+	JsonObject *json_obj;
+	const gchar *sse_uri;
+	g_autoptr(FuRedfishRequest) request = fu_redfish_backend_request_new(priv->backend);
+	g_autoptr(FuRedfishRequest) event_stream = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	/* not all BMCs support server-sent events */
+	if (!fu_redfish_request_perform(request,
+					"/redfish/v1/EventService",
+					FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON |
+					    FU_REDFISH_REQUEST_PERFORM_FLAG_USE_CACHE,
+					&error_local)) {
+		g_debug("no EventService: %s", error_local->message);
+		return NULL;
+	}
+	json_obj = fu_redfish_request_get_json_object(request);
+	if (!json_object_get_boolean_member_with_default(json_obj, "ServiceEnabled", FALSE)) {
+		g_debug("EventService is not enabled");
+		return NULL;
+	}
+	sse_uri = json_object_get_string_member_with_default(json_obj, "ServerSentEventUri", NULL);
+	if (sse_uri == NULL) {
+		g_debug("no ServerSentEventUri");
+		return NULL;
+	}
+	event_stream = fu_redfish_backend_request_new(priv->backend);
+	if (!fu_redfish_request_event_stream_start(event_stream, sse_uri, &error_local)) {
+		g_debug("failed to start event stream: %s", error_local->message);
+		return NULL;
+	}
+	return g_steal_pointer(&event_stream);
+}
+
+static gboolean
+fu_redfish_device_poll_task_event_match(FuRedfishDevicePollCtx *ctx, const gchar *data)
+{
+	JsonNode *json_root;
+	JsonArray *json_events;
+	g_autoptr(JsonParser) parser = json_parser_new();
+	g_autoptr(GError) error_local = NULL;
+
+	if (!json_parser_load_from_data(parser, data, -1, &error_local)) {
+		g_debug("ignoring event: %s", error_local->message);
+		return FALSE;
+	}
+	json_root = json_parser_get_root(parser);
+	if (json_root == NULL || !JSON_NODE_HOLDS_OBJECT(json_root))
+		return FALSE;
+	if (!json_object_has_member(json_node_get_object(json_root), "Events"))
+		return FALSE;
+	json_events = json_object_get_array_member(json_node_get_object(json_root), "Events");
+	for (guint i = 0; i < json_array_get_length(json_events); i++) {
+		JsonObject *json_event = json_array_get_object_element(json_events, i);
+		JsonObject *json_origin;
+		const gchar *message_id;
+
+		message_id =
+		    json_object_get_string_member_with_default(json_event, "MessageId", "");
+		if (!g_pattern_match_simple("TaskEvent.*", message_id))
+			continue;
+
+		/* the origin is optional, but if set has to be our task */
+		if (!json_object_has_member(json_event, "OriginOfCondition"))
+			return TRUE;
+		json_origin = json_object_get_object_member(json_event, "OriginOfCondition");
+		if (json_origin == NULL ||
+		    g_strcmp0(json_object_get_string_member_with_default(json_origin,
+									 "@odata.id",
+									 NULL),
+			      ctx->location) == 0)
+			return TRUE;
+	}
+	return FALSE;
+}
+
+static gboolean
+fu_redfish_device_poll_task_event_received(FuRedfishDevicePollCtx *ctx)
+{
+	gboolean ret = FALSE;
+
+	/* process all the events so they are not matched next time */
+	while (TRUE) {
+		g_autofree gchar *data = fu_redfish_request_event_stream_pop(ctx->event_stream);
+		if (data == NULL)
+			break;
+		g_debug("event: %s", data);
+		if (fu_redfish_device_poll_task_event_match(ctx, data))
+			ret = TRUE;
+	}
+	return ret;
+}
+
+/* wait for the delay, returning early if the BMC tells us the task changed */
+static void
+fu_redfish_device_poll_task_wait(FuRedfishDevice *self, FuRedfishDevicePollCtx *ctx, guint delay)
+{
+	guint elapsed = 0;
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	while (ctx->event_stream != NULL && elapsed < delay) {
+		gboolean ret;
+
+		ret = fu_redfish_request_event_stream_wait(ctx->event_stream, delay - elapsed);
+		if (fu_redfish_device_poll_task_event_received(ctx))
+			return;
+		if (!ret) {
+			g_debug("event stream closed, falling back to polling");
+			g_clear_object(&ctx->event_stream);
+		}
+		elapsed = (guint)(g_timer_elapsed(timer, NULL) * 1000);
+	}
+	if (elapsed < delay)
+		fu_device_sleep(FU_DEVICE(self), delay - elapsed);
+}
+
 gboolean
 fu_redfish_device_poll_task(FuRedfishDevice *self,
 			    const gchar *location,
@@ -748,17 +910,20 @@ fu_redfish_device_poll_task(FuRedfishDevice *self,
 			    GError **error)
 {
 	const guint timeout = 2400;
-	g_autoptr(GTimer) timer = g_timer_new();
 	g_autoptr(FuRedfishDevicePollCtx) ctx = fu_redfish_device_poll_ctx_new(progress, location);
 
+	/* the BMC can tell us when the task changes rather than us having to ask */
+	ctx->event_stream = fu_redfish_device_event_stream_new(self);
+
 	/* sleep and then reprobe hardware */
 	do {
-		fu_device_sleep(FU_DEVICE(self), 1000); /* ms */
+		guint delay = fu_redfish_device_poll_ctx_get_delay(ctx);
+		fu_redfish_device_poll_task_wait(self, ctx, delay);
 		if (!fu_redfish_device_poll_task_once(self, ctx, error))
 			return FALSE;
 		if (ctx->completed)
 			return TRUE;
-	} while (g_timer_elapsed(timer, NULL) < timeout);
+	} while (g_timer_elapsed(ctx->timer, NULL) < timeout);
 
 	/* success */
 	g_set_error(error,
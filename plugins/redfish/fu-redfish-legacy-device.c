@@ -81,29 +81,32 @@ fu_redfish_legacy_device_write_firmware(FuDevice *device,
 {
 	FuRedfishLegacyDevice *self = FU_REDFISH_LEGACY_DEVICE(device);
 	FuRedfishBackend *backend = fu_redfish_device_get_backend(FU_REDFISH_DEVICE(self));
-	CURL *curl;
 	JsonObject *json_obj;
 	const gchar *location;
 	g_autoptr(FuRedfishRequest) request = NULL;
-	g_autoptr(GBytes) fw = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+
+	/* progress */
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 50, "upload");
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 50, "task");
 
 	/* get default image */
-	fw = fu_firmware_get_bytes(firmware, error);
-	if (fw == NULL)
+	stream = fu_firmware_get_stream(firmware, error);
+	if (stream == NULL)
 		return FALSE;
 
 	/* POST data */
 	request = fu_redfish_backend_request_new(backend);
-	curl = fu_redfish_request_get_curl(request);
-	(void)curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "POST");
-	(void)curl_easy_setopt(curl, CURLOPT_POSTFIELDS, g_bytes_get_data(fw, NULL));
-	(void)curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (long)g_bytes_get_size(fw));
-	fu_progress_set_status(progress, FWUPD_STATUS_DEVICE_WRITE);
+	if (!fu_redfish_request_set_upload_stream(request, stream, error))
+		return FALSE;
+	fu_redfish_request_set_progress(request, fu_progress_get_child(progress));
 	if (!fu_redfish_request_perform(request,
 					fu_redfish_backend_get_push_uri_path(backend),
 					FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON,
 					error))
 		return FALSE;
+	fu_progress_step_done(progress);
 
 	/* poll the task for progress */
 	json_obj = fu_redfish_request_get_json_object(request);
@@ -116,7 +119,15 @@ fu_redfish_legacy_device_write_firmware(FuDevice *device,
 		return FALSE;
 	}
 	location = json_object_get_string_member(json_obj, "@odata.id");
-	return fu_redfish_device_poll_task(FU_REDFISH_DEVICE(self), location, progress, error);
+	if (!fu_redfish_device_poll_task(FU_REDFISH_DEVICE(self),
+					 location,
+					 fu_progress_get_child(progress),
+					 error))
+		return FALSE;
+	fu_progress_step_done(progress);
+
+	/* success */
+	return TRUE;
 }
 
 static void
@@ -63,12 +63,17 @@ fu_redfish_multipart_device_write_firmware(FuDevice *device,
 	const gchar *location;
 	g_autoptr(curl_mime) mime = NULL;
 	g_autoptr(FuRedfishRequest) request = NULL;
-	g_autoptr(GBytes) fw = NULL;
+	g_autoptr(GInputStream) stream = NULL;
 	g_autoptr(GString) params = NULL;
 
+	/* progress */
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 50, "upload");
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 50, "task");
+
 	/* get default image */
-	fw = fu_firmware_get_bytes(firmware, error);
-	if (fw == NULL)
+	stream = fu_firmware_get_stream(firmware, error);
+	if (stream == NULL)
 		return FALSE;
 
 	/* create the multipart request */
@@ -88,9 +93,10 @@ fu_redfish_multipart_device_write_firmware(FuDevice *device,
 	curl_mime_name(part, "UpdateFile");
 	(void)curl_mime_type(part, "application/octet-stream");
 	(void)curl_mime_filedata(part, "firmware.bin");
-	(void)curl_mime_data(part, g_bytes_get_data(fw, NULL), g_bytes_get_size(fw));
+	if (!fu_redfish_request_set_mime_stream(request, part, stream, error))
+		return FALSE;
 
-	fu_progress_set_status(progress, FWUPD_STATUS_DEVICE_WRITE);
+	fu_redfish_request_set_progress(request, fu_progress_get_child(progress));
 	if (!fu_redfish_request_perform(request,
 					fu_redfish_backend_get_push_uri_path(backend),
 					FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON,
@@ -104,6 +110,7 @@ fu_redfish_multipart_device_write_firmware(FuDevice *device,
 			    fu_redfish_request_get_status_code(request));
 		return FALSE;
 	}
+	fu_progress_step_done(progress);
 
 	/* prefer the header, otherwise fall back to the response */
 	json_obj = fu_redfish_request_get_json_object(request);
@@ -122,7 +129,15 @@ fu_redfish_multipart_device_write_firmware(FuDevice *device,
 		return FALSE;
 	}
 	location = json_object_get_string_member(json_obj, "@odata.id");
-	return fu_redfish_device_poll_task(FU_REDFISH_DEVICE(self), location, progress, error);
+	if (!fu_redfish_device_poll_task(FU_REDFISH_DEVICE(self),
+					 location,
+					 fu_progress_get_child(progress),
+					 error))
+		return FALSE;
+	fu_progress_step_done(progress);
+
+	/* success */
+	return TRUE;
 }
 
 static void
@@ -6,6 +6,7 @@
 
 #include "config.h"
 
+#include "fu-redfish-common.h"
 #include "fu-redfish-request.h"
 
 struct _FuRedfishRequest {
@@ -16,7 +17,14 @@ struct _FuRedfishRequest {
 	glong status_code;
 	JsonParser *json_parser;
 	JsonObject *json_obj;
-	GHashTable *cache; /* nullable */
+	GHashTable *cache;	    /* nullable */
+	GInputStream *stream;	    /* nullable */
+	GError *stream_error;	    /* nullable */
+	FuProgress *progress;	    /* nullable */
+	GByteArray *etag_buf;	    /* nullable */
+	struct curl_slist *headers; /* nullable */
+	CURLM *multi;		    /* nullable */
+	gsize event_offset;	    /* of buf */
 };
 
 G_DEFINE_TYPE(FuRedfishRequest, fu_redfish_request, G_TYPE_OBJECT)
@@ -138,43 +146,31 @@ fu_redfish_request_load_json(FuRedfishRequest *self, GByteArray *buf, GError **e
 	return TRUE;
 }
 
-gboolean
-fu_redfish_request_perform(FuRedfishRequest *self,
-			   const gchar *path,
-			   FuRedfishRequestPerformFlags flags,
-			   GError **error)
+static gboolean
+fu_redfish_request_perform_finish(FuRedfishRequest *self,
+				  const gchar *path,
+				  CURLcode res,
+				  FuRedfishRequestPerformFlags flags,
+				  GError **error)
 {
-	CURLcode res;
+	gboolean success = FALSE;
 	g_autofree gchar *str = NULL;
 	g_autoptr(curlptr) uri_str = NULL;
 
-	g_return_val_if_fail(FU_IS_REDFISH_REQUEST(self), FALSE);
-	g_return_val_if_fail(path != NULL, FALSE);
-	g_return_val_if_fail(self->status_code == 0, FALSE);
-	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
-
-	/* already in cache? */
-	if (flags & FU_REDFISH_REQUEST_PERFORM_FLAG_USE_CACHE && self->cache != NULL) {
-		GByteArray *buf = g_hash_table_lookup(self->cache, path);
-		if (buf != NULL) {
-			if (flags & FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON)
-				return fu_redfish_request_load_json(self, buf, error);
-			g_byte_array_unref(self->buf);
-			self->buf = g_byte_array_ref(buf);
-			return TRUE;
-		}
-	}
-
-	/* do request */
-	(void)curl_url_set(self->uri, CURLUPART_PATH, path, 0);
 	(void)curl_url_get(self->uri, CURLUPART_URL, &uri_str, 0);
-	res = curl_easy_perform(self->curl);
 	curl_easy_getinfo(self->curl, CURLINFO_RESPONSE_CODE, &self->status_code);
 	str = g_strndup((const gchar *)self->buf->data, self->buf->len);
 	g_debug("%s: %s [%li]", uri_str, str, self->status_code);
 
 	/* check result */
 	if (res != CURLE_OK) {
+		if (self->stream_error != NULL) {
+			g_propagate_prefixed_error(error,
+						   g_steal_pointer(&self->stream_error),
+						   "failed to upload to %s: ",
+						   uri_str);
+			return FALSE;
+		}
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INVALID_FILE,
@@ -193,6 +189,17 @@ fu_redfish_request_perform(FuRedfishRequest *self,
 		return FALSE;
 	}
 
+	/* not modified since the ETag was saved */
+	if (fu_redfish_request_get_status_code(self) == 304 && self->etag_buf != NULL) {
+		g_debug("%s not modified, using saved response", uri_str);
+		g_byte_array_set_size(self->buf, 0);
+		g_byte_array_append(self->buf, self->etag_buf->data, self->etag_buf->len);
+		success = TRUE;
+	} else if (fu_redfish_request_get_status_code(self) >= 200 &&
+		   fu_redfish_request_get_status_code(self) < 300) {
+		success = TRUE;
+	}
+
 	/* load JSON */
 	if (flags & FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON) {
 		if (!fu_redfish_request_load_json(self, self->buf, error)) {
@@ -201,14 +208,177 @@ fu_redfish_request_perform(FuRedfishRequest *self,
 		}
 	}
 
-	/* save to cache */
-	if (self->cache != NULL)
+	/* save to cache, but never an error response */
+	if (self->cache != NULL && success)
 		g_hash_table_insert(self->cache, g_strdup(path), g_byte_array_ref(self->buf));
 
 	/* success */
 	return TRUE;
 }
 
+gboolean
+fu_redfish_request_perform(FuRedfishRequest *self,
+			   const gchar *path,
+			   FuRedfishRequestPerformFlags flags,
+			   GError **error)
+{
+	CURLcode res;
+
+	g_return_val_if_fail(FU_IS_REDFISH_REQUEST(self), FALSE);
+	g_return_val_if_fail(path != NULL, FALSE);
+	g_return_val_if_fail(self->status_code == 0, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* already in cache? */
+	if (flags & FU_REDFISH_REQUEST_PERFORM_FLAG_USE_CACHE && self->cache != NULL) {
+		GByteArray *buf = g_hash_table_lookup(self->cache, path);
+		if (buf != NULL) {
+			if (flags & FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON)
+				return fu_redfish_request_load_json(self, buf, error);
+			g_byte_array_unref(self->buf);
+			self->buf = g_byte_array_ref(buf);
+			return TRUE;
+		}
+	}
+
+	/* do request */
+	(void)curl_url_set(self->uri, CURLUPART_PATH, path, 0);
+	res = curl_easy_perform(self->curl);
+	return fu_redfish_request_perform_finish(self, path, res, flags, error);
+}
+
+static gboolean
+fu_redfish_request_perform_multi_loop(CURLM *multi,
+				      GPtrArray *requests,
+				      GPtrArray *paths,
+				      guint max_active,
+				      FuRedfishRequestPerformFlags flags,
+				      GError **error)
+{
+	guint active = 0;
+	guint idx = 0;
+
+	while (active > 0 || idx < requests->len) {
+		CURLMcode mc;
+		CURLMsg *msg;
+		gint msgs_left = 0;
+		gint running = 0;
+
+		/* keep the number of in-flight requests bounded */
+		while (active < max_active && idx < requests->len) {
+			FuRedfishRequest *self = g_ptr_array_index(requests, idx);
+			const gchar *path = g_ptr_array_index(paths, idx);
+			(void)curl_url_set(self->uri, CURLUPART_PATH, path, 0);
+			(void)curl_easy_setopt(self->curl, CURLOPT_PRIVATE, GUINT_TO_POINTER(idx));
+			mc = curl_multi_add_handle(multi, self->curl);
+			if (mc != CURLM_OK) {
+				g_set_error(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_INTERNAL,
+					    "failed to add request for %s: %s",
+					    path,
+					    curl_multi_strerror(mc));
+				return FALSE;
+			}
+			active++;
+			idx++;
+		}
+
+		mc = curl_multi_perform(multi, &running);
+		if (mc != CURLM_OK) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "failed to perform requests: %s",
+				    curl_multi_strerror(mc));
+			return FALSE;
+		}
+
+		/* process any that completed */
+		while ((msg = curl_multi_info_read(multi, &msgs_left)) != NULL) {
+			CURL *curl = msg->easy_handle;
+			CURLcode res = msg->data.result;
+			FuRedfishRequest *self;
+			gchar *priv = NULL;
+			guint i;
+			const gchar *path;
+			g_autoptr(GError) error_local = NULL;
+
+			if (msg->msg != CURLMSG_DONE)
+				continue;
+			(void)curl_easy_getinfo(curl, CURLINFO_PRIVATE, &priv);
+			(void)curl_multi_remove_handle(multi, curl);
+			active--;
+
+			/* the caller can retry this using fu_redfish_request_perform() */
+			i = GPOINTER_TO_UINT(priv);
+			self = g_ptr_array_index(requests, i);
+			path = g_ptr_array_index(paths, i);
+			if (!fu_redfish_request_perform_finish(self,
+							       path,
+							       res,
+							       flags,
+							       &error_local))
+				g_debug("ignoring: %s", error_local->message);
+		}
+
+		/* wait for activity on any of the sockets */
+		if (running > 0) {
+			mc = curl_multi_wait(multi, NULL, 0, 1000, NULL);
+			if (mc != CURLM_OK) {
+				g_set_error(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_INTERNAL,
+					    "failed to wait for requests: %s",
+					    curl_multi_strerror(mc));
+				return FALSE;
+			}
+		}
+	}
+
+	/* success */
+	return TRUE;
+}
+
+/*
+ * Performs the requests concurrently with at most @max_active in flight at any one time.
+ *
+ * Successful responses are added to the request cache; requests that failed are not,
+ * and can be retried with fu_redfish_request_perform() to get the actual error.
+ */
+gboolean
+fu_redfish_request_perform_multi(GPtrArray *requests,
+				 GPtrArray *paths,
+				 guint max_active,
+				 FuRedfishRequestPerformFlags flags,
+				 GError **error)
+{
+	CURLM *multi;
+	gboolean ret;
+
+	g_return_val_if_fail(requests != NULL, FALSE);
+	g_return_val_if_fail(paths != NULL, FALSE);
+	g_return_val_if_fail(requests->len == paths->len, FALSE);
+	g_return_val_if_fail(max_active > 0, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* HTTP/2 BMCs can multiplex the requests over the shared connection */
+	multi = curl_multi_init();
+	(void)curl_multi_setopt(multi, CURLMOPT_PIPELINING, (glong)CURLPIPE_MULTIPLEX);
+	ret = fu_redfish_request_perform_multi_loop(multi,
+						    requests,
+						    paths,
+						    max_active,
+						    flags,
+						    error);
+	for (guint i = 0; i < requests->len; i++) {
+		FuRedfishRequest *self = g_ptr_array_index(requests, i);
+		(void)curl_multi_remove_handle(multi, self->curl);
+	}
+	curl_multi_cleanup(multi);
+	return ret;
+}
+
 typedef struct curl_slist _curl_slist;
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(_curl_slist, curl_slist_free_all)
 
@@ -286,6 +456,214 @@ fu_redfish_request_write_cb(char *ptr, size_t size, size_t nmemb, void *userdata
 	return realsize;
 }
 
+static size_t
+fu_redfish_request_read_cb(char *ptr, size_t size, size_t nitems, void *userdata)
+{
+	FuRedfishRequest *self = FU_REDFISH_REQUEST(userdata);
+	gssize rc;
+	g_autoptr(GError) error_local = NULL;
+
+	rc = g_input_stream_read(self->stream, ptr, size * nitems, NULL, &error_local);
+	if (rc < 0) {
+		g_clear_error(&self->stream_error);
+		self->stream_error = g_steal_pointer(&error_local);
+		return CURL_READFUNC_ABORT;
+	}
+	return (size_t)rc;
+}
+
+static int
+fu_redfish_request_seek_cb(void *userdata, curl_off_t offset, int origin)
+{
+	FuRedfishRequest *self = FU_REDFISH_REQUEST(userdata);
+
+	/* libcurl only ever rewinds the data when resending */
+	if (origin != SEEK_SET)
+		return CURL_SEEKFUNC_CANTSEEK;
+	if (!g_seekable_seek(G_SEEKABLE(self->stream), offset, G_SEEK_SET, NULL, NULL))
+		return CURL_SEEKFUNC_FAIL;
+	return CURL_SEEKFUNC_OK;
+}
+
+static gboolean
+fu_redfish_request_set_stream(FuRedfishRequest *self,
+			      GInputStream *stream,
+			      gsize *streamsz,
+			      GError **error)
+{
+	if (!fu_input_stream_size(stream, streamsz, error))
+		return FALSE;
+	if (!g_seekable_seek(G_SEEKABLE(stream), 0x0, G_SEEK_SET, NULL, error))
+		return FALSE;
+	g_set_object(&self->stream, stream);
+	return TRUE;
+}
+
+/* the stream is read in chunks as required, rather than copied into a libcurl buffer */
+gboolean
+fu_redfish_request_set_upload_stream(FuRedfishRequest *self, GInputStream *stream, GError **error)
+{
+	gsize streamsz = 0;
+
+	g_return_val_if_fail(FU_IS_REDFISH_REQUEST(self), FALSE);
+	g_return_val_if_fail(G_IS_INPUT_STREAM(stream), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (!fu_redfish_request_set_stream(self, stream, &streamsz, error))
+		return FALSE;
+	(void)curl_easy_setopt(self->curl, CURLOPT_POST, 1L);
+	(void)curl_easy_setopt(self->curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)streamsz);
+	(void)curl_easy_setopt(self->curl, CURLOPT_READFUNCTION, fu_redfish_request_read_cb);
+	(void)curl_easy_setopt(self->curl, CURLOPT_READDATA, self);
+	(void)curl_easy_setopt(self->curl, CURLOPT_SEEKFUNCTION, fu_redfish_request_seek_cb);
+	(void)curl_easy_setopt(self->curl, CURLOPT_SEEKDATA, self);
+	return TRUE;
+}
+
+gboolean
+fu_redfish_request_set_mime_stream(FuRedfishRequest *self,
+				   curl_mimepart *part,
+				   GInputStream *stream,
+				   GError **error)
+{
+	gsize streamsz = 0;
+
+	g_return_val_if_fail(FU_IS_REDFISH_REQUEST(self), FALSE);
+	g_return_val_if_fail(part != NULL, FALSE);
+	g_return_val_if_fail(G_IS_INPUT_STREAM(stream), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (!fu_redfish_request_set_stream(self, stream, &streamsz, error))
+		return FALSE;
+	(void)curl_mime_data_cb(part,
+				(curl_off_t)streamsz,
+				fu_redfish_request_read_cb,
+				fu_redfish_request_seek_cb,
+				NULL,
+				self);
+	return TRUE;
+}
+
+static int
+fu_redfish_request_xferinfo_cb(void *userdata,
+			       curl_off_t dltotal,
+			       curl_off_t dlnow,
+			       curl_off_t ultotal,
+			       curl_off_t ulnow)
+{
+	FuRedfishRequest *self = FU_REDFISH_REQUEST(userdata);
+	if (ultotal > 0 && ulnow <= ultotal)
+		fu_progress_set_percentage_full(self->progress, (gsize)ulnow, (gsize)ultotal);
+	return 0;
+}
+
+void
+fu_redfish_request_set_progress(FuRedfishRequest *self, FuProgress *progress)
+{
+	g_return_if_fail(FU_IS_REDFISH_REQUEST(self));
+	g_return_if_fail(FU_IS_PROGRESS(progress));
+
+	g_set_object(&self->progress, progress);
+	(void)curl_easy_setopt(self->curl,
+			       CURLOPT_XFERINFOFUNCTION,
+			       fu_redfish_request_xferinfo_cb);
+	(void)curl_easy_setopt(self->curl, CURLOPT_XFERINFODATA, self);
+	(void)curl_easy_setopt(self->curl, CURLOPT_NOPROGRESS, 0L);
+}
+
+/*
+ * Starts receiving server-sent events from @path without blocking; use
+ * fu_redfish_request_event_stream_wait() to process any data received.
+ */
+gboolean
+fu_redfish_request_event_stream_start(FuRedfishRequest *self, const gchar *path, GError **error)
+{
+	CURLMcode mc;
+	gint running = 0;
+
+	g_return_val_if_fail(FU_IS_REDFISH_REQUEST(self), FALSE);
+	g_return_val_if_fail(path != NULL, FALSE);
+	g_return_val_if_fail(self->multi == NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* the stream stays open for as long as we want to receive events */
+	(void)curl_url_set(self->uri, CURLUPART_PATH, path, 0);
+	(void)curl_easy_setopt(self->curl, CURLOPT_TIMEOUT, 0L);
+	self->headers = curl_slist_append(self->headers, "Accept: text/event-stream");
+	(void)curl_easy_setopt(self->curl, CURLOPT_HTTPHEADER, self->headers);
+	self->multi = curl_multi_init();
+	mc = curl_multi_add_handle(self->multi, self->curl);
+	if (mc == CURLM_OK)
+		mc = curl_multi_perform(self->multi, &running);
+	if (mc != CURLM_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "failed to request %s: %s",
+			    path,
+			    curl_multi_strerror(mc));
+		return FALSE;
+	}
+
+	/* success */
+	return TRUE;
+}
+
+/*
+ * Waits for up to @timeout_ms for more event data.
+ *
+ * Returns: %FALSE if the server closed the stream or it failed
+ */
+gboolean
+fu_redfish_request_event_stream_wait(FuRedfishRequest *self, guint timeout_ms)
+{
+	CURLMcode mc;
+	gint running = 0;
+
+	g_return_val_if_fail(FU_IS_REDFISH_REQUEST(self), FALSE);
+
+	if (self->multi == NULL)
+		return FALSE;
+	mc = curl_multi_wait(self->multi, NULL, 0, (gint)timeout_ms, NULL);
+	if (mc == CURLM_OK)
+		mc = curl_multi_perform(self->multi, &running);
+	if (mc != CURLM_OK || running == 0) {
+		curl_easy_getinfo(self->curl, CURLINFO_RESPONSE_CODE, &self->status_code);
+		g_debug("event stream closed [%li]", self->status_code);
+		(void)curl_multi_remove_handle(self->multi, self->curl);
+		curl_multi_cleanup(self->multi);
+		self->multi = NULL;
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/* returns the data of the next complete event, or %NULL if none has been received yet */
+gchar *
+fu_redfish_request_event_stream_pop(FuRedfishRequest *self)
+{
+	g_return_val_if_fail(FU_IS_REDFISH_REQUEST(self), NULL);
+	return fu_redfish_common_event_stream_pop(self->buf, &self->event_offset);
+}
+
+/* the saved response is used if the server replies 304 Not Modified */
+void
+fu_redfish_request_set_etag(FuRedfishRequest *self, const gchar *etag, GByteArray *buf)
+{
+	g_autofree gchar *header = NULL;
+
+	g_return_if_fail(FU_IS_REDFISH_REQUEST(self));
+	g_return_if_fail(etag != NULL);
+	g_return_if_fail(buf != NULL);
+
+	if (self->etag_buf != NULL)
+		g_byte_array_unref(self->etag_buf);
+	self->etag_buf = g_byte_array_ref(buf);
+	header = g_strdup_printf("If-None-Match: %s", etag);
+	self->headers = curl_slist_append(self->headers, header);
+	(void)curl_easy_setopt(self->curl, CURLOPT_HTTPHEADER, self->headers);
+}
+
 void
 fu_redfish_request_set_cache(FuRedfishRequest *self, GHashTable *cache)
 {
@@ -320,6 +698,20 @@ fu_redfish_request_finalize(GObject *object)
 	FuRedfishRequest *self = FU_REDFISH_REQUEST(object);
 	if (self->cache != NULL)
 		g_hash_table_unref(self->cache);
+	if (self->stream != NULL)
+		g_object_unref(self->stream);
+	if (self->progress != NULL)
+		g_object_unref(self->progress);
+	if (self->stream_error != NULL)
+		g_error_free(self->stream_error);
+	if (self->etag_buf != NULL)
+		g_byte_array_unref(self->etag_buf);
+	if (self->headers != NULL)
+		curl_slist_free_all(self->headers);
+	if (self->multi != NULL) {
+		(void)curl_multi_remove_handle(self->multi, self->curl);
+		curl_multi_cleanup(self->multi);
+	}
 	g_object_unref(self->json_parser);
 	g_byte_array_unref(self->buf);
 	curl_easy_cleanup(self->curl);
@@ -32,6 +32,12 @@ fu_redfish_request_perform_full(FuRedfishRequest *self,
 				JsonBuilder *builder,
 				FuRedfishRequestPerformFlags flags,
 				GError **error);
+gboolean
+fu_redfish_request_perform_multi(GPtrArray *requests,
+				 GPtrArray *paths,
+				 guint max_active,
+				 FuRedfishRequestPerformFlags flags,
+				 GError **error);
 JsonObject *
 fu_redfish_request_get_json_object(FuRedfishRequest *self);
 CURL *
@@ -42,5 +48,22 @@ CURLU *
 fu_redfish_request_get_uri(FuRedfishRequest *self);
 glong
 fu_redfish_request_get_status_code(FuRedfishRequest *self);
+gboolean
+fu_redfish_request_event_stream_start(FuRedfishRequest *self, const gchar *path, GError **error);
+gboolean
+fu_redfish_request_event_stream_wait(FuRedfishRequest *self, guint timeout_ms);
+gchar *
+fu_redfish_request_event_stream_pop(FuRedfishRequest *self);
+void
+fu_redfish_request_set_etag(FuRedfishRequest *self, const gchar *etag, GByteArray *buf);
 void
 fu_redfish_request_set_cache(FuRedfishRequest *self, GHashTable *cache);
+gboolean
+fu_redfish_request_set_upload_stream(FuRedfishRequest *self, GInputStream *stream, GError **error);
+gboolean
+fu_redfish_request_set_mime_stream(FuRedfishRequest *self,
+				   curl_mimepart *part,
+				   GInputStream *stream,
+				   GError **error);
+void
+fu_redfish_request_set_progress(FuRedfishRequest *self, FuProgress *progress);
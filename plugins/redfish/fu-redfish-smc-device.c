@@ -144,16 +144,17 @@ fu_redfish_smc_device_write_firmware(FuDevice *device,
 	gboolean ret;
 	g_autoptr(curl_mime) mime = NULL;
 	g_autoptr(FuRedfishRequest) request = NULL;
-	g_autoptr(GBytes) fw = NULL;
+	g_autoptr(GInputStream) stream = NULL;
 	g_autoptr(GString) params = NULL;
 
 	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 50, "write");
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 25, "upload");
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_VERIFY, 25, "verify");
 	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_RESTART, 50, "apply");
 
 	/* get default image */
-	fw = fu_firmware_get_bytes(firmware, error);
-	if (fw == NULL)
+	stream = fu_firmware_get_stream(firmware, error);
+	if (stream == NULL)
 		return FALSE;
 
 	/* create the multipart for uploading the image request */
@@ -173,9 +174,10 @@ fu_redfish_smc_device_write_firmware(FuDevice *device,
 	curl_mime_name(part, "UpdateFile");
 	(void)curl_mime_type(part, "application/octet-stream");
 	(void)curl_mime_filedata(part, "firmware.bin");
-	(void)curl_mime_data(part, g_bytes_get_data(fw, NULL), g_bytes_get_size(fw));
+	if (!fu_redfish_request_set_mime_stream(request, part, stream, error))
+		return FALSE;
 
-	fu_progress_set_status(progress, FWUPD_STATUS_DEVICE_WRITE);
+	fu_redfish_request_set_progress(request, fu_progress_get_child(progress));
 	if (!fu_redfish_request_perform(request,
 					fu_redfish_backend_get_push_uri_path(backend),
 					FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON,
@@ -193,6 +195,7 @@ fu_redfish_smc_device_write_firmware(FuDevice *device,
 			    fu_redfish_request_get_status_code(request));
 		return FALSE;
 	}
+	fu_progress_step_done(progress);
 	json_obj = fu_redfish_request_get_json_object(request);
 
 	/* poll the verify task for progress */
@@ -13,8 +13,10 @@
 #endif
 #include "fu-plugin-private.h"
 #include "fu-redfish-common.h"
+#include "fu-redfish-device.h"
 #include "fu-redfish-network.h"
 #include "fu-redfish-plugin.h"
+#include "fu-redfish-request.h"
 #include "fu-redfish-smc-device.h"
 #include "fu-redfish-struct.h"
 
@@ -211,6 +213,115 @@ fu_test_redfish_common_lenovo_func(void)
 	}
 }
 
+static void
+fu_test_redfish_common_duration_func(void)
+{
+	struct {
+		const gchar *in;
+		gboolean ret;
+		guint64 value;
+	} values[] = {{"PT5M", TRUE, 300000},
+		      {"P0DT00H05M30S", TRUE, 330000},
+		      {"P1D", TRUE, 86400000},
+		      {"PT1.5S", TRUE, 1500},
+		      {"PT0S", TRUE, 0},
+		      {"P", FALSE, 0},
+		      {"5M", FALSE, 0},
+		      {"P5M", FALSE, 0},
+		      {"PT5X", FALSE, 0},
+		      {"PT", FALSE, 0},
+		      {"P1DT", FALSE, 0},
+		      {"PTinfS", FALSE, 0},
+		      {"PTnanS", FALSE, 0},
+		      {"PT-5S", FALSE, 0},
+		      {"P99999999999D", FALSE, 0},
+		      {NULL, FALSE, 0}};
+	for (guint i = 0; values[i].in != NULL; i++) {
+		gboolean ret;
+		guint64 value = 0;
+		ret = fu_redfish_common_parse_duration(values[i].in, &value, NULL);
+		g_assert_cmpint(ret, ==, values[i].ret);
+		g_assert_cmpint(value, ==, values[i].value);
+	}
+}
+
+static void
+fu_test_redfish_common_poll_delay_func(void)
+{
+	guint delay = 0;
+
+	/* no estimate, so back off up to a limit */
+	delay = fu_redfish_common_get_poll_delay(delay, 0, -1, 0, -1, 0);
+	g_assert_cmpint(delay, ==, FU_REDFISH_DEVICE_POLL_DELAY_MIN);
+	delay = fu_redfish_common_get_poll_delay(delay, 250, -1, 0, -1, 0);
+	g_assert_cmpint(delay, ==, 375);
+	for (guint i = 0; i < 10; i++)
+		delay = fu_redfish_common_get_poll_delay(delay, 1000, -1, 0, -1, 0);
+	g_assert_cmpint(delay, ==, FU_REDFISH_DEVICE_POLL_DELAY_UNKNOWN_MAX);
+
+	/* estimated duration from the BMC */
+	delay = fu_redfish_common_get_poll_delay(0, 0, -1, 0, -1, 60000);
+	g_assert_cmpint(delay, ==, FU_REDFISH_DEVICE_POLL_DELAY_MAX);
+	delay = fu_redfish_common_get_poll_delay(0, 58000, -1, 0, -1, 60000);
+	g_assert_cmpint(delay, ==, 500);
+	delay = fu_redfish_common_get_poll_delay(0, 59900, -1, 0, -1, 60000);
+	g_assert_cmpint(delay, ==, FU_REDFISH_DEVICE_POLL_DELAY_MIN);
+
+	/* overrunning the estimate falls back to backing off */
+	delay = fu_redfish_common_get_poll_delay(1000, 70000, -1, 0, -1, 60000);
+	g_assert_cmpint(delay, ==, 1500);
+
+	/* 10% done per second, so 8 seconds to go, which is preferred over the estimate */
+	delay = fu_redfish_common_get_poll_delay(0, 2000, 10, 1000, 20, 60000);
+	g_assert_cmpint(delay, ==, 2000);
+
+	/* percentage has not changed yet */
+	delay = fu_redfish_common_get_poll_delay(0, 2000, 10, 1000, 10, 0);
+	g_assert_cmpint(delay, ==, FU_REDFISH_DEVICE_POLL_DELAY_MIN);
+}
+
+static void
+fu_test_redfish_common_event_stream_func(void)
+{
+	gsize offset = 0;
+	const gchar *data1 = ": keepalive\n\n"
+			     "data: one\n\n"
+			     "event: Alert\r\n"
+			     "data: {\r\n"
+			     "data: }\r\n\r\n"
+			     "data: par";
+	const gchar *data2 = "tial\n\n";
+	g_autofree gchar *event1 = NULL;
+	g_autofree gchar *event2 = NULL;
+	g_autofree gchar *event3 = NULL;
+	g_autofree gchar *event4 = NULL;
+	g_autofree gchar *event5 = NULL;
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+
+	/* the keepalive comment has no data */
+	g_byte_array_append(buf, (const guint8 *)data1, strlen(data1));
+	event1 = fu_redfish_common_event_stream_pop(buf, &offset);
+	g_assert_cmpstr(event1, ==, "one");
+
+	/* multiple data lines are joined, and CRLF line endings are accepted */
+	event2 = fu_redfish_common_event_stream_pop(buf, &offset);
+	g_assert_cmpstr(event2, ==, "{\n}");
+
+	/* incomplete event is kept until the rest is received */
+	event3 = fu_redfish_common_event_stream_pop(buf, &offset);
+	g_assert_null(event3);
+	g_assert_cmpint(offset, >, 0);
+	g_byte_array_append(buf, (const guint8 *)data2, strlen(data2));
+	event4 = fu_redfish_common_event_stream_pop(buf, &offset);
+	g_assert_cmpstr(event4, ==, "partial");
+
+	/* everything consumed, so the buffer is reset */
+	event5 = fu_redfish_common_event_stream_pop(buf, &offset);
+	g_assert_null(event5);
+	g_assert_cmpint(offset, ==, 0);
+	g_assert_cmpint(buf->len, ==, 0);
+}
+
 static void
 fu_test_redfish_network_mac_addr_func(void)
 {
@@ -373,6 +484,128 @@ fu_test_redfish_smc_devices_func(gconstpointer user_data)
 	g_assert_true(FU_IS_REDFISH_SMC_DEVICE(dev));
 }
 
+static void
+fu_test_redfish_request_multi_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	FuRedfishBackend *backend;
+	GPtrArray *devices;
+	gboolean ret;
+	const gchar *paths_strv[] = {"/redfish/v1/UpdateService/FirmwareInventory/BMC",
+				     "/redfish/v1/UpdateService/FirmwareInventory/BIOS",
+				     "/redfish/v1/UpdateService/FirmwareInventory/MISSING",
+				     NULL};
+	g_autoptr(FuRedfishRequest) request_bmc = NULL;
+	g_autoptr(FuRedfishRequest) request_missing = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) paths = g_ptr_array_new();
+	g_autoptr(GPtrArray) requests = g_ptr_array_new_with_free_func(g_object_unref);
+
+	devices = fu_plugin_get_devices(self->plugin);
+	g_assert_nonnull(devices);
+	if (devices->len == 0) {
+		g_test_skip("no redfish support");
+		return;
+	}
+	backend = fu_redfish_device_get_backend(FU_REDFISH_DEVICE(g_ptr_array_index(devices, 0)));
+
+	/* fewer in flight than requests */
+	for (guint i = 0; paths_strv[i] != NULL; i++) {
+		g_ptr_array_add(requests, fu_redfish_backend_request_new(backend));
+		g_ptr_array_add(paths, (gpointer)paths_strv[i]);
+	}
+	ret = fu_redfish_request_perform_multi(requests,
+					       paths,
+					       2,
+					       FU_REDFISH_REQUEST_PERFORM_FLAG_NONE,
+					       &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(fu_redfish_request_get_status_code(g_ptr_array_index(requests, 0)),
+			==,
+			200);
+	g_assert_cmpint(fu_redfish_request_get_status_code(g_ptr_array_index(requests, 1)),
+			==,
+			200);
+	g_assert_cmpint(fu_redfish_request_get_status_code(g_ptr_array_index(requests, 2)),
+			==,
+			404);
+
+	/* the success is served from the cache, but the failure is requested again */
+	request_bmc = fu_redfish_backend_request_new(backend);
+	ret = fu_redfish_request_perform(request_bmc,
+					 paths_strv[0],
+					 FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON |
+					     FU_REDFISH_REQUEST_PERFORM_FLAG_USE_CACHE,
+					 &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(fu_redfish_request_get_status_code(request_bmc), ==, 0);
+	request_missing = fu_redfish_backend_request_new(backend);
+	ret = fu_redfish_request_perform(request_missing,
+					 paths_strv[2],
+					 FU_REDFISH_REQUEST_PERFORM_FLAG_USE_CACHE,
+					 &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(fu_redfish_request_get_status_code(request_missing), ==, 404);
+}
+
+static void
+fu_test_redfish_request_etag_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	FuRedfishBackend *backend;
+	GPtrArray *devices;
+	gboolean ret;
+	const gchar *saved = "{\"@odata.id\": \"saved\"}";
+	g_autoptr(FuRedfishRequest) request_match = NULL;
+	g_autoptr(FuRedfishRequest) request_stale = NULL;
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GError) error = NULL;
+
+	devices = fu_plugin_get_devices(self->plugin);
+	g_assert_nonnull(devices);
+	if (devices->len == 0) {
+		g_test_skip("no redfish support");
+		return;
+	}
+	backend = fu_redfish_device_get_backend(FU_REDFISH_DEVICE(g_ptr_array_index(devices, 0)));
+	g_byte_array_append(buf, (const guint8 *)saved, strlen(saved));
+
+	/* not modified, so the saved response is used */
+	request_match = fu_redfish_backend_request_new(backend);
+	fu_redfish_request_set_etag(request_match, "653b835e9ee4af9ea7ea", buf);
+	ret = fu_redfish_request_perform(request_match,
+					 "/redfish/v1/UpdateService/FirmwareInventory/BMC",
+					 FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON,
+					 &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(fu_redfish_request_get_status_code(request_match), ==, 304);
+	g_assert_cmpstr(json_object_get_string_member(
+			    fu_redfish_request_get_json_object(request_match),
+			    "@odata.id"),
+			==,
+			"saved");
+
+	/* changed since it was saved */
+	request_stale = fu_redfish_backend_request_new(backend);
+	fu_redfish_request_set_etag(request_stale, "stale", buf);
+	ret = fu_redfish_request_perform(request_stale,
+					 "/redfish/v1/UpdateService/FirmwareInventory/BMC",
+					 FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON,
+					 &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(fu_redfish_request_get_status_code(request_stale), ==, 200);
+	g_assert_cmpstr(json_object_get_string_member(
+			    fu_redfish_request_get_json_object(request_stale),
+			    "@odata.id"),
+			==,
+			"/redfish/v1/UpdateService/FirmwareInventory/BMC");
+}
+
 static void
 fu_test_redfish_update_func(gconstpointer user_data)
 {
@@ -488,9 +721,12 @@ G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuTest, fu_test_self_free)
 int
 main(int argc, char **argv)
 {
+	gint rc;
 	g_autoptr(FuTest) self = g_new0(FuTest, 1);
+	g_autofree gchar *cachedir = NULL;
 	g_autofree gchar *smbios_data_fn = NULL;
 	g_autofree gchar *testdatadir = NULL;
+	g_autoptr(GError) error = NULL;
 
 	(void)g_setenv("G_TEST_SRCDIR", SRCDIR, FALSE);
 	g_test_init(&argc, &argv, NULL);
@@ -504,12 +740,21 @@ main(int argc, char **argv)
 	(void)g_setenv("CONFIGURATION_DIRECTORY", testdatadir, TRUE);
 	(void)g_setenv("FWUPD_SYSFSFWATTRIBDIR", testdatadir, TRUE);
 
+	/* do not use or save the ETag cache of the real system */
+	cachedir = g_dir_make_tmp("fwupd-redfish-XXXXXX", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(cachedir);
+	(void)g_setenv("CACHE_DIRECTORY", cachedir, TRUE);
+
 	g_log_set_fatal_mask(NULL, G_LOG_LEVEL_ERROR | G_LOG_LEVEL_CRITICAL);
 	fu_test_self_init(self);
 	g_test_add_func("/redfish/ipmi", fu_test_redfish_ipmi_func);
 	g_test_add_func("/redfish/common", fu_test_redfish_common_func);
 	g_test_add_func("/redfish/common{version}", fu_test_redfish_common_version_func);
 	g_test_add_func("/redfish/common{lenovo}", fu_test_redfish_common_lenovo_func);
+	g_test_add_func("/redfish/common{duration}", fu_test_redfish_common_duration_func);
+	g_test_add_func("/redfish/common{poll-delay}", fu_test_redfish_common_poll_delay_func);
+	g_test_add_func("/redfish/common{event-stream}", fu_test_redfish_common_event_stream_func);
 	g_test_add_func("/redfish/network{mac_addr}", fu_test_redfish_network_mac_addr_func);
 	g_test_add_func("/redfish/network{vid_pid}", fu_test_redfish_network_vid_pid_func);
 	g_test_add_data_func("/redfish/unlicensed_plugin{devices}",
@@ -520,6 +765,11 @@ main(int argc, char **argv)
 			     fu_test_redfish_smc_devices_func);
 	g_test_add_data_func("/redfish/smc_plugin{update}", self, fu_test_redfish_smc_update_func);
 	g_test_add_data_func("/redfish/plugin{devices}", self, fu_test_redfish_devices_func);
+	g_test_add_data_func("/redfish/request{multi}", self, fu_test_redfish_request_multi_func);
+	g_test_add_data_func("/redfish/request{etag}", self, fu_test_redfish_request_etag_func);
 	g_test_add_data_func("/redfish/plugin{update}", self, fu_test_redfish_update_func);
-	return g_test_run();
+	rc = g_test_run();
+	if (!fu_path_rmtree(cachedir, &error))
+		g_warning("failed to delete %s: %s", cachedir, error->message);
+	return rc;
 }
@@ -130,6 +130,8 @@ def firmware_inventory_bmc():
         res["Manufacturer"] = "SMCI"
     else:
         res["Manufacturer"] = "Lenovo"
+    if request.headers.get("If-None-Match") == res["@odata.etag"]:
+        return Response(status=304)
     return Response(json.dumps(res), status=200, mimetype="application/json")
 
 
@@ -79,6 +79,7 @@ struct _FuSynapticsMstDevice {
 	guint8 active_bank;
 	guint32 board_id;
 	guint16 chip_id;
+	gboolean rc_enabled;
 };
 
 G_DEFINE_TYPE(FuSynapticsMstDevice, fu_synaptics_mst_device, FU_TYPE_DPAUX_DEVICE)
@@ -239,13 +240,15 @@ fu_synaptics_mst_device_rc_send_command_and_wait(FuSynapticsMstDevice *self,
 		return FALSE;
 	}
 
-	/* wait command complete */
-	if (!fu_device_retry_full(FU_DEVICE(self),
-				  fu_synaptics_mst_device_rc_send_command_and_wait_cb,
-				  30,
-				  100, /* ms */
-				  &helper,
-				  error)) {
+	/* wait command complete, most finish in a few ms so poll quickly at first */
+	if (!fu_device_retry_backoff(FU_DEVICE(self),
+				     fu_synaptics_mst_device_rc_send_command_and_wait_cb,
+				     3000, /* ms */
+				     1,	   /* ms */
+				     100,  /* ms */
+				     FU_DEVICE_RETRY_FLAG_BACKOFF,
+				     &helper,
+				     error)) {
 		g_prefix_error(error, "remote command failed: ");
 		return FALSE;
 	}
@@ -412,6 +415,8 @@ fu_synaptics_mst_device_disable_rc(FuSynapticsMstDevice *self, GError **error)
 {
 	g_autoptr(GError) error_local = NULL;
 
+	self->rc_enabled = FALSE;
+
 	/* in test mode */
 	if (fu_udev_device_get_dev(FU_UDEV_DEVICE(self)) == NULL)
 		return TRUE;
@@ -443,8 +448,10 @@ fu_synaptics_mst_device_enable_rc(FuSynapticsMstDevice *self, GError **error)
 	const gchar *sc = "PRIUS";
 
 	/* in test mode */
-	if (fu_udev_device_get_dev(FU_UDEV_DEVICE(self)) == NULL)
+	if (fu_udev_device_get_dev(FU_UDEV_DEVICE(self)) == NULL) {
+		self->rc_enabled = TRUE;
 		return TRUE;
+	}
 
 	if (!fu_synaptics_mst_device_disable_rc(self, error)) {
 		g_prefix_error(error, "failed to disable-to-enable: ");
@@ -459,6 +466,7 @@ fu_synaptics_mst_device_enable_rc(FuSynapticsMstDevice *self, GError **error)
 		g_prefix_error(error, "failed to enable remote control: ");
 		return FALSE;
 	}
+	self->rc_enabled = TRUE;
 	return TRUE;
 }
 
@@ -561,6 +569,55 @@ fu_synaptics_mst_device_get_flash_checksum(FuSynapticsMstDevice *self,
 	return TRUE;
 }
 
+/* remote control must already be enabled, e.g. when called from ->write_firmware() */
+static gboolean
+fu_synaptics_mst_device_read_checksum(FuDevice *device,
+				      gsize address,
+				      gsize size,
+				      FuChecksumKind *kind,
+				      guint32 *value,
+				      GError **error)
+{
+	FuSynapticsMstDevice *self = FU_SYNAPTICS_MST_DEVICE(device);
+
+	if (!self->rc_enabled) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_SUPPORTED,
+				    "reading checksum requires remote control");
+		return FALSE;
+	}
+	if (address > G_MAXUINT32 || size > G_MAXUINT32 - address) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "checksum range 0x%x+0x%x is out of range",
+			    (guint)address,
+			    (guint)size);
+		return FALSE;
+	}
+
+	/* the EEPROM checksum is only known to be a SUM32 on these */
+	if (self->family != FU_SYNAPTICS_MST_FAMILY_TESLA &&
+	    self->family != FU_SYNAPTICS_MST_FAMILY_LEAF &&
+	    self->family != FU_SYNAPTICS_MST_FAMILY_PANAMERA) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "reading checksum not supported on %s",
+			    fu_synaptics_mst_family_to_string(self->family));
+		return FALSE;
+	}
+	if (!fu_synaptics_mst_device_get_flash_checksum(self,
+							(guint32)address,
+							(guint32)size,
+							value,
+							error))
+		return FALSE;
+	*kind = FU_CHECKSUM_KIND_SUM32;
+	return TRUE;
+}
+
 static gboolean
 fu_synaptics_mst_device_set_flash_sector_erase(FuSynapticsMstDevice *self,
 					       guint16 rc_cmd,
@@ -725,7 +782,6 @@ fu_synaptics_mst_device_update_tesla_leaf_firmware_cb(FuDevice *device,
 {
 	FuSynapticsMstDevice *self = FU_SYNAPTICS_MST_DEVICE(device);
 	FuSynapticsMstDeviceHelper *helper = (FuSynapticsMstDeviceHelper *)user_data;
-	guint32 flash_checksum = 0;
 
 	if (!fu_synaptics_mst_device_set_flash_sector_erase(self, 0xffff, 0, error))
 		return FALSE;
@@ -769,24 +825,7 @@ fu_synaptics_mst_device_update_tesla_leaf_firmware_cb(FuDevice *device,
 	}
 
 	/* check data just written */
-	if (!fu_synaptics_mst_device_get_flash_checksum(self,
-							0,
-							g_bytes_get_size(helper->fw),
-							&flash_checksum,
-							error))
-		return FALSE;
-	if (helper->checksum != flash_checksum) {
-		g_set_error(error,
-			    FWUPD_ERROR,
-			    FWUPD_ERROR_INVALID_DATA,
-			    "checksum 0x%x mismatched 0x%x",
-			    flash_checksum,
-			    helper->checksum);
-		return FALSE;
-	}
-
-	/* success */
-	return TRUE;
+	return fu_device_verify_checksum(device, 0x0, helper->fw, error);
 }
 
 static gboolean
@@ -797,7 +836,6 @@ fu_synaptics_mst_device_update_tesla_leaf_firmware(FuSynapticsMstDevice *self,
 {
 	g_autoptr(FuSynapticsMstDeviceHelper) helper = fu_synaptics_mst_device_helper_new();
 	helper->fw = g_bytes_ref(fw);
-	helper->checksum = fu_sum32_bytes(fw);
 	helper->progress = g_object_ref(progress);
 	helper->chunks = fu_chunk_array_new_from_bytes(fw, 0x0, BLOCK_UNIT);
 	return fu_device_retry(FU_DEVICE(self),
@@ -1337,6 +1375,7 @@ fu_synaptics_mst_device_restart(FuSynapticsMstDevice *self, GError **error)
 						    sizeof(buf),
 						    &error_local))
 		g_debug("failed to restart: %s", error_local->message);
+	self->rc_enabled = FALSE;
 
 	return TRUE;
 }
@@ -1799,4 +1838,5 @@ fu_synaptics_mst_device_class_init(FuSynapticsMstDeviceClass *klass)
 	device_class->attach = fu_synaptics_mst_device_attach;
 	device_class->prepare_firmware = fu_synaptics_mst_device_prepare_firmware;
 	device_class->set_progress = fu_synaptics_mst_device_set_progress;
+	device_class->read_checksum = fu_synaptics_mst_device_read_checksum;
 }
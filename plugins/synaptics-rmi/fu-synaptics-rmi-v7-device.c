@@ -769,6 +769,7 @@ fu_synaptics_rmi_device_read_flash_config_v7(FuSynapticsRmiDevice *self, GError
 	g_autoptr(GByteArray) req_partition_id = g_byte_array_new();
 	g_autoptr(GByteArray) req_transfer_length = g_byte_array_new();
 	g_autoptr(GByteArray) res = NULL;
+	g_autoptr(GByteArray) st_prt = NULL;
 	gsize partition_size = FU_STRUCT_RMI_PARTITION_TBL_SIZE;
 
 	/* f34 */
@@ -840,11 +841,10 @@ fu_synaptics_rmi_device_read_flash_config_v7(FuSynapticsRmiDevice *self, GError
 		partition_size += 0x2;
 
 	/* parse the config length */
+	st_prt = g_byte_array_new();
 	for (guint i = 0x2; i < res->len; i += partition_size) {
 		guint16 partition_id;
-		g_autoptr(GByteArray) st_prt = NULL;
-		st_prt = fu_struct_rmi_partition_tbl_parse(res->data, res->len, i, error);
-		if (st_prt == NULL)
+		if (!fu_struct_rmi_partition_tbl_parse_into(st_prt, res->data, res->len, i, error))
 			return FALSE;
 		partition_id = fu_struct_rmi_partition_tbl_get_partition_id(st_prt);
 		g_debug("found partition %s (0x%02x)",
@@ -21,7 +21,7 @@ enum FuRmiPartitionId {
     FixedLocationData = 0x0E,
 }
 
-#[derive(Parse)]
+#[derive(ParseInto)]
 struct FuStructRmiPartitionTbl {
     partition_id: FuRmiPartitionId,
     partition_len: u16le,
@@ -9,6 +9,7 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <glib/gstdio.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -18,10 +19,27 @@
 
 typedef struct {
 	const gchar *auth_method;
+	guint32 block_size;
 } FuThunderboltDevicePrivate;
 
 #define TBT_NVM_RETRY_TIMEOUT		     200   /* ms */
 #define FU_PLUGIN_THUNDERBOLT_UPDATE_TIMEOUT 60000 /* ms */
+#define FU_THUNDERBOLT_DEVICE_BLOCK_SIZE     0x10000
+#define FU_THUNDERBOLT_DEVICE_BLOCK_SIZE_MIN 0x1000
+
+typedef struct {
+	guint8 *data;
+	gsize datasz;
+} FuThunderboltDeviceBlock;
+
+typedef struct {
+	GInputStream *stream;
+	gsize block_size;
+	GAsyncQueue *empty; /* of FuThunderboltDeviceBlock */
+	GAsyncQueue *full;  /* of FuThunderboltDeviceBlock */
+	GCancellable *cancellable;
+	GError *error; /* set by the reader thread */
+} FuThunderboltDeviceReader;
 
 G_DEFINE_TYPE_WITH_PRIVATE(FuThunderboltDevice, fu_thunderbolt_device, FU_TYPE_UDEV_DEVICE)
 
@@ -157,6 +175,7 @@ fu_thunderbolt_device_to_string(FuDevice *device, guint idt, GString *str)
 	FuThunderboltDevice *self = FU_THUNDERBOLT_DEVICE(device);
 	FuThunderboltDevicePrivate *priv = GET_PRIVATE(self);
 	fwupd_codec_string_append(str, idt, "AuthMethod", priv->auth_method);
+	fwupd_codec_string_append_hex(str, idt, "BlockSize", priv->block_size);
 }
 
 void
@@ -242,34 +261,95 @@ fu_thunderbolt_device_rescan(FuDevice *device, GError **error)
 	return fu_thunderbolt_device_get_version(self, error);
 }
 
+/* reads the next block from the firmware while the previous block is being written */
+static gpointer
+fu_thunderbolt_device_reader_thread_cb(gpointer user_data)
+{
+	FuThunderboltDeviceReader *reader = (FuThunderboltDeviceReader *)user_data;
+
+	while (TRUE) {
+		FuThunderboltDeviceBlock *block = g_async_queue_pop(reader->empty);
+		gsize datasz = 0;
+
+		/* the writer failed */
+		if (g_cancellable_is_cancelled(reader->cancellable))
+			return NULL;
+
+		/* a zero-sized block signals the end of the stream, or a failure */
+		if (!g_input_stream_read_all(reader->stream,
+					     block->data,
+					     reader->block_size,
+					     &datasz,
+					     reader->cancellable,
+					     &reader->error))
+			datasz = 0;
+		block->datasz = datasz;
+		g_async_queue_push(reader->full, block);
+		if (datasz == 0)
+			return NULL;
+	}
+}
+
+static gboolean
+fu_thunderbolt_device_write_block(gint fd, const guint8 *data, gsize datasz, GError **error)
+{
+	gsize idx = 0;
+
+	while (idx < datasz) {
+		gssize wrote = write(fd, data + idx, datasz - idx);
+		if (wrote < 0) {
+			if (errno == EINTR)
+				continue;
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_WRITE,
+				    "failed to write: %s",
+				    g_strerror(errno));
+			return FALSE;
+		}
+		idx += wrote;
+	}
+	return TRUE;
+}
+
 static gboolean
-fu_thunderbolt_device_write_stream(GOutputStream *ostream,
-				   GBytes *bytes,
+fu_thunderbolt_device_write_blocks(FuThunderboltDeviceReader *reader,
+				   gint fd,
+				   gsize streamsz,
 				   FuProgress *progress,
 				   GError **error)
 {
-	gsize bufsz = g_bytes_get_size(bytes);
 	gsize total_written = 0;
 
-	do {
-		gssize wrote;
-		g_autoptr(GBytes) fw_data = NULL;
-		fw_data = fu_bytes_new_offset(bytes, total_written, bufsz - total_written, error);
-		if (fw_data == NULL)
-			return FALSE;
-		wrote = g_output_stream_write_bytes(ostream, fw_data, NULL, error);
-		if (wrote < 0)
+	while (TRUE) {
+		FuThunderboltDeviceBlock *block = g_async_queue_pop(reader->full);
+
+		/* the reader thread has finished */
+		if (block->datasz == 0) {
+			if (reader->error != NULL) {
+				g_propagate_error(error, g_steal_pointer(&reader->error));
+				return FALSE;
+			}
+			break;
+		}
+
+		/* stop the reader before giving the block back so it cannot wait forever */
+		if (!fu_thunderbolt_device_write_block(fd, block->data, block->datasz, error)) {
+			g_cancellable_cancel(reader->cancellable);
+			g_async_queue_push(reader->empty, block);
 			return FALSE;
-		total_written += wrote;
-		fu_progress_set_percentage_full(progress, total_written, bufsz);
-	} while (total_written < bufsz);
-	if (total_written != bufsz) {
+		}
+		total_written += block->datasz;
+		g_async_queue_push(reader->empty, block);
+		fu_progress_set_percentage_full(progress, total_written, streamsz);
+	}
+	if (total_written != streamsz) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_WRITE,
 			    "only wrote 0x%x of 0x%x",
 			    (guint)total_written,
-			    (guint)bufsz);
+			    (guint)streamsz);
 		return FALSE;
 	}
 
@@ -277,24 +357,81 @@ fu_thunderbolt_device_write_stream(GOutputStream *ostream,
 	return TRUE;
 }
 
+static gboolean
+fu_thunderbolt_device_write_stream(FuThunderboltDevice *self,
+				   gint fd,
+				   GInputStream *stream,
+				   FuProgress *progress,
+				   GError **error)
+{
+	FuThunderboltDevicePrivate *priv = GET_PRIVATE(self);
+	FuThunderboltDeviceBlock blocks[2] = {0};
+	FuThunderboltDeviceReader reader = {
+	    .stream = stream,
+	    .block_size = priv->block_size,
+	};
+	GThread *thread;
+	gboolean ret;
+	gsize streamsz = 0;
+
+	if (!fu_input_stream_size(stream, &streamsz, error))
+		return FALSE;
+	if (!g_seekable_seek(G_SEEKABLE(stream), 0x0, G_SEEK_SET, NULL, error))
+		return FALSE;
+
+	/* the same two buffers are used for the whole image */
+	reader.empty = g_async_queue_new();
+	reader.full = g_async_queue_new();
+	reader.cancellable = g_cancellable_new();
+	for (guint i = 0; i < G_N_ELEMENTS(blocks); i++) {
+		blocks[i].data = g_malloc(priv->block_size);
+		g_async_queue_push(reader.empty, &blocks[i]);
+	}
+	thread = g_thread_new("fu-thunderbolt-read",
+			      fu_thunderbolt_device_reader_thread_cb,
+			      &reader);
+	ret = fu_thunderbolt_device_write_blocks(&reader, fd, streamsz, progress, error);
+	g_thread_join(thread);
+
+	for (guint i = 0; i < G_N_ELEMENTS(blocks); i++)
+		g_free(blocks[i].data);
+	if (reader.error != NULL)
+		g_error_free(reader.error);
+	g_object_unref(reader.cancellable);
+	g_async_queue_unref(reader.full);
+	g_async_queue_unref(reader.empty);
+	return ret;
+}
+
 static gboolean
 fu_thunderbolt_device_write_data(FuThunderboltDevice *self,
-				 GBytes *blob_fw,
+				 GInputStream *stream,
 				 FuProgress *progress,
 				 GError **error)
 {
+	gint fd;
+	g_autofree gchar *fn = NULL;
 	g_autoptr(GFile) nvmem = NULL;
-	g_autoptr(GOutputStream) ostream = NULL;
 
 	nvmem = fu_thunderbolt_device_find_nvmem(self, FALSE, error);
 	if (nvmem == NULL)
 		return FALSE;
-	ostream = (GOutputStream *)g_file_append_to(nvmem, G_FILE_CREATE_NONE, NULL, error);
-	if (ostream == NULL)
+	fn = g_file_get_path(nvmem);
+	fd = g_open(fn, O_WRONLY | O_APPEND, 0);
+	if (fd < 0) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "failed to open %s: %s",
+			    fn,
+			    g_strerror(errno));
 		return FALSE;
-	if (!fu_thunderbolt_device_write_stream(ostream, blob_fw, progress, error))
+	}
+	if (!fu_thunderbolt_device_write_stream(self, fd, stream, progress, error)) {
+		g_close(fd, NULL);
 		return FALSE;
-	return g_output_stream_close(ostream, NULL, error);
+	}
+	return g_close(fd, error);
 }
 
 static FuFirmware *
@@ -356,15 +493,15 @@ fu_thunderbolt_device_write_firmware(FuDevice *device,
 				     GError **error)
 {
 	FuThunderboltDevice *self = FU_THUNDERBOLT_DEVICE(device);
-	g_autoptr(GBytes) blob_fw = NULL;
+	g_autoptr(GInputStream) stream = NULL;
 
 	/* get default image */
-	blob_fw = fu_firmware_get_bytes(firmware, error);
-	if (blob_fw == NULL)
+	stream = fu_firmware_get_stream(firmware, error);
+	if (stream == NULL)
 		return FALSE;
 
 	fu_progress_set_status(progress, FWUPD_STATUS_DEVICE_WRITE);
-	if (!fu_thunderbolt_device_write_data(self, blob_fw, progress, error)) {
+	if (!fu_thunderbolt_device_write_data(self, stream, progress, error)) {
 		g_prefix_error(error,
 			       "could not write firmware to thunderbolt device at %s: ",
 			       fu_udev_device_get_sysfs_path(FU_UDEV_DEVICE(self)));
@@ -418,6 +555,35 @@ fu_thunderbolt_device_probe(FuDevice *device, GError **error)
 	return TRUE;
 }
 
+static gboolean
+fu_thunderbolt_device_set_quirk_kv(FuDevice *device,
+				   const gchar *key,
+				   const gchar *value,
+				   GError **error)
+{
+	FuThunderboltDevice *self = FU_THUNDERBOLT_DEVICE(device);
+	FuThunderboltDevicePrivate *priv = GET_PRIVATE(self);
+	guint64 tmp = 0;
+
+	if (g_strcmp0(key, "ThunderboltBlockSize") == 0) {
+		if (!fu_strtoull(value,
+				 &tmp,
+				 FU_THUNDERBOLT_DEVICE_BLOCK_SIZE_MIN,
+				 FU_THUNDERBOLT_DEVICE_BLOCK_SIZE,
+				 error))
+			return FALSE;
+		priv->block_size = tmp;
+		return TRUE;
+	}
+
+	/* failed */
+	g_set_error_literal(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "quirk key not supported");
+	return FALSE;
+}
+
 static void
 fu_thunderbolt_device_set_progress(FuDevice *self, FuProgress *progress)
 {
@@ -433,6 +599,7 @@ fu_thunderbolt_device_init(FuThunderboltDevice *self)
 {
 	FuThunderboltDevicePrivate *priv = GET_PRIVATE(self);
 	priv->auth_method = "nvm_authenticate";
+	priv->block_size = FU_THUNDERBOLT_DEVICE_BLOCK_SIZE;
 	fu_device_add_icon(FU_DEVICE(self), "thunderbolt");
 	fu_device_add_protocol(FU_DEVICE(self), "com.intel.thunderbolt");
 	fu_device_add_internal_flag(FU_DEVICE(self), FU_DEVICE_INTERNAL_FLAG_NO_PROBE_COMPLETE);
@@ -451,4 +618,5 @@ fu_thunderbolt_device_class_init(FuThunderboltDeviceClass *klass)
 	device_class->attach = fu_thunderbolt_device_attach;
 	device_class->rescan = fu_thunderbolt_device_rescan;
 	device_class->set_progress = fu_thunderbolt_device_set_progress;
+	device_class->set_quirk_kv = fu_thunderbolt_device_set_quirk_kv;
 }
@@ -117,6 +117,8 @@ static void
 fu_thunderbolt_plugin_constructed(GObject *obj)
 {
 	FuPlugin *plugin = FU_PLUGIN(obj);
+	FuContext *ctx = fu_plugin_get_context(plugin);
+	fu_context_add_quirk_key(ctx, "ThunderboltBlockSize");
 	fu_plugin_add_udev_subsystem(plugin, "thunderbolt");
 	fu_plugin_add_device_gtype(plugin, FU_TYPE_THUNDERBOLT_CONTROLLER);
 	fu_plugin_add_device_gtype(plugin, FU_TYPE_THUNDERBOLT_RETIMER);
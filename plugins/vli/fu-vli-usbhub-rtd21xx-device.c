@@ -157,11 +157,15 @@ fu_vli_usbhub_device_rtd21xx_read_status(FuVliUsbhubRtd21xxDevice *self,
 					 guint8 *status,
 					 GError **error)
 {
-	return fu_device_retry(FU_DEVICE(self),
-			       fu_vli_usbhub_device_rtd21xx_read_status_cb,
-			       4200,
-			       status,
-			       error);
+	/* the status is usually ready well before the 30ms retry delay */
+	return fu_device_retry_backoff(FU_DEVICE(self),
+				       fu_vli_usbhub_device_rtd21xx_read_status_cb,
+				       4200 * 30, /* ms */
+				       1,	  /* ms */
+				       30,	  /* ms */
+				       FU_DEVICE_RETRY_FLAG_BACKOFF,
+				       status,
+				       error);
 }
 
 static gboolean
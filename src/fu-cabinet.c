@@ -98,29 +98,13 @@ fu_cabinet_add_file(FuCabinet *self, const gchar *basename, GBytes *data)
 	fu_firmware_add_image(FU_FIRMWARE(self), FU_FIRMWARE(img));
 }
 
-/* sets the firmware and signature blobs on XbNode */
-static gboolean
-fu_cabinet_parse_release(FuCabinet *self, XbNode *release, GError **error)
+/* the checksum of the payload in the metainfo file, and the filename it applies to */
+static XbNode *
+fu_cabinet_get_release_checksum(XbNode *release, const gchar **filename)
 {
 	const gchar *csum_filename = NULL;
-	gsize streamsz = 0;
-	g_autofree gchar *basename = NULL;
-	g_autoptr(FuFirmware) img_blob = NULL;
-	g_autoptr(GInputStream) stream = NULL;
-	g_autoptr(GError) error_local2 = NULL;
 	g_autoptr(XbNode) artifact = NULL;
 	g_autoptr(XbNode) csum_tmp = NULL;
-	g_autoptr(XbNode) metadata_trust = NULL;
-	g_autoptr(XbNode) nsize = NULL;
-	g_autoptr(JcatItem) item = NULL;
-	g_autoptr(GBytes) release_flags_blob = NULL;
-	g_autoptr(GBytes) filename_blob = NULL;
-	FwupdReleaseFlags release_flags = FWUPD_RELEASE_FLAG_NONE;
-
-	/* we set this with XbBuilderSource before the silo was created */
-	metadata_trust = xb_node_query_first(release, "../../info/metadata_trust", NULL);
-	if (metadata_trust != NULL)
-		release_flags |= FWUPD_RELEASE_FLAG_TRUSTED_METADATA;
 
 	/* look for source artifact first */
 	artifact = xb_node_query_first(release, "artifacts/artifact[@type='source']", NULL);
@@ -139,8 +123,35 @@ fu_cabinet_parse_release(FuCabinet *self, XbNode *release, GError **error)
 	 * something like: <checksum target="content" filename="FLASH.ROM"/> */
 	if (csum_filename == NULL)
 		csum_filename = "firmware.bin";
+	if (filename != NULL)
+		*filename = csum_filename;
+	return g_steal_pointer(&csum_tmp);
+}
+
+/* sets the firmware basename and size on XbNode without reading the payload */
+static gboolean
+fu_cabinet_parse_release(FuCabinet *self, XbNode *release, GError **error)
+{
+	const gchar *csum_filename = NULL;
+	gsize streamsz = 0;
+	g_autofree gchar *basename = NULL;
+	g_autoptr(FuFirmware) img_blob = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+	g_autoptr(GError) error_local2 = NULL;
+	g_autoptr(XbNode) csum_tmp = NULL;
+	g_autoptr(XbNode) metadata_trust = NULL;
+	g_autoptr(XbNode) nsize = NULL;
+	g_autoptr(GBytes) filename_blob = NULL;
+	g_autoptr(GBytes) release_flags_blob = NULL;
+	FwupdReleaseFlags release_flags = FWUPD_RELEASE_FLAG_NONE;
+
+	/* we set this with XbBuilderSource before the silo was created */
+	metadata_trust = xb_node_query_first(release, "../../info/metadata_trust", NULL);
+	if (metadata_trust != NULL)
+		release_flags |= FWUPD_RELEASE_FLAG_TRUSTED_METADATA;
 
 	/* get the main firmware file */
+	csum_tmp = fu_cabinet_get_release_checksum(release, &csum_filename);
 	basename = g_path_get_basename(csum_filename);
 	img_blob = fu_firmware_get_image_by_id(FU_FIRMWARE(self), basename, &error_local2);
 	if (img_blob == NULL) {
@@ -154,7 +165,8 @@ fu_cabinet_parse_release(FuCabinet *self, XbNode *release, GError **error)
 	filename_blob = g_bytes_new(basename, strlen(basename) + 1);
 	xb_node_set_data(release, "fwupd::FirmwareBasename", filename_blob);
 
-	/* set as metadata if unset, but error if specified and incorrect */
+	/* set as metadata if unset, but error if specified and incorrect -- the size is known
+	 * from the CFFILE header so this does not decompress the payload */
 	stream = fu_firmware_get_stream(img_blob, error);
 	if (stream == NULL)
 		return FALSE;
@@ -181,7 +193,72 @@ fu_cabinet_parse_release(FuCabinet *self, XbNode *release, GError **error)
 		xb_node_set_data(release, "fwupd::ReleaseSize", blob_sz);
 	}
 
-	/* set if unspecified, but error out if specified and incorrect */
+	/* the payload is only trusted after fu_cabinet_verify_release() */
+	release_flags_blob = g_bytes_new(&release_flags, sizeof(release_flags));
+	xb_node_set_data(release, "fwupd::ReleaseFlags", release_flags_blob);
+
+	/* success */
+	return TRUE;
+}
+
+/**
+ * fu_cabinet_verify_release:
+ * @self: a #FuCabinet
+ * @release: a #XbNode
+ * @error: (nullable): optional return location for an error
+ *
+ * Verifies the payload checksum and signature of a release, and adds
+ * %FWUPD_RELEASE_FLAG_TRUSTED_PAYLOAD to the release flags on the node if the signature is valid.
+ * This reads and decompresses the payload, and so is only done for releases that are actually
+ * going to be used. Releases that have already been verified are not checked again.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 2.0.0
+ **/
+gboolean
+fu_cabinet_verify_release(FuCabinet *self, XbNode *release, GError **error)
+{
+	const gchar *basename;
+	GBytes *filename_blob;
+	GBytes *release_flags_old;
+	g_autoptr(FuFirmware) img_blob = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+	g_autoptr(XbNode) csum_tmp = NULL;
+	g_autoptr(JcatItem) item = NULL;
+	g_autoptr(GBytes) release_flags_blob = NULL;
+	FwupdReleaseFlags release_flags = FWUPD_RELEASE_FLAG_NONE;
+
+	g_return_val_if_fail(FU_IS_CABINET(self), FALSE);
+	g_return_val_if_fail(XB_IS_NODE(release), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* already done */
+	if (xb_node_get_data(release, "fwupd::PayloadVerified") != NULL)
+		return TRUE;
+
+	/* set in fu_cabinet_parse_release() */
+	filename_blob = xb_node_get_data(release, "fwupd::FirmwareBasename");
+	release_flags_old = xb_node_get_data(release, "fwupd::ReleaseFlags");
+	if (filename_blob == NULL || release_flags_old == NULL ||
+	    g_bytes_get_size(release_flags_old) != sizeof(release_flags)) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "release has not been parsed");
+		return FALSE;
+	}
+	memcpy(&release_flags, g_bytes_get_data(release_flags_old, NULL), sizeof(release_flags));
+	basename = (const gchar *)g_bytes_get_data(filename_blob, NULL);
+	img_blob = fu_firmware_get_image_by_id(FU_FIRMWARE(self), basename, error);
+	if (img_blob == NULL)
+		return FALSE;
+	stream = fu_firmware_get_stream(img_blob, error);
+	if (stream == NULL)
+		return FALSE;
+
+	/* error out if specified and incorrect */
+	csum_tmp = fu_cabinet_get_release_checksum(release, NULL);
 	if (csum_tmp != NULL && xb_node_get_text(csum_tmp) != NULL) {
 		const gchar *checksum_old = xb_node_get_text(csum_tmp);
 		GChecksumType checksum_type = fwupd_checksum_guess_kind(checksum_old);
@@ -305,6 +382,7 @@ fu_cabinet_parse_release(FuCabinet *self, XbNode *release, GError **error)
 	/* this means we can get the data from fu_keyring_get_release_flags */
 	release_flags_blob = g_bytes_new(&release_flags, sizeof(release_flags));
 	xb_node_set_data(release, "fwupd::ReleaseFlags", release_flags_blob);
+	xb_node_set_data(release, "fwupd::PayloadVerified", release_flags_blob);
 
 	/* success */
 	return TRUE;
@@ -975,6 +1053,7 @@ static void
 fu_cabinet_init(FuCabinet *self)
 {
 	fu_cab_firmware_set_only_basename(FU_CAB_FIRMWARE(self), TRUE);
+	fu_cab_firmware_set_lazy_decompress(FU_CAB_FIRMWARE(self), TRUE);
 	fu_firmware_set_size_max(FU_FIRMWARE(self), 1024 * 1024 * 100);
 	self->builder = xb_builder_new();
 	self->jcat_file = jcat_file_new();
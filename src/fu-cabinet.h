@@ -45,3 +45,6 @@ GPtrArray *
 fu_cabinet_get_components(FuCabinet *self, GError **error) G_GNUC_NON_NULL(1);
 XbNode *
 fu_cabinet_get_component(FuCabinet *self, const gchar *id, GError **error) G_GNUC_NON_NULL(1);
+gboolean
+fu_cabinet_verify_release(FuCabinet *self, XbNode *release, GError **error)
+    G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1, 2);
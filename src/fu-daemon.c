@@ -1347,6 +1347,22 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		g_dbus_method_invocation_return_value(invocation, val);
 		return;
 	}
+	if (g_strcmp0(method_name, "GetAllUpgrades") == 0) {
+		g_autoptr(GPtrArray) devices = NULL;
+		g_debug("Called %s()", method_name);
+		devices = fu_engine_get_upgrades_all(self->engine, request, &error);
+		if (devices == NULL) {
+			fu_daemon_method_invocation_return_gerror(invocation, error);
+			return;
+		}
+		val = fu_daemon_device_array_to_variant(self, request, devices, &error);
+		if (val == NULL) {
+			fu_daemon_method_invocation_return_gerror(invocation, error);
+			return;
+		}
+		g_dbus_method_invocation_return_value(invocation, val);
+		return;
+	}
 	if (g_strcmp0(method_name, "GetRemotes") == 0) {
 		g_autoptr(GPtrArray) remotes = NULL;
 		g_debug("Called %s()", method_name);
@@ -1460,8 +1476,10 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 
 		g_debug("Called %s()", method_name);
 
-		/* save data from engine */
-		data = fu_engine_emulation_save(self->engine, &error);
+		/* save data from engine, using the format older clients can also load */
+		data = fu_engine_emulation_save(self->engine,
+						FU_ENGINE_EMULATION_FORMAT_JSON,
+						&error);
 		if (data == NULL) {
 			g_dbus_method_invocation_return_error(invocation,
 							      FWUPD_ERROR,
@@ -228,6 +228,12 @@ fu_engine_config_get_idle_timeout(FuEngineConfig *self)
 	return fu_config_get_value_u64(FU_CONFIG(self), "fwupd", "IdleTimeout");
 }
 
+guint
+fu_engine_config_get_firmware_cache_max_age(FuEngineConfig *self)
+{
+	return fu_config_get_value_u64(FU_CONFIG(self), "fwupd", "FirmwareCacheMaxAge");
+}
+
 GPtrArray *
 fu_engine_config_get_disabled_devices(FuEngineConfig *self)
 {
@@ -406,6 +412,7 @@ fu_engine_config_init(FuEngineConfig *self)
 	fu_engine_set_config_default(self, "DisabledPlugins", "");
 	fu_engine_set_config_default(self, "EnumerateAllDevices", "false");
 	fu_engine_set_config_default(self, "EspLocation", NULL);
+	fu_engine_set_config_default(self, "FirmwareCacheMaxAge", "60"); /* s */
 	fu_engine_set_config_default(self, "HostBkc", NULL);
 	fu_engine_set_config_default(self, "IdleTimeout", "300");		  /* s */
 	fu_engine_set_config_default(self, "IdleInhibitStartupThreshold", "500"); /* ms */
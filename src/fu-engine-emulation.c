@@ -0,0 +1,713 @@
+/*
+ * Copyright 2024 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#define G_LOG_DOMAIN "FuEngine"
+
+#include "config.h"
+
+#include <string.h>
+
+#include "fu-engine-emulation.h"
+#include "fu-mem-private.h"
+
+/*
+ * The binary format is a header, a table of deduplicated strings, a table of deduplicated
+ * binary blobs and an index of install phases. Each phase is a tree of tagged nodes that
+ * reference the tables by index, so JSON keys and the USB payloads that are repeated in
+ * every phase are only stored once, and the payloads do not need to be base64 encoded.
+ */
+
+#define FU_ENGINE_EMULATION_BLOB_SIZE_MIN 16
+#define FU_ENGINE_EMULATION_DEPTH_MAX	  32
+
+typedef struct {
+	GPtrArray *strings;	 /* (element-type utf8) */
+	GHashTable *strings_idx; /* (element-type utf8 guint) */
+	GPtrArray *blobs;	 /* (element-type GBytes) */
+	GHashTable *blobs_idx;	 /* (element-type GBytes guint) */
+} FuEngineEmulationWriter;
+
+typedef struct {
+	GPtrArray *strings; /* (element-type utf8) */
+	GPtrArray *blobs;   /* (element-type utf8), base64 encoded */
+} FuEngineEmulationReader;
+
+static void
+fu_engine_emulation_writer_free(FuEngineEmulationWriter *writer)
+{
+	g_ptr_array_unref(writer->strings);
+	g_hash_table_unref(writer->strings_idx);
+	g_ptr_array_unref(writer->blobs);
+	g_hash_table_unref(writer->blobs_idx);
+	g_free(writer);
+}
+
+static void
+fu_engine_emulation_reader_free(FuEngineEmulationReader *reader)
+{
+	g_ptr_array_unref(reader->strings);
+	g_ptr_array_unref(reader->blobs);
+	g_free(reader);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuEngineEmulationWriter, fu_engine_emulation_writer_free)
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuEngineEmulationReader, fu_engine_emulation_reader_free)
+
+/**
+ * fu_engine_emulation_phases_new:
+ *
+ * Creates a hash table suitable for holding the emulation data for each install phase.
+ *
+ * Returns: (transfer full) (element-type FuEngineInstallPhase JsonNode): a hash table
+ **/
+GHashTable *
+fu_engine_emulation_phases_new(void)
+{
+	return g_hash_table_new_full(g_direct_hash,
+				     g_direct_equal,
+				     NULL,
+				     (GDestroyNotify)json_node_unref);
+}
+
+static guint32
+fu_engine_emulation_writer_add_string(FuEngineEmulationWriter *writer, const gchar *str)
+{
+	gpointer idx = NULL;
+	gchar *str_new;
+
+	if (g_hash_table_lookup_extended(writer->strings_idx, str, NULL, &idx))
+		return GPOINTER_TO_UINT(idx);
+	str_new = g_strdup(str);
+	g_ptr_array_add(writer->strings, str_new);
+	g_hash_table_insert(writer->strings_idx,
+			    str_new,
+			    GUINT_TO_POINTER(writer->strings->len - 1));
+	return writer->strings->len - 1;
+}
+
+static guint32
+fu_engine_emulation_writer_add_blob(FuEngineEmulationWriter *writer, GBytes *blob)
+{
+	gpointer idx = NULL;
+
+	if (g_hash_table_lookup_extended(writer->blobs_idx, blob, NULL, &idx))
+		return GPOINTER_TO_UINT(idx);
+	g_ptr_array_add(writer->blobs, g_bytes_ref(blob));
+	g_hash_table_insert(writer->blobs_idx, blob, GUINT_TO_POINTER(writer->blobs->len - 1));
+	return writer->blobs->len - 1;
+}
+
+/* only use the blob table when the string can be converted back to exactly the same value */
+static GBytes *
+fu_engine_emulation_base64_decode(const gchar *str)
+{
+	gsize bufsz = 0;
+	gsize strsz = strlen(str);
+	g_autofree guchar *buf = NULL;
+	g_autofree gchar *str_new = NULL;
+
+	if (strsz < FU_ENGINE_EMULATION_BLOB_SIZE_MIN || strsz % 4 != 0)
+		return NULL;
+	for (gsize i = 0; i < strsz; i++) {
+		if (!g_ascii_isalnum(str[i]) && str[i] != '+' && str[i] != '/' && str[i] != '=')
+			return NULL;
+	}
+	buf = g_base64_decode(str, &bufsz);
+	str_new = g_base64_encode(buf, bufsz);
+	if (g_strcmp0(str, str_new) != 0)
+		return NULL;
+	return g_bytes_new_take(g_steal_pointer(&buf), bufsz);
+}
+
+static gboolean
+fu_engine_emulation_write_value(FuEngineEmulationWriter *writer,
+				JsonNode *json_node,
+				GByteArray *buf,
+				GError **error)
+{
+	GType gtype = json_node_get_value_type(json_node);
+
+	if (gtype == G_TYPE_BOOLEAN) {
+		fu_byte_array_append_uint8(buf,
+					   json_node_get_boolean(json_node)
+					       ? FU_ENGINE_EMULATION_NODE_TRUE
+					       : FU_ENGINE_EMULATION_NODE_FALSE);
+		return TRUE;
+	}
+	if (gtype == G_TYPE_INT64) {
+		fu_byte_array_append_uint8(buf, FU_ENGINE_EMULATION_NODE_INT);
+		fu_byte_array_append_uint64(buf,
+					    (guint64)json_node_get_int(json_node),
+					    G_LITTLE_ENDIAN);
+		return TRUE;
+	}
+	if (gtype == G_TYPE_DOUBLE) {
+		gdouble val = json_node_get_double(json_node);
+		guint64 tmp = 0;
+		memcpy(&tmp, &val, sizeof(tmp));
+		fu_byte_array_append_uint8(buf, FU_ENGINE_EMULATION_NODE_DOUBLE);
+		fu_byte_array_append_uint64(buf, tmp, G_LITTLE_ENDIAN);
+		return TRUE;
+	}
+	if (gtype == G_TYPE_STRING) {
+		const gchar *str = json_node_get_string(json_node);
+		guint32 idx;
+		g_autoptr(GBytes) blob = fu_engine_emulation_base64_decode(str);
+		if (blob != NULL) {
+			idx = fu_engine_emulation_writer_add_blob(writer, blob);
+			fu_byte_array_append_uint8(buf, FU_ENGINE_EMULATION_NODE_BLOB);
+		} else {
+			idx = fu_engine_emulation_writer_add_string(writer, str);
+			fu_byte_array_append_uint8(buf, FU_ENGINE_EMULATION_NODE_STRING);
+		}
+		fu_byte_array_append_uint32(buf, idx, G_LITTLE_ENDIAN);
+		return TRUE;
+	}
+	g_set_error(error,
+		    FWUPD_ERROR,
+		    FWUPD_ERROR_NOT_SUPPORTED,
+		    "JSON value type %s not supported",
+		    g_type_name(gtype));
+	return FALSE;
+}
+
+static gboolean
+fu_engine_emulation_write_node(FuEngineEmulationWriter *writer,
+			       JsonNode *json_node,
+			       GByteArray *buf,
+			       GError **error)
+{
+	JsonNodeType node_type = json_node_get_node_type(json_node);
+
+	if (node_type == JSON_NODE_NULL) {
+		fu_byte_array_append_uint8(buf, FU_ENGINE_EMULATION_NODE_NULL);
+		return TRUE;
+	}
+	if (node_type == JSON_NODE_VALUE)
+		return fu_engine_emulation_write_value(writer, json_node, buf, error);
+	if (node_type == JSON_NODE_ARRAY) {
+		JsonArray *json_array = json_node_get_array(json_node);
+		guint json_array_len = json_array_get_length(json_array);
+		fu_byte_array_append_uint8(buf, FU_ENGINE_EMULATION_NODE_ARRAY);
+		fu_byte_array_append_uint32(buf, json_array_len, G_LITTLE_ENDIAN);
+		for (guint i = 0; i < json_array_len; i++) {
+			if (!fu_engine_emulation_write_node(writer,
+							    json_array_get_element(json_array, i),
+							    buf,
+							    error))
+				return FALSE;
+		}
+		return TRUE;
+	}
+	if (node_type == JSON_NODE_OBJECT) {
+		JsonObject *json_object = json_node_get_object(json_node);
+		JsonObjectIter iter;
+		JsonNode *json_member = NULL;
+		const gchar *member_name = NULL;
+
+		fu_byte_array_append_uint8(buf, FU_ENGINE_EMULATION_NODE_OBJECT);
+		fu_byte_array_append_uint32(buf,
+					    json_object_get_size(json_object),
+					    G_LITTLE_ENDIAN);
+		json_object_iter_init_ordered(&iter, json_object);
+		while (json_object_iter_next_ordered(&iter, &member_name, &json_member)) {
+			guint32 idx = fu_engine_emulation_writer_add_string(writer, member_name);
+			fu_byte_array_append_uint32(buf, idx, G_LITTLE_ENDIAN);
+			if (!fu_engine_emulation_write_node(writer, json_member, buf, error))
+				return FALSE;
+		}
+		return TRUE;
+	}
+	g_set_error(error,
+		    FWUPD_ERROR,
+		    FWUPD_ERROR_NOT_SUPPORTED,
+		    "JSON node type %u not supported",
+		    node_type);
+	return FALSE;
+}
+
+static GBytes *
+fu_engine_emulation_phases_write_binary(GHashTable *phases, GError **error)
+{
+	gsize offset;
+	g_autoptr(FuEngineEmulationWriter) writer = g_new0(FuEngineEmulationWriter, 1);
+	g_autoptr(FuStructEngineEmulationHdr) st_hdr = fu_struct_engine_emulation_hdr_new();
+	g_autoptr(GByteArray) buf_data = g_byte_array_new();
+	g_autoptr(GByteArray) buf_idx = g_byte_array_new();
+
+	writer->strings = g_ptr_array_new_with_free_func(g_free);
+	writer->strings_idx = g_hash_table_new(g_str_hash, g_str_equal);
+	writer->blobs = g_ptr_array_new_with_free_func((GDestroyNotify)g_bytes_unref);
+	writer->blobs_idx = g_hash_table_new(g_bytes_hash, g_bytes_equal);
+
+	/* encode each phase, building the string and blob tables as we go */
+	for (guint phase = FU_ENGINE_INSTALL_PHASE_SETUP; phase < FU_ENGINE_INSTALL_PHASE_LAST;
+	     phase++) {
+		JsonNode *json_node = g_hash_table_lookup(phases, GINT_TO_POINTER(phase));
+		g_autoptr(FuStructEngineEmulationPhase) st_phase = NULL;
+		gsize offset_data = buf_data->len;
+
+		if (json_node == NULL)
+			continue;
+		if (!fu_engine_emulation_write_node(writer, json_node, buf_data, error))
+			return NULL;
+		st_phase = fu_struct_engine_emulation_phase_new();
+		fu_struct_engine_emulation_phase_set_phase(st_phase, phase);
+		fu_struct_engine_emulation_phase_set_offset(st_phase, offset_data);
+		fu_struct_engine_emulation_phase_set_size(st_phase, buf_data->len - offset_data);
+		g_byte_array_append(buf_idx, st_phase->data, st_phase->len);
+	}
+	fu_struct_engine_emulation_hdr_set_nr_strings(st_hdr, writer->strings->len);
+	fu_struct_engine_emulation_hdr_set_nr_blobs(st_hdr, writer->blobs->len);
+	fu_struct_engine_emulation_hdr_set_nr_phases(st_hdr,
+						     buf_idx->len /
+							 FU_STRUCT_ENGINE_EMULATION_PHASE_SIZE);
+
+	/* string table */
+	for (guint i = 0; i < writer->strings->len; i++) {
+		const gchar *str = g_ptr_array_index(writer->strings, i);
+		gsize strsz = strlen(str);
+		fu_byte_array_append_uint32(st_hdr, strsz, G_LITTLE_ENDIAN);
+		g_byte_array_append(st_hdr, (const guint8 *)str, strsz);
+	}
+
+	/* blob table */
+	for (guint i = 0; i < writer->blobs->len; i++) {
+		GBytes *blob = g_ptr_array_index(writer->blobs, i);
+		fu_byte_array_append_uint32(st_hdr, g_bytes_get_size(blob), G_LITTLE_ENDIAN);
+		fu_byte_array_append_bytes(st_hdr, blob);
+	}
+
+	/* phase index, with the offsets fixed up to be from the start of the file */
+	offset = st_hdr->len + buf_idx->len;
+	for (gsize i = 0; i < buf_idx->len; i += FU_STRUCT_ENGINE_EMULATION_PHASE_SIZE) {
+		guint8 *buf = buf_idx->data + i + FU_STRUCT_ENGINE_EMULATION_PHASE_OFFSET_OFFSET;
+		guint32 offset_data = fu_memread_uint32(buf, G_LITTLE_ENDIAN);
+		fu_memwrite_uint32(buf, offset + offset_data, G_LITTLE_ENDIAN);
+	}
+	g_byte_array_append(st_hdr, buf_idx->data, buf_idx->len);
+	g_byte_array_append(st_hdr, buf_data->data, buf_data->len);
+
+	/* success */
+	return g_bytes_new(st_hdr->data, st_hdr->len);
+}
+
+static GBytes *
+fu_engine_emulation_phases_write_json(GHashTable *phases, GError **error)
+{
+	g_autoptr(FuArchive) archive = fu_archive_new(NULL, FU_ARCHIVE_FLAG_NONE, NULL);
+	g_autoptr(GByteArray) buf = NULL;
+
+	for (guint phase = FU_ENGINE_INSTALL_PHASE_SETUP; phase < FU_ENGINE_INSTALL_PHASE_LAST;
+	     phase++) {
+		JsonNode *json_node = g_hash_table_lookup(phases, GINT_TO_POINTER(phase));
+		gsize jsonsz = 0;
+		gchar *json;
+		g_autofree gchar *fn = NULL;
+		g_autoptr(GBytes) blob = NULL;
+		g_autoptr(JsonGenerator) json_generator = NULL;
+
+		/* nothing set */
+		if (json_node == NULL)
+			continue;
+		json_generator = json_generator_new();
+		json_generator_set_pretty(json_generator, TRUE);
+		json_generator_set_root(json_generator, json_node);
+		json = json_generator_to_data(json_generator, &jsonsz);
+		blob = g_bytes_new_take(json, jsonsz);
+		fn = g_strdup_printf("%s.json", fu_engine_install_phase_to_string(phase));
+		fu_archive_add_entry(archive, fn, blob);
+	}
+
+	/* write  */
+	buf = fu_archive_write(archive, FU_ARCHIVE_FORMAT_ZIP, FU_ARCHIVE_COMPRESSION_GZIP, error);
+	if (buf == NULL)
+		return NULL;
+	return g_bytes_new(buf->data, buf->len);
+}
+
+/**
+ * fu_engine_emulation_phases_write:
+ * @phases: (element-type FuEngineInstallPhase JsonNode): emulation data for each phase
+ * @format: a #FuEngineEmulationFormat, e.g. %FU_ENGINE_EMULATION_FORMAT_BINARY
+ * @error: (nullable): optional return location for an error
+ *
+ * Exports the emulation data for each install phase, either as a compact binary file or as a
+ * ZIP archive of JSON files.
+ *
+ * Returns: (transfer full): data, or %NULL on error
+ **/
+GBytes *
+fu_engine_emulation_phases_write(GHashTable *phases, FuEngineEmulationFormat format, GError **error)
+{
+	g_return_val_if_fail(phases != NULL, NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	if (format == FU_ENGINE_EMULATION_FORMAT_BINARY)
+		return fu_engine_emulation_phases_write_binary(phases, error);
+	if (format == FU_ENGINE_EMULATION_FORMAT_JSON)
+		return fu_engine_emulation_phases_write_json(phases, error);
+	g_set_error(error,
+		    FWUPD_ERROR,
+		    FWUPD_ERROR_NOT_SUPPORTED,
+		    "emulation format %s not supported",
+		    fu_engine_emulation_format_to_string(format));
+	return NULL;
+}
+
+static JsonNode *
+fu_engine_emulation_parse_node(FuEngineEmulationReader *reader,
+			       const guint8 *buf,
+			       gsize bufsz,
+			       gsize *offset,
+			       guint depth,
+			       GError **error)
+{
+	guint8 node_kind = 0;
+	guint32 value = 0;
+	guint64 value64 = 0;
+	g_autoptr(JsonNode) json_node = NULL;
+
+	/* sanity check */
+	if (depth > FU_ENGINE_EMULATION_DEPTH_MAX) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "nodes nested too deeply, maximum is %u",
+			    (guint)FU_ENGINE_EMULATION_DEPTH_MAX);
+		return NULL;
+	}
+	if (!fu_memread_uint8_safe(buf, bufsz, *offset, &node_kind, error))
+		return NULL;
+	*offset += sizeof(node_kind);
+
+	switch (node_kind) {
+	case FU_ENGINE_EMULATION_NODE_NULL:
+		return json_node_new(JSON_NODE_NULL);
+	case FU_ENGINE_EMULATION_NODE_FALSE:
+	case FU_ENGINE_EMULATION_NODE_TRUE:
+		json_node = json_node_new(JSON_NODE_VALUE);
+		json_node_set_boolean(json_node, node_kind == FU_ENGINE_EMULATION_NODE_TRUE);
+		break;
+	case FU_ENGINE_EMULATION_NODE_INT:
+	case FU_ENGINE_EMULATION_NODE_DOUBLE:
+		if (!fu_memread_uint64_safe(buf, bufsz, *offset, &value64, G_LITTLE_ENDIAN, error))
+			return NULL;
+		*offset += sizeof(value64);
+		json_node = json_node_new(JSON_NODE_VALUE);
+		if (node_kind == FU_ENGINE_EMULATION_NODE_INT) {
+			json_node_set_int(json_node, (gint64)value64);
+		} else {
+			gdouble val = 0;
+			memcpy(&val, &value64, sizeof(val));
+			json_node_set_double(json_node, val);
+		}
+		break;
+	case FU_ENGINE_EMULATION_NODE_STRING:
+	case FU_ENGINE_EMULATION_NODE_BLOB: {
+		GPtrArray *table = node_kind == FU_ENGINE_EMULATION_NODE_STRING ? reader->strings
+										 : reader->blobs;
+		if (!fu_memread_uint32_safe(buf, bufsz, *offset, &value, G_LITTLE_ENDIAN, error))
+			return NULL;
+		*offset += sizeof(value);
+		if (value >= table->len) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "invalid table index %u",
+				    (guint)value);
+			return NULL;
+		}
+		json_node = json_node_new(JSON_NODE_VALUE);
+		json_node_set_string(json_node, g_ptr_array_index(table, value));
+		break;
+	}
+	case FU_ENGINE_EMULATION_NODE_ARRAY: {
+		g_autoptr(JsonArray) json_array = NULL;
+
+		if (!fu_memread_uint32_safe(buf, bufsz, *offset, &value, G_LITTLE_ENDIAN, error))
+			return NULL;
+		*offset += sizeof(value);
+
+		/* each element is at least one byte */
+		if (value > bufsz - *offset) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "too many array elements: %u",
+				    (guint)value);
+			return NULL;
+		}
+		json_array = json_array_sized_new(value);
+		for (guint i = 0; i < value; i++) {
+			JsonNode *json_element = fu_engine_emulation_parse_node(reader,
+										buf,
+										bufsz,
+										offset,
+										depth + 1,
+										error);
+			if (json_element == NULL)
+				return NULL;
+			json_array_add_element(json_array, json_element);
+		}
+		json_node = json_node_new(JSON_NODE_ARRAY);
+		json_node_set_array(json_node, json_array);
+		break;
+	}
+	case FU_ENGINE_EMULATION_NODE_OBJECT: {
+		g_autoptr(JsonObject) json_object = json_object_new();
+
+		if (!fu_memread_uint32_safe(buf, bufsz, *offset, &value, G_LITTLE_ENDIAN, error))
+			return NULL;
+		*offset += sizeof(value);
+
+		/* each member is at least five bytes */
+		if (value > (bufsz - *offset) / 5) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "too many object members: %u",
+				    (guint)value);
+			return NULL;
+		}
+		for (guint i = 0; i < value; i++) {
+			guint32 idx = 0;
+			JsonNode *json_member;
+
+			if (!fu_memread_uint32_safe(buf,
+						    bufsz,
+						    *offset,
+						    &idx,
+						    G_LITTLE_ENDIAN,
+						    error))
+				return NULL;
+			*offset += sizeof(idx);
+			if (idx >= reader->strings->len) {
+				g_set_error(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_INVALID_DATA,
+					    "invalid string index %u",
+					    (guint)idx);
+				return NULL;
+			}
+			json_member = fu_engine_emulation_parse_node(reader,
+								     buf,
+								     bufsz,
+								     offset,
+								     depth + 1,
+								     error);
+			if (json_member == NULL)
+				return NULL;
+			json_object_set_member(json_object,
+					       g_ptr_array_index(reader->strings, idx),
+					       json_member);
+		}
+		json_node = json_node_new(JSON_NODE_OBJECT);
+		json_node_set_object(json_node, json_object);
+		break;
+	}
+	default:
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "invalid node kind 0x%x",
+			    node_kind);
+		return NULL;
+	}
+
+	/* success */
+	return g_steal_pointer(&json_node);
+}
+
+static GPtrArray *
+fu_engine_emulation_parse_table(const guint8 *buf,
+				gsize bufsz,
+				gsize *offset,
+				guint32 nr_entries,
+				gboolean base64,
+				GError **error)
+{
+	g_autoptr(GPtrArray) table = g_ptr_array_new_with_free_func(g_free);
+
+	/* each entry is at least four bytes */
+	if (nr_entries > (bufsz - *offset) / 4) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "too many table entries: %u",
+			    (guint)nr_entries);
+		return NULL;
+	}
+	for (guint i = 0; i < nr_entries; i++) {
+		guint32 entrysz = 0;
+
+		if (!fu_memread_uint32_safe(buf, bufsz, *offset, &entrysz, G_LITTLE_ENDIAN, error))
+			return NULL;
+		*offset += sizeof(entrysz);
+		if (!fu_memchk_read(bufsz, *offset, entrysz, error))
+			return NULL;
+		if (base64) {
+			g_ptr_array_add(table, g_base64_encode(buf + *offset, entrysz));
+		} else {
+			if (!g_utf8_validate((const gchar *)buf + *offset, entrysz, NULL)) {
+				g_set_error_literal(error,
+						    FWUPD_ERROR,
+						    FWUPD_ERROR_INVALID_DATA,
+						    "invalid UTF-8 string");
+				return NULL;
+			}
+			g_ptr_array_add(table, g_strndup((const gchar *)buf + *offset, entrysz));
+		}
+		*offset += entrysz;
+	}
+	return g_steal_pointer(&table);
+}
+
+static GHashTable *
+fu_engine_emulation_phases_parse_binary(GBytes *blob, GError **error)
+{
+	gsize bufsz = 0;
+	const guint8 *buf = g_bytes_get_data(blob, &bufsz);
+	gsize offset = FU_STRUCT_ENGINE_EMULATION_HDR_SIZE;
+	guint32 nr_phases;
+	g_autoptr(FuEngineEmulationReader) reader = g_new0(FuEngineEmulationReader, 1);
+	g_autoptr(FuStructEngineEmulationHdr) st_hdr = NULL;
+	g_autoptr(GHashTable) phases = fu_engine_emulation_phases_new();
+
+	st_hdr = fu_struct_engine_emulation_hdr_parse_bytes(blob, 0x0, error);
+	if (st_hdr == NULL)
+		return NULL;
+	reader->strings =
+	    fu_engine_emulation_parse_table(buf,
+					    bufsz,
+					    &offset,
+					    fu_struct_engine_emulation_hdr_get_nr_strings(st_hdr),
+					    FALSE,
+					    error);
+	if (reader->strings == NULL)
+		return NULL;
+	reader->blobs =
+	    fu_engine_emulation_parse_table(buf,
+					    bufsz,
+					    &offset,
+					    fu_struct_engine_emulation_hdr_get_nr_blobs(st_hdr),
+					    TRUE,
+					    error);
+	if (reader->blobs == NULL)
+		return NULL;
+
+	/* decode each phase using the index */
+	nr_phases = fu_struct_engine_emulation_hdr_get_nr_phases(st_hdr);
+	if (nr_phases > FU_ENGINE_INSTALL_PHASE_LAST) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_DATA,
+			    "too many phases: %u",
+			    (guint)nr_phases);
+		return NULL;
+	}
+	for (guint i = 0; i < nr_phases; i++) {
+		guint32 phase;
+		gsize offset_data;
+		gsize offset_end;
+		JsonNode *json_node;
+		g_autoptr(FuStructEngineEmulationPhase) st_phase = NULL;
+
+		st_phase = fu_struct_engine_emulation_phase_parse_bytes(blob, offset, error);
+		if (st_phase == NULL)
+			return NULL;
+		offset += st_phase->len;
+		phase = fu_struct_engine_emulation_phase_get_phase(st_phase);
+		if (phase >= FU_ENGINE_INSTALL_PHASE_LAST) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "invalid phase %u",
+				    (guint)phase);
+			return NULL;
+		}
+		offset_data = fu_struct_engine_emulation_phase_get_offset(st_phase);
+		offset_end = offset_data + fu_struct_engine_emulation_phase_get_size(st_phase);
+		if (!fu_memchk_read(bufsz,
+				    offset_data,
+				    fu_struct_engine_emulation_phase_get_size(st_phase),
+				    error))
+			return NULL;
+		json_node =
+		    fu_engine_emulation_parse_node(reader, buf, offset_end, &offset_data, 0, error);
+		if (json_node == NULL) {
+			g_prefix_error(error,
+				       "failed to parse phase %s: ",
+				       fu_engine_install_phase_to_string(phase));
+			return NULL;
+		}
+		g_hash_table_insert(phases, GUINT_TO_POINTER(phase), json_node);
+	}
+
+	/* success */
+	return g_steal_pointer(&phases);
+}
+
+static GHashTable *
+fu_engine_emulation_phases_parse_json(GBytes *blob, GError **error)
+{
+	g_autoptr(FuArchive) archive = NULL;
+	g_autoptr(GHashTable) phases = fu_engine_emulation_phases_new();
+
+	archive = fu_archive_new(blob, FU_ARCHIVE_FLAG_NONE, error);
+	if (archive == NULL)
+		return NULL;
+	for (guint phase = FU_ENGINE_INSTALL_PHASE_SETUP; phase < FU_ENGINE_INSTALL_PHASE_LAST;
+	     phase++) {
+		g_autofree gchar *fn =
+		    g_strdup_printf("%s.json", fu_engine_install_phase_to_string(phase));
+		g_autoptr(GBytes) blob_json = NULL;
+		g_autoptr(JsonParser) parser = json_parser_new();
+
+		/* not found */
+		blob_json = fu_archive_lookup_by_fn(archive, fn, NULL);
+		if (blob_json == NULL)
+			continue;
+		if (!json_parser_load_from_data(parser,
+						g_bytes_get_data(blob_json, NULL),
+						g_bytes_get_size(blob_json),
+						error)) {
+			g_prefix_error(error, "failed to parse %s: ", fn);
+			return NULL;
+		}
+		if (json_parser_get_root(parser) == NULL)
+			continue;
+		g_hash_table_insert(phases,
+				    GUINT_TO_POINTER(phase),
+				    json_parser_steal_root(parser));
+	}
+
+	/* success */
+	return g_steal_pointer(&phases);
+}
+
+/**
+ * fu_engine_emulation_phases_parse:
+ * @blob: data, either in the compact binary format or a ZIP archive of JSON files
+ * @error: (nullable): optional return location for an error
+ *
+ * Imports the emulation data for each install phase.
+ *
+ * Returns: (transfer full) (element-type FuEngineInstallPhase JsonNode): a hash table, or %NULL
+ **/
+GHashTable *
+fu_engine_emulation_phases_parse(GBytes *blob, GError **error)
+{
+	g_return_val_if_fail(blob != NULL, NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	if (g_bytes_get_size(blob) >= FU_STRUCT_ENGINE_EMULATION_HDR_SIZE_MAGIC &&
+	    memcmp(g_bytes_get_data(blob, NULL),
+		   FU_STRUCT_ENGINE_EMULATION_HDR_DEFAULT_MAGIC,
+		   FU_STRUCT_ENGINE_EMULATION_HDR_SIZE_MAGIC) == 0)
+		return fu_engine_emulation_phases_parse_binary(blob, error);
+	return fu_engine_emulation_phases_parse_json(blob, error);
+}
@@ -0,0 +1,20 @@
+/*
+ * Copyright 2024 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#pragma once
+
+#include <fwupdplugin.h>
+
+#include "fu-engine-struct.h"
+
+GHashTable *
+fu_engine_emulation_phases_new(void);
+GHashTable *
+fu_engine_emulation_phases_parse(GBytes *blob, GError **error) G_GNUC_NON_NULL(1);
+GBytes *
+fu_engine_emulation_phases_write(GHashTable *phases,
+				 FuEngineEmulationFormat format,
+				 GError **error) G_GNUC_NON_NULL(1);
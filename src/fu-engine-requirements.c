@@ -673,6 +673,64 @@ fu_engine_requirements_check_client(FuEngine *self,
 	return TRUE;
 }
 
+/* these only depend on the host state, and so the result can be shared by all devices */
+static gboolean
+fu_engine_requirements_check_host(FuEngine *self,
+				  FuEngineRequest *request,
+				  XbNode *req,
+				  const gchar *fwupd_version,
+				  GError **error)
+{
+	const gchar *element = xb_node_get_element(req);
+	const gchar *values[] = {element,
+				 xb_node_get_attr(req, "compare"),
+				 xb_node_get_attr(req, "version"),
+				 xb_node_get_text(req),
+				 fwupd_version};
+	gboolean ret;
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GString) key = g_string_new(NULL);
+
+	/* the feature flags are only used for the client requirement */
+	for (guint i = 0; i < G_N_ELEMENTS(values); i++)
+		g_string_append_printf(key, "%s:", values[i] != NULL ? values[i] : "");
+	if (request != NULL) {
+		g_string_append_printf(key,
+				       "%" G_GUINT64_FORMAT,
+				       (guint64)fu_engine_request_get_feature_flags(request));
+	}
+	if (fu_engine_requirement_cache_lookup(self, key->str, &error_local)) {
+		if (error_local != NULL) {
+			g_propagate_error(error, g_steal_pointer(&error_local));
+			return FALSE;
+		}
+		return TRUE;
+	}
+
+	if (g_strcmp0(element, "id") == 0) {
+		ret = fu_engine_requirements_check_id(self, req, &error_local);
+	} else if (g_strcmp0(element, "hardware") == 0) {
+		ret = fu_engine_requirements_check_hardware(self, req, fwupd_version, &error_local);
+	} else if (g_strcmp0(element, "not_hardware") == 0) {
+		ret = fu_engine_requirements_check_not_hardware(self,
+								req,
+								fwupd_version,
+								&error_local);
+	} else {
+		ret = fu_engine_requirements_check_client(self,
+							  request,
+							  req,
+							  fwupd_version,
+							  &error_local);
+	}
+	fu_engine_requirement_cache_add(self, key->str, error_local);
+	if (!ret) {
+		g_propagate_error(error, g_steal_pointer(&error_local));
+		return FALSE;
+	}
+	return TRUE;
+}
+
 static gboolean
 fu_engine_requirements_check_hard(FuEngine *self,
 				  FuRelease *release,
@@ -687,7 +745,7 @@ fu_engine_requirements_check_hard(FuEngine *self,
 
 	/* ensure component requirement */
 	if (g_strcmp0(xb_node_get_element(req), "id") == 0)
-		return fu_engine_requirements_check_id(self, req, error);
+		return fu_engine_requirements_check_host(self, request, req, fwupd_version, error);
 
 	/* ensure firmware requirement */
 	if (g_strcmp0(xb_node_get_element(req), "firmware") == 0) {
@@ -705,22 +763,17 @@ fu_engine_requirements_check_hard(FuEngine *self,
 	if (g_strcmp0(xb_node_get_element(req), "hardware") == 0) {
 		if (!fu_context_has_flag(ctx, FU_CONTEXT_FLAG_LOADED_HWINFO))
 			return TRUE;
-		return fu_engine_requirements_check_hardware(self, req, fwupd_version, error);
+		return fu_engine_requirements_check_host(self, request, req, fwupd_version, error);
 	}
 	if (g_strcmp0(xb_node_get_element(req), "not_hardware") == 0) {
 		if (!fu_context_has_flag(ctx, FU_CONTEXT_FLAG_LOADED_HWINFO))
 			return TRUE;
-		return fu_engine_requirements_check_not_hardware(self, req, fwupd_version, error);
+		return fu_engine_requirements_check_host(self, request, req, fwupd_version, error);
 	}
 
 	/* ensure client requirement */
-	if (g_strcmp0(xb_node_get_element(req), "client") == 0) {
-		return fu_engine_requirements_check_client(self,
-							   request,
-							   req,
-							   fwupd_version,
-							   error);
-	}
+	if (g_strcmp0(xb_node_get_element(req), "client") == 0)
+		return fu_engine_requirements_check_host(self, request, req, fwupd_version, error);
 
 	/* not supported */
 	g_set_error(error,
@@ -47,6 +47,7 @@
 #include "fu-device-list.h"
 #include "fu-device-private.h"
 #include "fu-device-progress.h"
+#include "fu-engine-emulation.h"
 #include "fu-engine-helper.h"
 #include "fu-engine-request.h"
 #include "fu-engine-requirements.h"
@@ -127,9 +128,12 @@ struct _FuEngine {
 	FuContext *ctx;
 	GHashTable *approved_firmware;	      /* (nullable) */
 	GHashTable *blocked_firmware;	      /* (nullable) */
-	GHashTable *emulation_phases;	      /* (element-type int utf8) */
+	GHashTable *emulation_phases;	      /* (element-type int JsonNode) */
 	GHashTable *emulation_backend_ids;    /* (element-type str int) */
 	GHashTable *device_changed_allowlist; /* (element-type str int) */
+	GHashTable *requirement_cache;	      /* (element-type utf8 GError) */
+	GMutex requirement_cache_mutex;	      /* for @requirement_cache */
+	guint requirement_cache_generation;
 	gchar *host_machine_id;
 	JcatContext *jcat_context;
 	gboolean loaded;
@@ -251,6 +255,79 @@ fu_engine_get_context(FuEngine *self)
 	return self->ctx;
 }
 
+static void
+fu_engine_requirement_cache_error_free(GError *error)
+{
+	if (error != NULL)
+		g_error_free(error);
+}
+
+/* invalidate all the results if the host state has changed since they were added */
+static void
+fu_engine_requirement_cache_ensure_generation(FuEngine *self)
+{
+	guint generation = fu_context_get_generation(self->ctx);
+	if (self->requirement_cache_generation == generation)
+		return;
+	if (g_hash_table_size(self->requirement_cache) > 0)
+		g_debug("host state changed, invalidating requirement cache");
+	g_hash_table_remove_all(self->requirement_cache);
+	self->requirement_cache_generation = generation;
+}
+
+/**
+ * fu_engine_requirement_cache_lookup:
+ * @self: a #FuEngine
+ * @key: a key that uniquely identifies the requirement
+ * @error_cached: (out) (nullable): the error if the requirement failed
+ *
+ * Looks up a requirement result that only depends on the host state.
+ *
+ * Returns: %TRUE if the result was found in the cache
+ **/
+gboolean
+fu_engine_requirement_cache_lookup(FuEngine *self, const gchar *key, GError **error_cached)
+{
+	GError *error_tmp = NULL;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->requirement_cache_mutex);
+
+	g_return_val_if_fail(FU_IS_ENGINE(self), FALSE);
+	g_return_val_if_fail(key != NULL, FALSE);
+
+	fu_engine_requirement_cache_ensure_generation(self);
+	if (!g_hash_table_lookup_extended(self->requirement_cache,
+					  key,
+					  NULL,
+					  (gpointer *)&error_tmp))
+		return FALSE;
+	if (error_tmp != NULL && error_cached != NULL)
+		*error_cached = g_error_copy(error_tmp);
+	return TRUE;
+}
+
+/**
+ * fu_engine_requirement_cache_add:
+ * @self: a #FuEngine
+ * @key: a key that uniquely identifies the requirement
+ * @error: (nullable): the error if the requirement failed, or %NULL for success
+ *
+ * Saves a requirement result that only depends on the host state. The result is automatically
+ * invalidated when the host state changes.
+ **/
+void
+fu_engine_requirement_cache_add(FuEngine *self, const gchar *key, const GError *error)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->requirement_cache_mutex);
+
+	g_return_if_fail(FU_IS_ENGINE(self));
+	g_return_if_fail(key != NULL);
+
+	fu_engine_requirement_cache_ensure_generation(self);
+	g_hash_table_insert(self->requirement_cache,
+			    g_strdup(key),
+			    error != NULL ? g_error_copy(error) : NULL);
+}
+
 static void
 fu_engine_set_status(FuEngine *self, FwupdStatus status)
 {
@@ -771,6 +848,7 @@ fu_engine_modify_config(FuEngine *self,
 				       "DisabledPlugins",
 				       "EnumerateAllDevices",
 				       "EspLocation",
+				       "FirmwareCacheMaxAge",
 				       "HostBkc",
 				       "IdleTimeout",
 				       "IgnorePower",
@@ -2048,6 +2126,7 @@ fu_engine_install_releases(FuEngine *self,
 					       flags,
 					       error)) {
 			g_autoptr(GError) error_local = NULL;
+			fu_context_firmware_cache_clear(self->ctx);
 			if (!fu_engine_composite_cleanup(self, devices, &error_local)) {
 				g_warning("failed to cleanup failed composite action: %s",
 					  error_local->message);
@@ -2057,6 +2136,9 @@ fu_engine_install_releases(FuEngine *self,
 		fu_progress_step_done(progress);
 	}
 
+	/* the cached firmware refers to streams from this cabinet */
+	fu_context_firmware_cache_clear(self->ctx);
+
 	/* set all the device statuses back to unknown */
 	for (guint i = 0; i < releases->len; i++) {
 		FuRelease *release = g_ptr_array_index(releases, i);
@@ -2656,21 +2738,22 @@ fu_engine_get_plugin_by_name(FuEngine *self, const gchar *name, GError **error)
 }
 
 static gboolean
-fu_engine_emulation_load_json(FuEngine *self, const gchar *json, GError **error)
+fu_engine_emulation_load_node(FuEngine *self, JsonNode *json_node, GError **error)
 {
-	JsonNode *root;
-	g_autoptr(JsonParser) parser = json_parser_new();
-
-	/* parse */
-	if (!json_parser_load_from_data(parser, json, -1, error))
+	/* sanity check */
+	if (!JSON_NODE_HOLDS_OBJECT(json_node)) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_DATA,
+				    "emulation data is not a JSON object");
 		return FALSE;
-	root = json_parser_get_root(parser);
+	}
 
 	/* load into all backends */
 	for (guint i = 0; i < self->backends->len; i++) {
 		FuBackend *backend = g_ptr_array_index(self->backends, i);
 		if (!fu_backend_load(backend,
-				     json_node_get_object(root),
+				     json_node_get_object(json_node),
 				     FU_USB_DEVICE_EMULATION_TAG,
 				     FU_BACKEND_LOAD_FLAG_NONE,
 				     error))
@@ -2681,24 +2764,32 @@ fu_engine_emulation_load_json(FuEngine *self, const gchar *json, GError **error)
 	return TRUE;
 }
 
+static gboolean
+fu_engine_emulation_load_json(FuEngine *self, const gchar *json, GError **error)
+{
+	g_autoptr(JsonParser) parser = json_parser_new();
+
+	/* parse */
+	if (!json_parser_load_from_data(parser, json, -1, error))
+		return FALSE;
+	return fu_engine_emulation_load_node(self, json_parser_get_root(parser), error);
+}
+
 static gboolean
 fu_engine_emulation_load_phase(FuEngine *self, GError **error)
 {
-	const gchar *json =
+	JsonNode *json_node =
 	    g_hash_table_lookup(self->emulation_phases, GINT_TO_POINTER(self->install_phase));
-	if (json == NULL)
+	if (json_node == NULL)
 		return TRUE;
-	g_info("loading phase %s: %s",
-	       fu_engine_install_phase_to_string(self->install_phase),
-	       json);
-	return fu_engine_emulation_load_json(self, json, error);
+	g_info("loading phase %s", fu_engine_install_phase_to_string(self->install_phase));
+	return fu_engine_emulation_load_node(self, json_node, error);
 }
 
 gboolean
 fu_engine_emulation_load(FuEngine *self, GBytes *data, GError **error)
 {
-	gboolean got_json = FALSE;
-	g_autoptr(FuArchive) archive = NULL;
+	g_autoptr(GHashTable) phases = NULL;
 
 	g_return_val_if_fail(FU_IS_ENGINE(self), FALSE);
 	g_return_val_if_fail(data != NULL, FALSE);
@@ -2717,37 +2808,29 @@ fu_engine_emulation_load(FuEngine *self, GBytes *data, GError **error)
 	if (!fu_engine_emulation_load_json(self, "{\"UsbDevices\":[]}", error))
 		return FALSE;
 
-	/* load archive */
-	archive = fu_archive_new(data, FU_ARCHIVE_FLAG_NONE, error);
-	if (archive == NULL)
+	/* load either the binary format or an archive of JSON files */
+	phases = fu_engine_emulation_phases_parse(data, error);
+	if (phases == NULL)
 		return FALSE;
-
-	/* load JSON files from archive */
 	g_hash_table_remove_all(self->emulation_phases);
 	for (guint phase = FU_ENGINE_INSTALL_PHASE_SETUP; phase < FU_ENGINE_INSTALL_PHASE_LAST;
 	     phase++) {
-		g_autofree gchar *fn =
-		    g_strdup_printf("%s.json", fu_engine_install_phase_to_string(phase));
-		g_autofree gchar *json_safe = NULL;
-		g_autoptr(GBytes) blob = NULL;
+		JsonNode *json_node = g_hash_table_lookup(phases, GINT_TO_POINTER(phase));
 
 		/* not found */
-		blob = fu_archive_lookup_by_fn(archive, fn, NULL);
-		if (blob == NULL)
+		if (json_node == NULL)
 			continue;
-		json_safe = g_strndup(g_bytes_get_data(blob, NULL), g_bytes_get_size(blob));
-		got_json = TRUE;
 		g_info("got emulation for phase %s", fu_engine_install_phase_to_string(phase));
 		if (phase == FU_ENGINE_INSTALL_PHASE_SETUP) {
-			if (!fu_engine_emulation_load_json(self, json_safe, error))
+			if (!fu_engine_emulation_load_node(self, json_node, error))
 				return FALSE;
 		} else {
 			g_hash_table_insert(self->emulation_phases,
 					    GINT_TO_POINTER(phase),
-					    g_steal_pointer(&json_safe));
+					    json_node_ref(json_node));
 		}
 	}
-	if (!got_json) {
+	if (g_hash_table_size(phases) == 0) {
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_NOT_SUPPORTED,
@@ -2760,11 +2843,9 @@ fu_engine_emulation_load(FuEngine *self, GBytes *data, GError **error)
 }
 
 GBytes *
-fu_engine_emulation_save(FuEngine *self, GError **error)
+fu_engine_emulation_save(FuEngine *self, FuEngineEmulationFormat format, GError **error)
 {
-	gboolean got_json = FALSE;
-	g_autoptr(GByteArray) buf = NULL;
-	g_autoptr(FuArchive) archive = fu_archive_new(NULL, FU_ARCHIVE_FLAG_NONE, NULL);
+	g_autoptr(GBytes) blob = NULL;
 
 	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
 	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
@@ -2779,22 +2860,7 @@ fu_engine_emulation_save(FuEngine *self, GError **error)
 	}
 
 	/* sanity check */
-	for (guint phase = FU_ENGINE_INSTALL_PHASE_SETUP; phase < FU_ENGINE_INSTALL_PHASE_LAST;
-	     phase++) {
-		const gchar *json =
-		    g_hash_table_lookup(self->emulation_phases, GINT_TO_POINTER(phase));
-		g_autofree gchar *fn =
-		    g_strdup_printf("%s.json", fu_engine_install_phase_to_string(phase));
-		g_autoptr(GBytes) blob = NULL;
-
-		/* nothing set */
-		if (json == NULL)
-			continue;
-		got_json = TRUE;
-		blob = g_bytes_new_static(json, strlen(json));
-		fu_archive_add_entry(archive, fn, blob);
-	}
-	if (!got_json) {
+	if (g_hash_table_size(self->emulation_phases) == 0) {
 		g_set_error_literal(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_NOT_SUPPORTED,
@@ -2803,24 +2869,21 @@ fu_engine_emulation_save(FuEngine *self, GError **error)
 	}
 
 	/* write  */
-	buf = fu_archive_write(archive, FU_ARCHIVE_FORMAT_ZIP, FU_ARCHIVE_COMPRESSION_GZIP, error);
-	if (buf == NULL)
+	blob = fu_engine_emulation_phases_write(self->emulation_phases, format, error);
+	if (blob == NULL)
 		return NULL;
 
 	/* success */
 	g_hash_table_remove_all(self->emulation_phases);
-	return g_bytes_new(buf->data, buf->len);
+	return g_steal_pointer(&blob);
 }
 
 static gboolean
 fu_engine_backends_save_phase(FuEngine *self, GError **error)
 {
-	const gchar *data_old;
-	g_autofree gchar *data_new = NULL;
-	g_autofree gchar *data_new_safe = NULL;
+	JsonNode *json_old;
 	g_autoptr(JsonBuilder) json_builder = json_builder_new();
-	g_autoptr(JsonGenerator) json_generator = NULL;
-	g_autoptr(JsonNode) json_root = NULL;
+	g_autoptr(JsonNode) json_new = NULL;
 
 	/* all devices in all backends */
 	for (guint i = 0; i < self->backends->len; i++) {
@@ -2832,32 +2895,25 @@ fu_engine_backends_save_phase(FuEngine *self, GError **error)
 				     error))
 			return FALSE;
 	}
-	json_root = json_builder_get_root(json_builder);
-	json_generator = json_generator_new();
-	json_generator_set_pretty(json_generator, TRUE);
-	json_generator_set_root(json_generator, json_root);
-
-	data_old =
-	    g_hash_table_lookup(self->emulation_phases, GINT_TO_POINTER(self->install_phase));
-	data_new = json_generator_to_data(json_generator, NULL);
-	if (g_strcmp0(data_new, "") == 0) {
+	json_new = json_builder_get_root(json_builder);
+	if (json_new == NULL) {
 		g_info("no data for phase %s",
 		       fu_engine_install_phase_to_string(self->install_phase));
 		return TRUE;
 	}
-	if (g_strcmp0(data_old, data_new) == 0) {
+	json_old =
+	    g_hash_table_lookup(self->emulation_phases, GINT_TO_POINTER(self->install_phase));
+	if (json_old != NULL && json_node_equal(json_old, json_new)) {
 		g_info("JSON unchanged for phase %s",
 		       fu_engine_install_phase_to_string(self->install_phase));
 		return TRUE;
 	}
-	data_new_safe = g_strndup(data_new, 8000);
-	g_info("JSON %s for phase %s: %s...",
-	       data_old == NULL ? "added" : "changed",
-	       fu_engine_install_phase_to_string(self->install_phase),
-	       data_new_safe);
+	g_info("JSON %s for phase %s",
+	       json_old == NULL ? "added" : "changed",
+	       fu_engine_install_phase_to_string(self->install_phase));
 	g_hash_table_insert(self->emulation_phases,
 			    GINT_TO_POINTER(self->install_phase),
-			    g_steal_pointer(&data_new));
+			    g_steal_pointer(&json_new));
 
 	/* success */
 	return TRUE;
@@ -4151,6 +4207,10 @@ fu_engine_config_changed_cb(FuEngineConfig *config, FuEngine *self)
 
 	fu_idle_set_timeout(self->idle, fu_engine_config_get_idle_timeout(config));
 
+	/* reuse parsed firmware for identical payloads */
+	fu_context_set_firmware_cache_max_age(self->ctx,
+					      fu_engine_config_get_firmware_cache_max_age(config));
+
 	/* allow changing the hardcoded ESP location */
 	if (fu_engine_config_get_esp_location(config) != NULL)
 		fu_context_set_esp_location(self->ctx, fu_engine_config_get_esp_location(config));
@@ -5316,11 +5376,68 @@ fu_engine_get_branch_fallback(const gchar *nullable_branch)
 	return nullable_branch;
 }
 
-GPtrArray *
-fu_engine_get_releases_for_device(FuEngine *self,
-				  FuEngineRequest *request,
-				  FuDevice *device,
+/* returns a new reference to the components providing @guid, using @components_cache
+ * (nullable) so that devices sharing GUIDs only run the XPath query once */
+static GPtrArray *
+fu_engine_get_components_for_guid(FuEngine *self,
+				  const gchar *guid,
+				  GHashTable *components_cache,
 				  GError **error)
+{
+	GPtrArray *components;
+	g_autoptr(GError) error_local = NULL;
+	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
+
+	/* already looked up */
+	if (components_cache != NULL) {
+		components = g_hash_table_lookup(components_cache, guid);
+		if (components != NULL) {
+			if (components->len == 0) {
+				g_set_error(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_NOT_FOUND,
+					    "no components for %s",
+					    guid);
+				return NULL;
+			}
+			return g_ptr_array_ref(components);
+		}
+	}
+
+	xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
+	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
+	components = xb_silo_query_with_context(self->silo,
+						self->query_component_by_guid,
+						&context,
+						&error_local);
+	if (components_cache != NULL) {
+		g_hash_table_insert(components_cache,
+				    g_strdup(guid),
+				    components != NULL ? g_ptr_array_ref(components)
+						       : g_ptr_array_new());
+	}
+	if (components == NULL) {
+		g_propagate_error(error, g_steal_pointer(&error_local));
+		return NULL;
+	}
+	return components;
+}
+
+static GHashTable *
+fu_engine_components_cache_new(void)
+{
+	return g_hash_table_new_full(g_str_hash,
+				     g_str_equal,
+				     g_free,
+				     (GDestroyNotify)g_ptr_array_unref);
+}
+
+static GPtrArray *
+fu_engine_get_releases_for_device_full(FuEngine *self,
+				       FuEngineRequest *request,
+				       FuDevice *device,
+				       GHashTable *components_cache,
+				       GError **error)
 {
 	GPtrArray *device_guids;
 	g_autoptr(GPtrArray) branches = NULL;
@@ -5373,14 +5490,9 @@ fu_engine_get_releases_for_device(FuEngine *self,
 		const gchar *guid = g_ptr_array_index(device_guids, j);
 		g_autoptr(GError) error_local = NULL;
 		g_autoptr(GPtrArray) components = NULL;
-		g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
 
-		xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
-		xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
-		components = xb_silo_query_with_context(self->silo,
-							self->query_component_by_guid,
-							&context,
-							&error_local);
+		components =
+		    fu_engine_get_components_for_guid(self, guid, components_cache, &error_local);
 		if (components == NULL) {
 			g_debug("%s was not found: %s", guid, error_local->message);
 			continue;
@@ -5432,6 +5544,15 @@ fu_engine_get_releases_for_device(FuEngine *self,
 	return g_steal_pointer(&releases);
 }
 
+GPtrArray *
+fu_engine_get_releases_for_device(FuEngine *self,
+				  FuEngineRequest *request,
+				  FuDevice *device,
+				  GError **error)
+{
+	return fu_engine_get_releases_for_device_full(self, request, device, NULL, error);
+}
+
 /**
  * fu_engine_get_releases:
  * @self: a #FuEngine
@@ -5714,37 +5835,17 @@ fu_engine_self_sign(FuEngine *self, const gchar *value, JcatSignFlags flags, GEr
 	return jcat_blob_get_data_as_string(jcat_signature);
 }
 
-/**
- * fu_engine_get_upgrades:
- * @self: a #FuEngine
- * @request: a #FuEngineRequest
- * @device_id: a device ID
- * @error: (nullable): optional return location for an error
- *
- * Gets the upgrades available for a specific device.
- *
- * Returns: (transfer container) (element-type FwupdDevice): results
- **/
-GPtrArray *
-fu_engine_get_upgrades(FuEngine *self,
-		       FuEngineRequest *request,
-		       const gchar *device_id,
-		       GError **error)
+static GPtrArray *
+fu_engine_get_upgrades_for_device(FuEngine *self,
+				  FuEngineRequest *request,
+				  FuDevice *device,
+				  GHashTable *components_cache,
+				  GError **error)
 {
-	g_autoptr(FuDevice) device = NULL;
 	g_autoptr(GPtrArray) releases = NULL;
 	g_autoptr(GPtrArray) releases_tmp = NULL;
 	g_autoptr(GString) error_str = g_string_new(NULL);
 
-	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
-	g_return_val_if_fail(device_id != NULL, NULL);
-	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
-
-	/* find the device */
-	device = fu_device_list_get_by_id(self->device_list, device_id, error);
-	if (device == NULL)
-		return NULL;
-
 	/* there is no point checking each release */
 	if (!fu_device_has_flag(device, FWUPD_DEVICE_FLAG_UPDATABLE) &&
 	    !fu_device_has_flag(device, FWUPD_DEVICE_FLAG_UPDATABLE_HIDDEN)) {
@@ -5774,7 +5875,8 @@ fu_engine_get_upgrades(FuEngine *self,
 	}
 
 	/* get all the releases for the device */
-	releases_tmp = fu_engine_get_releases_for_device(self, request, device, error);
+	releases_tmp =
+	    fu_engine_get_releases_for_device_full(self, request, device, components_cache, error);
 	if (releases_tmp == NULL)
 		return NULL;
 	releases = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
@@ -5849,6 +5951,110 @@ fu_engine_get_upgrades(FuEngine *self,
 	return g_steal_pointer(&releases);
 }
 
+/**
+ * fu_engine_get_upgrades:
+ * @self: a #FuEngine
+ * @request: a #FuEngineRequest
+ * @device_id: a device ID
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets the upgrades available for a specific device.
+ *
+ * Returns: (transfer container) (element-type FwupdDevice): results
+ **/
+GPtrArray *
+fu_engine_get_upgrades(FuEngine *self,
+		       FuEngineRequest *request,
+		       const gchar *device_id,
+		       GError **error)
+{
+	g_autoptr(FuDevice) device = NULL;
+
+	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
+	g_return_val_if_fail(device_id != NULL, NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	/* find the device */
+	device = fu_device_list_get_by_id(self->device_list, device_id, error);
+	if (device == NULL)
+		return NULL;
+	return fu_engine_get_upgrades_for_device(self, request, device, NULL, error);
+}
+
+/**
+ * fu_engine_get_upgrades_all:
+ * @self: a #FuEngine
+ * @request: a #FuEngineRequest
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets the upgrades available for all devices in one pass. The component lookups
+ * are shared between devices, so devices with overlapping GUIDs only query the
+ * silo once.
+ *
+ * Returns: (transfer container) (element-type FwupdDevice): devices with releases
+ **/
+GPtrArray *
+fu_engine_get_upgrades_all(FuEngine *self, FuEngineRequest *request, GError **error)
+{
+	g_autoptr(GHashTable) components_cache = fu_engine_components_cache_new();
+	g_autoptr(GPtrArray) devices = NULL;
+	g_autoptr(GPtrArray) results =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+
+	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
+	g_return_val_if_fail(FU_IS_ENGINE_REQUEST(request), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	/* no components in silo */
+	if (self->query_component_by_guid == NULL) {
+		g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "no components in silo");
+		return NULL;
+	}
+
+	devices = fu_device_list_get_active(self->device_list);
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		g_autoptr(FwupdDevice) result = NULL;
+		g_autoptr(GError) error_local = NULL;
+		g_autoptr(GPtrArray) releases = NULL;
+
+		/* not going to have results */
+		if (!fu_device_has_flag(device, FWUPD_DEVICE_FLAG_SUPPORTED))
+			continue;
+		releases = fu_engine_get_upgrades_for_device(self,
+							     request,
+							     device,
+							     components_cache,
+							     &error_local);
+		if (releases == NULL) {
+			g_debug("no upgrades for %s: %s",
+				fu_device_get_id(device),
+				error_local->message);
+			continue;
+		}
+
+		/* copy so that the releases are not added to the real device */
+		result = fwupd_device_new();
+		fwupd_device_incorporate(result, FWUPD_DEVICE(device));
+		for (guint j = 0; j < releases->len; j++) {
+			FwupdRelease *rel = g_ptr_array_index(releases, j);
+			fwupd_device_add_release(result, rel);
+		}
+		g_ptr_array_add(results, g_steal_pointer(&result));
+	}
+	g_debug("looked up components for %u GUIDs", g_hash_table_size(components_cache));
+
+	/* nothing */
+	if (results->len == 0) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOTHING_TO_DO,
+				    "No upgrades for any device");
+		return NULL;
+	}
+	return g_steal_pointer(&results);
+}
+
 /**
  * fu_engine_clear_results:
  * @self: a #FuEngine
@@ -8216,6 +8422,11 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GE
 					    fu_engine_config_get_esp_location(self->config));
 	}
 
+	/* reuse parsed firmware for identical payloads */
+	fu_context_set_firmware_cache_max_age(
+	    self->ctx,
+	    fu_engine_config_get_firmware_cache_max_age(self->config));
+
 	/* read remotes */
 	if (flags & FU_ENGINE_LOAD_FLAG_REMOTES) {
 		FuRemoteListLoadFlags remote_list_flags = FU_REMOTE_LIST_LOAD_FLAG_FIX_METADATA_URI;
@@ -8882,10 +9093,16 @@ fu_engine_init(FuEngine *self)
 	self->backends = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
 	self->local_monitors = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
 	self->acquiesce_loop = g_main_loop_new(NULL, FALSE);
-	self->emulation_phases = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+	self->emulation_phases = fu_engine_emulation_phases_new();
 	self->emulation_backend_ids = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 	self->device_changed_allowlist =
 	    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	self->requirement_cache =
+	    g_hash_table_new_full(g_str_hash,
+				  g_str_equal,
+				  g_free,
+				  (GDestroyNotify)fu_engine_requirement_cache_error_free);
+	g_mutex_init(&self->requirement_cache_mutex);
 #ifdef HAVE_PASSIM
 	self->passim_client = passim_client_new();
 #endif
@@ -8953,6 +9170,8 @@ fu_engine_finalize(GObject *obj)
 	g_hash_table_unref(self->emulation_phases);
 	g_hash_table_unref(self->emulation_backend_ids);
 	g_hash_table_unref(self->device_changed_allowlist);
+	g_hash_table_unref(self->requirement_cache);
+	g_mutex_clear(&self->requirement_cache_mutex);
 	g_object_unref(self->plugin_list);
 
 	G_OBJECT_CLASS(fu_engine_parent_class)->finalize(obj);
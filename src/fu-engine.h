@@ -116,6 +116,9 @@ fu_engine_get_upgrades(FuEngine *self,
 		       FuEngineRequest *request,
 		       const gchar *device_id,
 		       GError **error) G_GNUC_NON_NULL(1, 2, 3);
+GPtrArray *
+fu_engine_get_upgrades_all(FuEngine *self, FuEngineRequest *request, GError **error)
+    G_GNUC_NON_NULL(1, 2);
 FwupdDevice *
 fu_engine_get_results(FuEngine *self, const gchar *device_id, GError **error) G_GNUC_NON_NULL(1, 2);
 FuSecurityAttrs *
@@ -229,6 +232,12 @@ gboolean
 fu_engine_reset_config(FuEngine *self, const gchar *section, GError **error) G_GNUC_NON_NULL(1, 2);
 FuContext *
 fu_engine_get_context(FuEngine *self) G_GNUC_NON_NULL(1);
+gboolean
+fu_engine_requirement_cache_lookup(FuEngine *self, const gchar *key, GError **error_cached)
+    G_GNUC_NON_NULL(1, 2);
+void
+fu_engine_requirement_cache_add(FuEngine *self, const gchar *key, const GError *error)
+    G_GNUC_NON_NULL(1, 2);
 GPtrArray *
 fu_engine_get_releases_for_device(FuEngine *self,
 				  FuEngineRequest *request,
@@ -273,7 +282,8 @@ fu_engine_modify_bios_settings(FuEngine *self,
 gboolean
 fu_engine_emulation_load(FuEngine *self, GBytes *data, GError **error) G_GNUC_NON_NULL(1, 2);
 GBytes *
-fu_engine_emulation_save(FuEngine *self, GError **error) G_GNUC_NON_NULL(1);
+fu_engine_emulation_save(FuEngine *self, FuEngineEmulationFormat format, GError **error)
+    G_GNUC_NON_NULL(1);
 gboolean
 fu_engine_fix_host_security_attr(FuEngine *self, const gchar *appstream_id, GError **error)
     G_GNUC_NON_NULL(1, 2);
@@ -46,3 +46,39 @@ enum FuClientFlag {
     None = 0,
     Active = 1 << 0,
 }
+
+#[derive(ToString, FromString)]
+enum FuEngineEmulationFormat {
+    Unknown,
+    Binary,
+    Json,
+}
+
+#[repr(u8)]
+enum FuEngineEmulationNode {
+    Null,
+    False,
+    True,
+    Int,
+    Double,
+    String,
+    Blob,
+    Array,
+    Object,
+}
+
+#[derive(New, ParseBytes)]
+struct FuStructEngineEmulationHdr {
+    magic: [char; 8] == "FWUPDEMU",
+    version: u32le == 1,
+    nr_strings: u32le,
+    nr_blobs: u32le,
+    nr_phases: u32le,
+}
+
+#[derive(New, ParseBytes)]
+struct FuStructEngineEmulationPhase {
+    phase: u32le, // FuEngineInstallPhase
+    offset: u32le, // from the start of the file
+    size: u32le,
+}
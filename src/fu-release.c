@@ -1165,6 +1165,14 @@ fu_release_load(FuRelease *self,
 			return FALSE;
 	}
 
+	/* only decompress and check the payload if the release is actually going to be used */
+	if (self->stream != NULL) {
+		if (!fu_cabinet_verify_release(cabinet, rel, error))
+			return FALSE;
+		if (!fu_release_ensure_trust_flags(self, rel, error))
+			return FALSE;
+	}
+
 	/* success */
 	return TRUE;
 }
@@ -27,6 +27,7 @@
 #include "fu-device-list.h"
 #include "fu-device-private.h"
 #include "fu-engine-config.h"
+#include "fu-engine-emulation.h"
 #include "fu-engine-helper.h"
 #include "fu-engine-requirements.h"
 #include "fu-engine.h"
@@ -314,6 +315,55 @@ fu_engine_requirements_missing_func(gconstpointer user_data)
 	g_assert_false(ret);
 }
 
+static void
+fu_engine_requirements_cache_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	gboolean ret;
+	g_autoptr(XbNode) component = NULL;
+	g_autoptr(XbSilo) silo = NULL;
+	g_autoptr(FuEngine) engine = fu_engine_new(self->ctx);
+	g_autoptr(FuEngineRequest) request = fu_engine_request_new();
+	g_autoptr(FuRelease) release = fu_release_new();
+	g_autoptr(GError) error = NULL;
+	const gchar *xml = "<component>"
+			   "  <requires>"
+			   "    <id compare=\"ge\" version=\"1.2.4\">org.test.cache</id>"
+			   "  </requires>"
+			   "  <releases>"
+			   "    <release version=\"1.2.3\"/>"
+			   "  </releases>"
+			   "</component>";
+
+	/* set up a version that is too old */
+	fu_engine_add_runtime_version(engine, "org.test.cache", "1.2.3");
+
+	silo = xb_silo_new_from_xml(xml, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(silo);
+	component = xb_silo_query_first(silo, "component", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(component);
+	fu_release_set_request(release, request);
+	ret = fu_release_load(release, NULL, component, NULL, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* check this fails, and the cached result fails in the same way */
+	for (guint i = 0; i < 2; i++) {
+		ret = fu_engine_requirements_check(engine, release, FWUPD_INSTALL_FLAG_NONE, &error);
+		g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE);
+		g_assert_false(ret);
+		g_clear_error(&error);
+	}
+
+	/* changing the host state invalidates the cached result */
+	fu_engine_add_runtime_version(engine, "org.test.cache", "1.2.5");
+	ret = fu_engine_requirements_check(engine, release, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+}
+
 static void
 fu_engine_requirements_soft_func(gconstpointer user_data)
 {
@@ -1964,6 +2014,7 @@ static void
 fu_engine_downgrade_func(gconstpointer user_data)
 {
 	FuTest *self = (FuTest *)user_data;
+	FwupdDevice *dev_up;
 	FwupdRelease *rel;
 	gboolean ret;
 	g_autoptr(FuDevice) device = fu_device_new(self->ctx);
@@ -1973,6 +2024,7 @@ fu_engine_downgrade_func(gconstpointer user_data)
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GPtrArray) devices = NULL;
 	g_autoptr(GPtrArray) devices_pre = NULL;
+	g_autoptr(GPtrArray) devices_up = NULL;
 	g_autoptr(GPtrArray) releases_dg = NULL;
 	g_autoptr(GPtrArray) releases = NULL;
 	g_autoptr(GPtrArray) releases_up = NULL;
@@ -2137,6 +2189,18 @@ fu_engine_downgrade_func(gconstpointer user_data)
 	rel = FWUPD_RELEASE(g_ptr_array_index(releases_up, 1));
 	g_assert_cmpstr(fwupd_release_get_version(rel), ==, "1.2.4");
 
+	/* upgrades for all devices */
+	devices_up = fu_engine_get_upgrades_all(engine, request, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(devices_up);
+	g_assert_cmpint(devices_up->len, ==, 1);
+	dev_up = g_ptr_array_index(devices_up, 0);
+	g_assert_cmpstr(fwupd_device_get_id(dev_up), ==, fu_device_get_id(device));
+	g_assert_cmpint(fwupd_device_get_releases(dev_up)->len, ==, 2);
+	rel = fwupd_device_get_release_default(dev_up);
+	g_assert_cmpstr(fwupd_release_get_version(rel), ==, "1.2.5");
+	g_assert_cmpint(fwupd_device_get_releases(FWUPD_DEVICE(device))->len, ==, 0);
+
 	/* downgrades */
 	releases_dg = fu_engine_get_downgrades(engine, request, fu_device_get_id(device), &error);
 	g_assert_no_error(error);
@@ -4493,6 +4557,28 @@ _build_cab(gboolean compressed, ...)
 	return g_steal_pointer(&cabinet_blob);
 }
 
+static gboolean
+_verify_cab_release(FuCabinet *cabinet, GError **error)
+{
+	g_autoptr(XbNode) component = NULL;
+	g_autoptr(XbNode) rel = NULL;
+	g_autoptr(XbQuery) query = NULL;
+
+	component = fu_cabinet_get_component(cabinet, "com.acme.example.firmware", error);
+	if (component == NULL)
+		return FALSE;
+	query = xb_query_new_full(xb_node_get_silo(component),
+				  "releases/release",
+				  XB_QUERY_FLAG_FORCE_NODE_CACHE,
+				  error);
+	if (query == NULL)
+		return FALSE;
+	rel = xb_node_query_first_full(component, query, error);
+	if (rel == NULL)
+		return FALSE;
+	return fu_cabinet_verify_release(cabinet, rel, error);
+}
+
 static void
 _plugin_composite_device_added_cb(FuPlugin *plugin, FuDevice *device, gpointer user_data)
 {
@@ -5314,6 +5400,11 @@ fu_common_store_cab_func(void)
 	g_assert_cmpstr(xb_node_get_text(csum), ==, "7c211433f02071597741e6ff5a8ea34789abbf43");
 	blob_tmp = xb_node_get_data(rel, "fwupd::FirmwareBasename");
 	g_assert_nonnull(blob_tmp);
+	g_assert_null(xb_node_get_data(rel, "fwupd::PayloadVerified"));
+	ret = fu_cabinet_verify_release(cabinet, rel, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_nonnull(xb_node_get_data(rel, "fwupd::PayloadVerified"));
 	req = xb_node_query_first(component, "requires/id", &error);
 	g_assert_no_error(error);
 	g_assert_nonnull(req);
@@ -5360,6 +5451,9 @@ fu_common_store_cab_artifact_func(void)
 	ret = fu_firmware_parse(FU_FIRMWARE(cabinet1), blob1, FWUPD_INSTALL_FLAG_NONE, &error);
 	g_assert_no_error(error);
 	g_assert_true(ret);
+	ret = _verify_cab_release(cabinet1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
 
 	/* create silo (sha1, using artifacts object; mixed case) */
 	blob2 = _build_cab(FALSE,
@@ -5387,6 +5481,9 @@ fu_common_store_cab_artifact_func(void)
 	ret = fu_firmware_parse(FU_FIRMWARE(cabinet2), blob2, FWUPD_INSTALL_FLAG_NONE, &error);
 	g_assert_no_error(error);
 	g_assert_true(ret);
+	ret = _verify_cab_release(cabinet2, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
 
 	/* create silo (sha512, using artifacts object; lower case) */
 	blob3 =
@@ -5417,6 +5514,9 @@ fu_common_store_cab_artifact_func(void)
 	ret = fu_firmware_parse(FU_FIRMWARE(cabinet3), blob3, FWUPD_INSTALL_FLAG_NONE, &error);
 	g_assert_no_error(error);
 	g_assert_true(ret);
+	ret = _verify_cab_release(cabinet3, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
 
 	/* create silo (legacy release object) */
 	blob4 = _build_cab(FALSE,
@@ -5441,6 +5541,9 @@ fu_common_store_cab_artifact_func(void)
 	ret = fu_firmware_parse(FU_FIRMWARE(cabinet4), blob4, FWUPD_INSTALL_FLAG_NONE, &error);
 	g_assert_no_error(error);
 	g_assert_true(ret);
+	ret = _verify_cab_release(cabinet4, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
 }
 
 static void
@@ -5520,6 +5623,9 @@ fu_common_store_cab_sha256_func(void)
 	ret = fu_firmware_parse(FU_FIRMWARE(cabinet), blob, FWUPD_INSTALL_FLAG_NONE, &error);
 	g_assert_no_error(error);
 	g_assert_true(ret);
+	ret = _verify_cab_release(cabinet, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
 }
 
 static void
@@ -5684,6 +5790,11 @@ fu_common_store_cab_error_wrong_checksum_func(void)
 			  "world",
 			  NULL);
 	ret = fu_firmware_parse(FU_FIRMWARE(cabinet), blob, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* the payload is only checked when the release is used */
+	ret = _verify_cab_release(cabinet, &error);
 	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE);
 	g_assert_false(ret);
 }
@@ -6364,6 +6475,87 @@ fu_config_migrate_1_7_func(void)
 	g_assert_cmpstr(localconf_data, ==, "");
 }
 
+static void
+fu_engine_emulation_phases_func(void)
+{
+	gboolean ret;
+	JsonNode *json_node;
+	g_autofree gchar *filename = NULL;
+	g_autoptr(GBytes) blob_bin = NULL;
+	g_autoptr(GBytes) blob_bin_single = NULL;
+	g_autoptr(GBytes) blob_json = NULL;
+	g_autoptr(GBytes) blob_src = NULL;
+	g_autoptr(GBytes) blob_invalid =
+	    g_bytes_new_static("FWUPDEMU\x02\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0", 24);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GHashTable) phases = fu_engine_emulation_phases_new();
+	g_autoptr(GHashTable) phases_bin = NULL;
+	g_autoptr(GHashTable) phases_json = NULL;
+	g_autoptr(JsonParser) parser = json_parser_new();
+
+	/* load the JSON source data */
+	filename = g_test_build_filename(G_TEST_DIST, "tests", "usb-devices.json", NULL);
+	blob_src = fu_bytes_get_contents(filename, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_src);
+	ret = json_parser_load_from_data(parser,
+					 g_bytes_get_data(blob_src, NULL),
+					 g_bytes_get_size(blob_src),
+					 &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	json_node = json_parser_get_root(parser);
+
+	/* a single phase is smaller than the JSON it was created from */
+	g_hash_table_insert(phases,
+			    GINT_TO_POINTER(FU_ENGINE_INSTALL_PHASE_SETUP),
+			    json_node_ref(json_node));
+	blob_bin_single =
+	    fu_engine_emulation_phases_write(phases, FU_ENGINE_EMULATION_FORMAT_BINARY, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_bin_single);
+	g_assert_cmpint(g_bytes_get_size(blob_bin_single), <, g_bytes_get_size(blob_src));
+
+	/* use the same data for two phases, where the strings and blobs are only stored once */
+	g_hash_table_insert(phases,
+			    GINT_TO_POINTER(FU_ENGINE_INSTALL_PHASE_INSTALL),
+			    json_node_ref(json_node));
+	blob_bin =
+	    fu_engine_emulation_phases_write(phases, FU_ENGINE_EMULATION_FORMAT_BINARY, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_bin);
+	g_assert_cmpint(g_bytes_get_size(blob_bin), <, 2 * g_bytes_get_size(blob_bin_single));
+	phases_bin = fu_engine_emulation_phases_parse(blob_bin, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(phases_bin);
+	g_assert_cmpint(g_hash_table_size(phases_bin), ==, 2);
+	g_assert_true(json_node_equal(
+	    json_node,
+	    g_hash_table_lookup(phases_bin, GINT_TO_POINTER(FU_ENGINE_INSTALL_PHASE_SETUP))));
+	g_assert_true(json_node_equal(
+	    json_node,
+	    g_hash_table_lookup(phases_bin, GINT_TO_POINTER(FU_ENGINE_INSTALL_PHASE_INSTALL))));
+
+	/* JSON export */
+	blob_json =
+	    fu_engine_emulation_phases_write(phases, FU_ENGINE_EMULATION_FORMAT_JSON, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_json);
+	phases_json = fu_engine_emulation_phases_parse(blob_json, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(phases_json);
+	g_assert_cmpint(g_hash_table_size(phases_json), ==, 2);
+	g_assert_true(json_node_equal(
+	    json_node,
+	    g_hash_table_lookup(phases_json, GINT_TO_POINTER(FU_ENGINE_INSTALL_PHASE_SETUP))));
+
+	/* unsupported version */
+	g_clear_pointer(&phases_bin, g_hash_table_unref);
+	phases_bin = fu_engine_emulation_phases_parse(blob_invalid, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_DATA);
+	g_assert_null(phases_bin);
+}
+
 static void
 fu_engine_machine_hash_func(void)
 {
@@ -6517,6 +6709,7 @@ main(int argc, char **argv)
 			     self,
 			     fu_device_list_replug_user_func);
 	g_test_add_func("/fwupd/engine{machine-hash}", fu_engine_machine_hash_func);
+	g_test_add_func("/fwupd/engine{emulation-phases}", fu_engine_emulation_phases_func);
 	g_test_add_data_func("/fwupd/engine{require-hwid}", self, fu_engine_require_hwid_func);
 	g_test_add_data_func("/fwupd/engine{requires-reboot}",
 			     self,
@@ -6534,6 +6727,9 @@ main(int argc, char **argv)
 	g_test_add_data_func("/fwupd/engine{requirements-missing}",
 			     self,
 			     fu_engine_requirements_missing_func);
+	g_test_add_data_func("/fwupd/engine{requirements-cache}",
+			     self,
+			     fu_engine_requirements_cache_func);
 	g_test_add_data_func("/fwupd/engine{requirements-client-fail}",
 			     self,
 			     fu_engine_requirements_client_fail_func);
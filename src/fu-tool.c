@@ -33,6 +33,7 @@
 #include "fu-context-private.h"
 #include "fu-debug.h"
 #include "fu-device-private.h"
+#include "fu-engine-emulation.h"
 #include "fu-engine-helper.h"
 #include "fu-engine-requirements.h"
 #include "fu-engine.h"
@@ -2964,6 +2965,47 @@ fu_util_firmware_build(FuUtilPrivate *priv, gchar **values, GError **error)
 	return TRUE;
 }
 
+static gboolean
+fu_util_emulation_convert(FuUtilPrivate *priv, gchar **values, GError **error)
+{
+	FuEngineEmulationFormat format = FU_ENGINE_EMULATION_FORMAT_BINARY;
+	g_autoptr(GBytes) blob_dst = NULL;
+	g_autoptr(GBytes) blob_src = NULL;
+	g_autoptr(GHashTable) phases = NULL;
+
+	/* check args */
+	if (g_strv_length(values) < 2 || g_strv_length(values) > 3) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_ARGS,
+				    "Invalid arguments, expected FILENAME-SRC FILENAME-DST [FORMAT]");
+		return FALSE;
+	}
+	if (g_strv_length(values) > 2) {
+		format = fu_engine_emulation_format_from_string(values[2]);
+		if (format == FU_ENGINE_EMULATION_FORMAT_UNKNOWN) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_ARGS,
+				    "Invalid format %s, expected binary or json",
+				    values[2]);
+			return FALSE;
+		}
+	}
+
+	/* the source format is detected automatically */
+	blob_src = fu_bytes_get_contents(values[0], error);
+	if (blob_src == NULL)
+		return FALSE;
+	phases = fu_engine_emulation_phases_parse(blob_src, error);
+	if (phases == NULL)
+		return FALSE;
+	blob_dst = fu_engine_emulation_phases_write(phases, format, error);
+	if (blob_dst == NULL)
+		return FALSE;
+	return fu_bytes_set_contents(values[1], blob_dst, error);
+}
+
 static gboolean
 fu_util_firmware_convert(FuUtilPrivate *priv, gchar **values, GError **error)
 {
@@ -4074,6 +4116,28 @@ fu_util_print_error(FuUtilPrivate *priv, const GError *error)
 	fu_console_print_full(priv->console, FU_CONSOLE_PRINT_FLAG_STDERR, "%s\n", error->message);
 }
 
+static void
+fu_util_print_sleep_totals(FuUtilPrivate *priv)
+{
+	g_autoptr(GPtrArray) devices = NULL;
+
+	if (!fu_engine_get_loaded(priv->engine))
+		return;
+	devices = fu_engine_get_devices(priv->engine, NULL);
+	if (devices == NULL)
+		return;
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		guint64 sleep_total = fu_device_get_sleep_total(device);
+		if (sleep_total == 0)
+			continue;
+		fu_console_print(priv->console,
+				 "%s slept for %" G_GUINT64_FORMAT "ms",
+				 fu_device_get_name(device),
+				 sleep_total);
+	}
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -4512,6 +4576,13 @@ main(int argc, char *argv[])
 	    /* TRANSLATORS: command description */
 	    _("Convert a firmware file"),
 	    fu_util_firmware_convert);
+	fu_util_cmd_array_add(cmd_array,
+			      "emulation-convert",
+			      /* TRANSLATORS: command argument: uppercase, spaces->dashes */
+			      _("FILENAME-SRC FILENAME-DST [FORMAT]"),
+			      /* TRANSLATORS: command description */
+			      _("Convert device emulation data"),
+			      fu_util_emulation_convert);
 	fu_util_cmd_array_add(cmd_array,
 			      "firmware-build",
 			      /* TRANSLATORS: command argument: uppercase, spaces->dashes */
@@ -4880,6 +4951,7 @@ main(int argc, char *argv[])
 		g_autofree gchar *str = fu_progress_traceback(priv->progress);
 		if (str != NULL)
 			fu_console_print_literal(priv->console, str);
+		fu_util_print_sleep_totals(priv);
 	}
 
 	/* success */
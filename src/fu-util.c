@@ -69,6 +69,7 @@ struct FuUtilPrivate {
 	gboolean show_all;
 	gboolean disable_ssl_strict;
 	gboolean as_json;
+	gboolean timing;
 	/* only valid in update and downgrade */
 	FuUtilOperation current_operation;
 	FwupdDevice *current_device;
@@ -714,8 +715,50 @@ typedef struct {
 	JsonBuilder *builder;
 	const gchar *name;
 	gboolean use_emulation;
+	gboolean timing;
+	GDBusConnection *connection; /* nullable */
+	guint connection_filter_id;
+	gint dbus_messages; /* atomic */
 } FuUtilDeviceTestHelper;
 
+static GDBusMessage *
+fu_util_device_test_dbus_filter_cb(GDBusConnection *connection,
+				   GDBusMessage *message,
+				   gboolean incoming,
+				   gpointer user_data)
+{
+	FuUtilDeviceTestHelper *helper = (FuUtilDeviceTestHelper *)user_data;
+	g_atomic_int_inc(&helper->dbus_messages);
+	return message;
+}
+
+static void
+fu_util_device_test_reset_timing(FuUtilDeviceTestHelper *helper, GTimer *timer)
+{
+	g_atomic_int_set(&helper->dbus_messages, 0);
+	g_timer_reset(timer);
+}
+
+/* record how long each part of the step took, so that regressions can be found */
+static void
+fu_util_device_test_add_timing(FuUtilDeviceTestHelper *helper, const gchar *phase, GTimer *timer)
+{
+	g_autofree gchar *key_ms = NULL;
+
+	if (!helper->timing)
+		return;
+	key_ms = g_strdup_printf("%s-ms", phase);
+	json_builder_set_member_name(helper->builder, key_ms);
+	json_builder_add_double_value(helper->builder, g_timer_elapsed(timer, NULL) * 1000.f);
+	if (helper->connection != NULL) {
+		g_autofree gchar *key_dbus = g_strdup_printf("%s-dbus-messages", phase);
+		json_builder_set_member_name(helper->builder, key_dbus);
+		json_builder_add_int_value(helper->builder,
+					   g_atomic_int_get(&helper->dbus_messages));
+	}
+	fu_util_device_test_reset_timing(helper, timer);
+}
+
 static gboolean
 fu_util_device_test_component(FuUtilPrivate *priv,
 			      FuUtilDeviceTestHelper *helper,
@@ -875,6 +918,43 @@ fu_util_emulation_load_with_fallback(FuUtilPrivate *priv, GBytes *emulation_data
 	return fwupd_client_emulation_load(priv->client, emulation_data, priv->cancellable, error);
 }
 
+/* time how long the daemon takes to enumerate the devices and then check each for updates */
+static gboolean
+fu_util_device_test_get_updates(FuUtilPrivate *priv,
+				FuUtilDeviceTestHelper *helper,
+				GTimer *timer,
+				GError **error)
+{
+	g_autoptr(GPtrArray) devices = NULL;
+
+	devices = fwupd_client_get_devices(priv->client, priv->cancellable, error);
+	if (devices == NULL)
+		return FALSE;
+	fu_util_device_test_add_timing(helper, "get-devices", timer);
+
+	for (guint i = 0; i < devices->len; i++) {
+		FwupdDevice *device = g_ptr_array_index(devices, i);
+		g_autoptr(GPtrArray) rels = NULL;
+		g_autoptr(GError) error_local = NULL;
+
+		if (!fwupd_device_has_flag(device, FWUPD_DEVICE_FLAG_UPDATABLE))
+			continue;
+		if (helper->use_emulation &&
+		    !fwupd_device_has_flag(device, FWUPD_DEVICE_FLAG_EMULATED))
+			continue;
+
+		/* no updates available is not an error here */
+		rels = fwupd_client_get_upgrades(priv->client,
+						 fwupd_device_get_id(device),
+						 priv->cancellable,
+						 &error_local);
+		if (rels == NULL)
+			g_debug("ignoring: %s", error_local->message);
+	}
+	fu_util_device_test_add_timing(helper, "get-updates", timer);
+	return TRUE;
+}
+
 static gboolean
 fu_util_device_test_step(FuUtilPrivate *priv,
 			 FuUtilDeviceTestHelper *helper,
@@ -887,6 +967,7 @@ fu_util_device_test_step(FuUtilPrivate *priv,
 	g_autofree gchar *filename = NULL;
 	g_autoptr(GBytes) fw = NULL;
 	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GTimer) timer = g_timer_new();
 
 	/* send this data to the daemon */
 	if (helper->use_emulation) {
@@ -906,8 +987,17 @@ fu_util_device_test_step(FuUtilPrivate *priv,
 		emulation_data = fu_bytes_get_contents(emulation_filename, error);
 		if (emulation_data == NULL)
 			return FALSE;
+		fu_util_device_test_reset_timing(helper, timer);
 		if (!fu_util_emulation_load_with_fallback(priv, emulation_data, error))
 			return FALSE;
+		fu_util_device_test_add_timing(helper, "emulation-load", timer);
+	}
+
+	/* enumerate devices and check for updates, like a session client would */
+	if (helper->timing) {
+		fu_util_device_test_reset_timing(helper, timer);
+		if (!fu_util_device_test_get_updates(priv, helper, timer, error))
+			return FALSE;
 	}
 
 	/* download file if required */
@@ -934,12 +1024,14 @@ fu_util_device_test_step(FuUtilPrivate *priv,
 	/* install file */
 	priv->flags |= FWUPD_INSTALL_FLAG_ALLOW_OLDER;
 	priv->flags |= FWUPD_INSTALL_FLAG_ALLOW_REINSTALL;
+	fu_util_device_test_reset_timing(helper, timer);
 	if (!fwupd_client_install(priv->client,
 				  FWUPD_DEVICE_ID_ANY,
 				  filename,
 				  priv->flags,
 				  priv->cancellable,
 				  &error_local)) {
+		fu_util_device_test_add_timing(helper, "install", timer);
 		if (g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND)) {
 			json_builder_set_member_name(helper->builder, "info");
 			json_builder_add_string_value(helper->builder, error_local->message);
@@ -956,6 +1048,7 @@ fu_util_device_test_step(FuUtilPrivate *priv,
 		helper->nr_failed++;
 		return TRUE;
 	}
+	fu_util_device_test_add_timing(helper, "install", timer);
 
 	/* process each step */
 	if (!json_object_has_member(json_obj, "components")) {
@@ -972,6 +1065,7 @@ fu_util_device_test_step(FuUtilPrivate *priv,
 		if (!fu_util_device_test_component(priv, helper, json_obj_tmp, fw, error))
 			return FALSE;
 	}
+	fu_util_device_test_add_timing(helper, "verify", timer);
 
 	/* success */
 	json_builder_set_member_name(helper->builder, "success");
@@ -1198,12 +1292,28 @@ fu_util_quit(FuUtilPrivate *priv, gchar **values, GError **error)
 	return fwupd_client_quit(priv->client, priv->cancellable, error);
 }
 
+static gboolean
+fu_util_device_test_filenames(FuUtilPrivate *priv,
+			      FuUtilDeviceTestHelper *helper,
+			      gchar **values,
+			      GError **error)
+{
+	for (guint i = 0; values[i] != NULL; i++) {
+		json_builder_begin_object(helper->builder);
+		if (!fu_util_device_test_filename(priv, helper, values[i], error))
+			return FALSE;
+		json_builder_end_object(helper->builder);
+	}
+	return TRUE;
+}
+
 static gboolean
 fu_util_device_test_full(FuUtilPrivate *priv,
 			 gchar **values,
 			 FuUtilDeviceTestHelper *helper,
 			 GError **error)
 {
+	gboolean ret;
 	g_autoptr(JsonBuilder) builder = json_builder_new();
 	helper->builder = builder;
 
@@ -1222,15 +1332,30 @@ fu_util_device_test_full(FuUtilPrivate *priv,
 	/* prepare to save the data as JSON */
 	json_builder_begin_object(builder);
 
+#ifndef FWUPD_DBUS_SOCKET_ADDRESS
+	/* count the messages to and from the daemon when using the shared system bus */
+	if (helper->timing && g_getenv("FWUPD_DBUS_SOCKET") == NULL) {
+		helper->connection = g_bus_get_sync(G_BUS_TYPE_SYSTEM, NULL, NULL);
+		if (helper->connection != NULL) {
+			helper->connection_filter_id =
+			    g_dbus_connection_add_filter(helper->connection,
+							 fu_util_device_test_dbus_filter_cb,
+							 helper,
+							 NULL);
+		}
+	}
+#endif
+
 	/* process all the files */
 	json_builder_set_member_name(builder, "results");
 	json_builder_begin_array(builder);
-	for (guint i = 0; values[i] != NULL; i++) {
-		json_builder_begin_object(builder);
-		if (!fu_util_device_test_filename(priv, helper, values[i], error))
-			return FALSE;
-		json_builder_end_object(builder);
+	ret = fu_util_device_test_filenames(priv, helper, values, error);
+	if (helper->connection != NULL) {
+		g_dbus_connection_remove_filter(helper->connection, helper->connection_filter_id);
+		g_clear_object(&helper->connection);
 	}
+	if (!ret)
+		return FALSE;
 	json_builder_end_array(builder);
 
 	/* dump to screen as JSON format */
@@ -1276,14 +1401,14 @@ fu_util_device_test_full(FuUtilPrivate *priv,
 static gboolean
 fu_util_device_emulate(FuUtilPrivate *priv, gchar **values, GError **error)
 {
-	FuUtilDeviceTestHelper helper = {.use_emulation = TRUE};
+	FuUtilDeviceTestHelper helper = {.use_emulation = TRUE, .timing = priv->timing};
 	return fu_util_device_test_full(priv, values, &helper, error);
 }
 
 static gboolean
 fu_util_device_test(FuUtilPrivate *priv, gchar **values, GError **error)
 {
-	FuUtilDeviceTestHelper helper = {.use_emulation = FALSE};
+	FuUtilDeviceTestHelper helper = {.use_emulation = FALSE, .timing = priv->timing};
 	return fu_util_device_test_full(priv, values, &helper, error);
 }
 
@@ -2393,8 +2518,61 @@ fu_util_perhaps_refresh_remotes(FuUtilPrivate *priv, GError **error)
 	return fu_util_download_metadata(priv, error);
 }
 
+/* returns a hash of device-id:FwupdDevice with the releases set, or %NULL if unsupported */
+static GHashTable *
+fu_util_get_all_upgrades(FuUtilPrivate *priv)
+{
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GHashTable) upgrades =
+	    g_hash_table_new_full(g_str_hash, g_str_equal, NULL, (GDestroyNotify)g_object_unref);
+	g_autoptr(GPtrArray) devices = NULL;
+
+	devices = fwupd_client_get_all_upgrades(priv->client, priv->cancellable, &error_local);
+	if (devices == NULL) {
+		if (g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_NOTHING_TO_DO))
+			return g_steal_pointer(&upgrades);
+		g_debug("falling back to per-device upgrades: %s", error_local->message);
+		return NULL;
+	}
+	for (guint i = 0; i < devices->len; i++) {
+		FwupdDevice *dev = g_ptr_array_index(devices, i);
+		g_hash_table_insert(upgrades, (gpointer)fwupd_device_get_id(dev), g_object_ref(dev));
+	}
+	return g_steal_pointer(&upgrades);
+}
+
+static GPtrArray *
+fu_util_get_upgrades_for_device(FuUtilPrivate *priv,
+				GHashTable *upgrades,
+				FwupdDevice *dev,
+				GError **error)
+{
+	FwupdDevice *dev_tmp;
+
+	/* older daemon */
+	if (upgrades == NULL) {
+		return fwupd_client_get_upgrades(priv->client,
+						 fwupd_device_get_id(dev),
+						 priv->cancellable,
+						 error);
+	}
+	dev_tmp = g_hash_table_lookup(upgrades, fwupd_device_get_id(dev));
+	if (dev_tmp == NULL) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOTHING_TO_DO,
+			    "no upgrades for %s",
+			    fwupd_device_get_id(dev));
+		return NULL;
+	}
+	return g_ptr_array_ref(fwupd_device_get_releases(dev_tmp));
+}
+
 static gboolean
-fu_util_get_updates_as_json(FuUtilPrivate *priv, GPtrArray *devices, GError **error)
+fu_util_get_updates_as_json(FuUtilPrivate *priv,
+			    GPtrArray *devices,
+			    GHashTable *upgrades,
+			    GError **error)
 {
 	g_autoptr(JsonBuilder) builder = json_builder_new();
 	json_builder_begin_object(builder);
@@ -2410,10 +2588,7 @@ fu_util_get_updates_as_json(FuUtilPrivate *priv, GPtrArray *devices, GError **er
 			continue;
 
 		/* get the releases for this device and filter for validity */
-		rels = fwupd_client_get_upgrades(priv->client,
-						 fwupd_device_get_id(dev),
-						 priv->cancellable,
-						 &error_local);
+		rels = fu_util_get_upgrades_for_device(priv, upgrades, dev, &error_local);
 		if (rels == NULL) {
 			g_debug("no upgrades: %s", error_local->message);
 			continue;
@@ -2439,6 +2614,7 @@ static gboolean
 fu_util_get_updates(FuUtilPrivate *priv, gchar **values, GError **error)
 {
 	g_autoptr(GPtrArray) devices = NULL;
+	g_autoptr(GHashTable) upgrades = NULL;
 	gboolean supported = FALSE;
 	g_autoptr(FuUtilNode) root = g_node_new(NULL);
 	g_autoptr(GPtrArray) devices_no_support = g_ptr_array_new();
@@ -2468,9 +2644,13 @@ fu_util_get_updates(FuUtilPrivate *priv, gchar **values, GError **error)
 	}
 	g_ptr_array_sort(devices, fu_util_sort_devices_by_flags_cb);
 
+	/* get all the upgrades in one call rather than a D-Bus round-trip for each device */
+	if (devices->len > 1)
+		upgrades = fu_util_get_all_upgrades(priv);
+
 	/* not for human consumption */
 	if (priv->as_json)
-		return fu_util_get_updates_as_json(priv, devices, error);
+		return fu_util_get_updates_as_json(priv, devices, upgrades, error);
 
 	for (guint i = 0; i < devices->len; i++) {
 		FwupdDevice *dev = g_ptr_array_index(devices, i);
@@ -2493,10 +2673,7 @@ fu_util_get_updates(FuUtilPrivate *priv, gchar **values, GError **error)
 		supported = TRUE;
 
 		/* get the releases for this device and filter for validity */
-		rels = fwupd_client_get_upgrades(priv->client,
-						 fwupd_device_get_id(dev),
-						 priv->cancellable,
-						 &error_local);
+		rels = fu_util_get_upgrades_for_device(priv, upgrades, dev, &error_local);
 		if (rels == NULL) {
 			g_ptr_array_add(devices_no_upgrades, dev);
 			/* discard the actual reason from user, but leave for debugging */
@@ -5023,6 +5200,14 @@ main(int argc, char *argv[])
 	     /* TRANSLATORS: command line option */
 	     N_("Output in JSON format"),
 	     NULL},
+	    {"timing",
+	     '\0',
+	     0,
+	     G_OPTION_ARG_NONE,
+	     &priv->timing,
+	     /* TRANSLATORS: command line option */
+	     N_("Record how long each part of the device tests takes"),
+	     NULL},
 	    {"no-security-fix",
 	     '\0',
 	     0,